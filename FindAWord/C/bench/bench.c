@@ -0,0 +1,302 @@
+#include <bench.h>
+#include <random.h>
+
+// Bytes and calls counted by the wrappers of the allocator while bench_counting is set
+size_t bench_allocated_bytes = 0;
+size_t bench_allocations = 0;
+int bench_counting = 0;
+// Number of results written, to separate the JSON objects
+static size_t written_results = 0;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *pointer, size_t size);
+
+/**
+ * @brief Counting wrapper of malloc, linked with -Wl,--wrap=malloc.
+ * @param size The size to allocate.
+ * @return The allocated memory.
+*/
+void *__wrap_malloc(size_t size){
+    if (bench_counting){
+        bench_allocated_bytes += size;
+        bench_allocations++;
+    }
+    return __real_malloc(size);
+}
+
+/**
+ * @brief Counting wrapper of calloc, linked with -Wl,--wrap=calloc.
+ * @param count The number of elements.
+ * @param size The size of an element.
+ * @return The allocated memory.
+*/
+void *__wrap_calloc(size_t count, size_t size){
+    if (bench_counting){
+        bench_allocated_bytes += count * size;
+        bench_allocations++;
+    }
+    return __real_calloc(count, size);
+}
+
+/**
+ * @brief Counting wrapper of realloc, linked with -Wl,--wrap=realloc. The whole new size is counted.
+ * @param pointer The memory to resize.
+ * @param size The new size.
+ * @return The resized memory.
+*/
+void *__wrap_realloc(void *pointer, size_t size){
+    if (bench_counting){
+        bench_allocated_bytes += size;
+        bench_allocations++;
+    }
+    return __real_realloc(pointer, size);
+}
+
+/**
+ * @brief Returns the default options : CSV on the standard output, BENCH_REPETITIONS repetitions of BENCH_REPETITION_MS.
+ * @return The options.
+*/
+BenchOptions default_bench_options(){
+    BenchOptions options;
+    options.repetitions = BENCH_REPETITIONS;
+    options.repetition_time = BENCH_REPETITION_MS * 1e-3;
+    options.seed = 42;
+    options.format = BENCH_CSV;
+    options.output = stdout;
+    options.filter = NULL;
+    return options;
+}
+
+/**
+ * @brief Applies a command line option shared by the benchmarks :
+ * -f csv|json, -o file, -r repetitions, -t milliseconds per repetition, -s seed, -c cpu, -k filter.
+ * @param options The options.
+ * @param option The option letter.
+ * @param value The value of the option.
+ * @return 0 on success, -1 if the option or its value is invalid.
+*/
+int parse_bench_option(BenchOptions *options, int option, const char *value){
+    switch (option){
+        case 'f':
+            if (strcmp(value, "csv") == 0)
+                options->format = BENCH_CSV;
+            else if (strcmp(value, "json") == 0)
+                options->format = BENCH_JSON;
+            else
+                return -1;
+            return 0;
+        case 'o':
+            options->output = fopen(value, "w");
+            return options->output != NULL ? 0 : -1;
+        case 'r':
+            options->repetitions = atoi(value);
+            return options->repetitions > 0 ? 0 : -1;
+        case 't':
+            options->repetition_time = atof(value) * 1e-3;
+            return options->repetition_time > 0 ? 0 : -1;
+        case 's':
+            options->seed = strtoull(value, NULL, 10);
+            return 0;
+        case 'c':
+            return pin_to_cpu(atoi(value));
+        case 'k':
+            options->filter = value;
+            return 0;
+    }
+    return -1;
+}
+
+/**
+ * @brief Pins the calling thread to a CPU, so the measures do not migrate between cores.
+ * @param cpu The CPU.
+ * @return 0 on success, -1 on failure.
+*/
+int pin_to_cpu(int cpu){
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set);
+}
+
+/**
+ * @brief Checks whether a case is selected by the filter of the options.
+ * @param options The options.
+ * @param group The group of the case.
+ * @param name The name of the case.
+ * @return 1 if the case is to be run, 0 otherwise.
+*/
+int bench_selected(const BenchOptions *options, const char *group, const char *name){
+    return options->filter == NULL || strstr(group, options->filter) != NULL || strstr(name, options->filter) != NULL;
+}
+
+/**
+ * @brief Comparison function of doubles for qsort.
+ * @param a The first double.
+ * @param b The second double.
+ * @return The order of a and b.
+*/
+int double_cmp(const void *a, const void *b){
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Measures an operation.
+ * The operation is first run for one repetition time to warm the caches and to calibrate the number of
+ * operations per repetition, then the repetitions are timed and their allocations counted. The random
+ * generator is seeded before the warmup, so a case draws the same sequence on every run.
+ * @param options The options.
+ * @param operation The operation.
+ * @param datas The inputs of the operation.
+ * @param result The result, whose group, name, length and population are set by the caller.
+*/
+void measure_operation(const BenchOptions *options, BenchOperation operation, void *datas, BenchResult *result){
+    seed_random(options->seed);
+    size_t operations = 0;
+    double start = bench_now(), elapsed = 0;
+    while (elapsed < options->repetition_time){
+        operation(datas);
+        operations++;
+        elapsed = bench_now() - start;
+    }
+    result->operations = operations;
+
+    double *times = malloc(options->repetitions * sizeof(double));
+    bench_allocated_bytes = 0;
+    bench_allocations = 0;
+    for (int r = 0; r < options->repetitions; r++){
+        bench_counting = 1;
+        start = bench_now();
+        for (size_t i = 0; i < operations; i++)
+            operation(datas);
+        elapsed = bench_now() - start;
+        bench_counting = 0;
+        times[r] = elapsed * 1e9 / operations;
+    }
+    qsort(times, options->repetitions, sizeof(double), double_cmp);
+    result->ns_per_op = times[options->repetitions / 2];
+    result->ns_min = times[0];
+    result->ns_max = times[options->repetitions - 1];
+    double total = (double)operations * options->repetitions;
+    result->bytes_per_op = bench_allocated_bytes / total;
+    result->allocs_per_op = bench_allocations / total;
+    free(times);
+}
+
+/**
+ * @brief Computes a percentile by linear interpolation between the closest ranks.
+ * @param sorted The samples, sorted in increasing order.
+ * @param size The number of samples.
+ * @param q The percentile, between 0 and 1.
+ * @return The percentile, or NAN without samples.
+*/
+double percentile(const double *sorted, size_t size, double q){
+    if (size == 0)
+        return NAN;
+    double position = q * (size - 1);
+    size_t below = (size_t)position;
+    if (below + 1 >= size)
+        return sorted[size - 1];
+    return sorted[below] + (position - below) * (sorted[below + 1] - sorted[below]);
+}
+
+/**
+ * @brief Two-sided Mann-Whitney U test of two independent samples, with the normal approximation corrected for ties
+ * and for continuity. The test does not assume a distribution, which suits the skewed times to solution.
+ * @param a The first sample.
+ * @param a_size The size of the first sample.
+ * @param b The second sample.
+ * @param b_size The size of the second sample.
+ * @param z The z score, positive when the values of a tend to be larger than the ones of b, or NULL.
+ * @return The p-value, 1 when a sample is empty or all the values are equal.
+*/
+double mann_whitney_u(const double *a, size_t a_size, const double *b, size_t b_size, double *z){
+    size_t n = a_size + b_size;
+    if (z != NULL)
+        *z = 0;
+    if (a_size == 0 || b_size == 0)
+        return 1;
+    // The values of both samples sorted together, the value is the first member so double_cmp orders them
+    struct { double value; int from_a; } *all = malloc(n * sizeof(*all));
+    if (all == NULL)
+        return 1;
+    for (size_t i = 0; i < a_size; i++){
+        all[i].value = a[i];
+        all[i].from_a = 1;
+    }
+    for (size_t i = 0; i < b_size; i++){
+        all[a_size + i].value = b[i];
+        all[a_size + i].from_a = 0;
+    }
+    qsort(all, n, sizeof(*all), double_cmp);
+
+    // Sum of the ranks of a, tied values share the mean of their ranks
+    double rank_sum = 0, ties = 0;
+    for (size_t i = 0; i < n;){
+        size_t j = i;
+        while (j < n && all[j].value == all[i].value)
+            j++;
+        double mean_rank = (i + 1 + j) / 2.0;
+        for (size_t k = i; k < j; k++)
+            if (all[k].from_a)
+                rank_sum += mean_rank;
+        double t = j - i;
+        ties += t * t * t - t;
+        i = j;
+    }
+    free(all);
+
+    double u = rank_sum - a_size * (a_size + 1) / 2.0;
+    double mean = a_size * (double)b_size / 2;
+    double variance = a_size * (double)b_size / 12 * ((n + 1) - ties / (n * (double)(n - 1)));
+    if (variance <= 0)
+        return 1;
+    double difference = u - mean;
+    double corrected = fabs(difference) > 0.5 ? fabs(difference) - 0.5 : 0;
+    double score = corrected / sqrt(variance);
+    if (z != NULL)
+        *z = difference < 0 ? -score : score;
+    return erfc(score / sqrt(2));
+}
+
+/**
+ * @brief Writes the beginning of the output.
+ * @param options The options.
+*/
+void write_bench_header(const BenchOptions *options){
+    written_results = 0;
+    if (options->format == BENCH_CSV)
+        fprintf(options->output, "group,name,length,population,operations,ns_per_op,ns_min,ns_max,bytes_per_op,allocs_per_op\n");
+    else
+        fprintf(options->output, "[");
+}
+
+/**
+ * @brief Writes a result.
+ * @param options The options.
+ * @param result The result.
+*/
+void write_bench_result(const BenchOptions *options, const BenchResult *result){
+    if (options->format == BENCH_CSV)
+        fprintf(options->output, "%s,%s,%d,%zu,%zu,%.2f,%.2f,%.2f,%.2f,%.3f\n", result->group, result->name, result->length,\
+                result->population, result->operations, result->ns_per_op, result->ns_min, result->ns_max,\
+                result->bytes_per_op, result->allocs_per_op);
+    else
+        fprintf(options->output, "%s\n  {\"group\": \"%s\", \"name\": \"%s\", \"length\": %d, \"population\": %zu, \"operations\": %zu, "\
+                "\"ns_per_op\": %.2f, \"ns_min\": %.2f, \"ns_max\": %.2f, \"bytes_per_op\": %.2f, \"allocs_per_op\": %.3f}",\
+                written_results > 0 ? "," : "", result->group, result->name, result->length, result->population,\
+                result->operations, result->ns_per_op, result->ns_min, result->ns_max, result->bytes_per_op, result->allocs_per_op);
+    written_results++;
+    fflush(options->output);
+}
+
+/**
+ * @brief Writes the end of the output.
+ * @param options The options.
+*/
+void write_bench_footer(const BenchOptions *options){
+    if (options->format == BENCH_JSON)
+        fprintf(options->output, "\n]\n");
+    fflush(options->output);
+}
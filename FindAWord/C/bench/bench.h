@@ -0,0 +1,85 @@
+#ifndef BENCH_H
+#define BENCH_H
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <time.h>
+#include <math.h>
+
+// Default time of one repetition in milliseconds
+#define BENCH_REPETITION_MS 10
+// Default number of measured repetitions
+#define BENCH_REPETITIONS 7
+
+/**
+ * @brief Output format of the results.
+*/
+typedef enum bench_format {
+    BENCH_CSV,      /**< One line per result, with a header line. */
+    BENCH_JSON      /**< An array of objects, one per result. */
+} BenchFormat;
+
+/**
+ * @brief Options shared by the benchmarks of a run.
+*/
+typedef struct bench_options {
+    int repetitions;        /**< The number of measured repetitions. */
+    double repetition_time; /**< The time of one repetition in seconds, the number of operations per repetition is calibrated for it. */
+    uint64_t seed;          /**< Seed of the random generator, set again before the inputs and the measure of each case. */
+    BenchFormat format;     /**< The output format. */
+    FILE *output;           /**< The output file. */
+    const char *filter;     /**< Only the cases whose group or name contain it are run, NULL for all. */
+} BenchOptions;
+
+/**
+ * @brief Measure of one case.
+*/
+typedef struct bench_result {
+    const char *group;      /**< The kind of operator : fitness, selection, pairing, crossover or mutation. */
+    const char *name;       /**< The name of the function. */
+    int length;             /**< The genome length. */
+    size_t population;      /**< The population size, 0 when not relevant. */
+    size_t operations;      /**< The number of operations of one repetition. */
+    double ns_per_op;       /**< The median time of an operation over the repetitions, in nanoseconds. */
+    double ns_min;          /**< The fastest repetition, in nanoseconds per operation. */
+    double ns_max;          /**< The slowest repetition, in nanoseconds per operation. */
+    double bytes_per_op;    /**< The bytes allocated per operation. */
+    double allocs_per_op;   /**< The calls to malloc, calloc and realloc per operation. */
+} BenchResult;
+
+/**
+ * @brief An operation to measure.
+ * @param optional_datas The inputs of the case.
+*/
+typedef void (*BenchOperation)(void *);
+
+extern size_t bench_allocated_bytes;
+extern size_t bench_allocations;
+extern int bench_counting;
+
+/**
+ * @brief Returns a monotonic time.
+ * @return The time in seconds.
+*/
+static inline double bench_now(){
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+BenchOptions default_bench_options();
+int parse_bench_option(BenchOptions *options, int option, const char *value);
+int pin_to_cpu(int cpu);
+int bench_selected(const BenchOptions *options, const char *group, const char *name);
+void measure_operation(const BenchOptions *options, BenchOperation operation, void *datas, BenchResult *result);
+int double_cmp(const void *a, const void *b);
+double percentile(const double *sorted, size_t size, double q);
+double mann_whitney_u(const double *a, size_t a_size, const double *b, size_t b_size, double *z);
+void write_bench_header(const BenchOptions *options);
+void write_bench_result(const BenchOptions *options, const BenchResult *result);
+void write_bench_footer(const BenchOptions *options);
+
+#endif
@@ -0,0 +1,315 @@
+#include <unistd.h>
+
+#include <bench.h>
+#include <jobs.h>
+
+// Longest list of lengths, population sizes or schedules
+#define MAX_MATRIX 16
+// Longest schedule name
+#define SCHEDULE_SIZE 256
+// Significance level of the comparison with the baseline
+#define DEFAULT_ALPHA 0.05
+
+/**
+ * @brief One run of the matrix.
+*/
+typedef struct sample {
+    int length;                     /**< The length of the target word. */
+    size_t population;              /**< The population size. */
+    char schedule[SCHEDULE_SIZE];   /**< The operator schedule. */
+    uint64_t seed;                  /**< The seed of the run. */
+    int solved;                     /**< 1 if the word was found. */
+    int generations;                /**< The number of generations run. */
+    size_t evaluations;             /**< The number of fitness function calls. */
+    double wall_time;               /**< The time of the run in seconds. */
+} Sample;
+
+/**
+ * @brief Growable array of samples.
+*/
+typedef struct samples {
+    Sample *items;
+    size_t size;
+    size_t capacity;
+} Samples;
+
+/**
+ * @brief Appends a sample.
+ * @param samples The samples.
+ * @param sample The sample.
+ * @return 0 on success, -1 if the allocation failed.
+*/
+static int add_sample(Samples *samples, const Sample *sample){
+    if (samples->size == samples->capacity){
+        size_t capacity = samples->capacity ? 2 * samples->capacity : 64;
+        Sample *items = realloc(samples->items, capacity * sizeof(Sample));
+        if (items == NULL)
+            return -1;
+        samples->items = items;
+        samples->capacity = capacity;
+    }
+    samples->items[samples->size++] = *sample;
+    return 0;
+}
+
+/**
+ * @brief Sets the operators of a configuration from a schedule : "default" for the operators of default_job_config,
+ * "random" to draw them each generation as main.c does, the name of another engine than make_generation ("packed",
+ * "umda" or "pbil", see engine_names), or the names of the fitness, selection, pairing, crossover and mutation
+ * functions joined by '+'.
+ * @param config The configuration.
+ * @param schedule The schedule.
+ * @return 0 on success, -1 if the schedule is invalid.
+*/
+static int set_schedule(JobConfig *config, const char *schedule){
+    JobConfig defaults = default_job_config();
+    config->fitness_function = defaults.fitness_function;
+    config->selection_function = defaults.selection_function;
+    config->pairing_function = defaults.pairing_function;
+    config->crossover_function = defaults.crossover_function;
+    config->mutation_function = defaults.mutation_function;
+    config->random_operators = strcmp(schedule, "random") == 0;
+    config->engine = ENGINE_GENERATION;
+    if (config->random_operators || strcmp(schedule, "default") == 0 || set_job_engine(config, schedule) == 0)
+        return 0;
+    char names[SCHEDULE_SIZE];
+    snprintf(names, sizeof(names), "%s", schedule);
+    const char *kinds[] = {"fitness", "selection", "pairing", "crossover", "mutation"};
+    char *save = NULL;
+    char *name = strtok_r(names, "+", &save);
+    for (int i = 0; i < 5; i++, name = strtok_r(NULL, "+", &save))
+        if (name == NULL || set_job_operator(config, kinds[i], name) != 0)
+            return -1;
+    return name == NULL ? 0 : -1;
+}
+
+/**
+ * @brief Parses a comma separated list of positive integers.
+ * @param list The list.
+ * @param values The parsed values.
+ * @return The number of values, or -1 if the list is invalid.
+*/
+static int parse_list(const char *list, size_t *values){
+    int count = 0;
+    const char *p = list;
+    while (*p != '\0' && count < MAX_MATRIX){
+        char *end;
+        values[count] = strtoull(p, &end, 10);
+        if (end == p || values[count] == 0)
+            return -1;
+        count++;
+        p = *end == ',' ? end + 1 : end;
+        if (*end != ',' && *end != '\0')
+            return -1;
+    }
+    return count;
+}
+
+/**
+ * @brief Reads the samples written by a previous run with -w.
+ * @param path The samples file.
+ * @param samples The samples read.
+ * @return 0 on success, -1 if the file could not be read.
+*/
+static int read_samples(const char *path, Samples *samples){
+    FILE *file = fopen(path, "r");
+    if (file == NULL)
+        return -1;
+    char line[1024];
+    while (fgets(line, sizeof(line), file) != NULL){
+        Sample sample;
+        unsigned long long seed;
+        if (sscanf(line, "%d,%zu,%255[^,],%llu,%d,%d,%zu,%lf", &sample.length, &sample.population, sample.schedule,\
+                   &seed, &sample.solved, &sample.generations, &sample.evaluations, &sample.wall_time) != 8)
+            continue;
+        sample.seed = seed;
+        add_sample(samples, &sample);
+    }
+    fclose(file);
+    return 0;
+}
+
+/**
+ * @brief Collects a field of the samples of one configuration, sorted.
+ * @param samples The samples.
+ * @param length The length of the configuration.
+ * @param population The population size of the configuration.
+ * @param schedule The schedule of the configuration.
+ * @param field 0 for the generations, 1 for the evaluations, 2 for the wall time.
+ * @param values The values, allocated with samples->size elements.
+ * @return The number of values.
+*/
+static size_t collect(const Samples *samples, int length, size_t population, const char *schedule, int field, double *values){
+    size_t count = 0;
+    for (size_t i = 0; i < samples->size; i++){
+        const Sample *s = &samples->items[i];
+        if (s->length != length || s->population != population || strcmp(s->schedule, schedule) != 0)
+            continue;
+        values[count++] = field == 0 ? s->generations : field == 1 ? (double)s->evaluations : s->wall_time;
+    }
+    qsort(values, count, sizeof(double), double_cmp);
+    return count;
+}
+
+/**
+ * @brief Runs a matrix of target lengths, population sizes and operator schedules over several seeds, and reports
+ * the percentiles of the generations, evaluations and wall time to the exact match. With a baseline, the
+ * evaluations and wall times of each configuration are compared to it with a Mann-Whitney U test.
+ * The exit status is 2 when a configuration is significantly slower than the baseline.
+*/
+int main(int argc, char **argv){
+    size_t lengths[MAX_MATRIX], populations[MAX_MATRIX];
+    int length_count = parse_list("8,16,27", lengths);
+    int population_count = parse_list("256,1024", populations);
+    char *schedules[MAX_MATRIX] = {"default", "random"};
+    int schedule_count = 2;
+    int runs = 10;
+    uint64_t seed = 42;
+    double alpha = DEFAULT_ALPHA;
+    JobConfig config = default_job_config();
+    config.max_generations = 20000;
+    FILE *output = stdout;
+    const char *samples_path = NULL, *baseline_path = NULL;
+    char *schedule_list = NULL;
+    int option;
+    while ((option = getopt(argc, argv, "l:p:m:n:g:s:vo:w:b:a:c:")) != -1){
+        int valid = 1;
+        switch (option){
+            case 'l': valid = (length_count = parse_list(optarg, lengths)) > 0; break;
+            case 'p': valid = (population_count = parse_list(optarg, populations)) > 0; break;
+            case 'm':
+                schedule_list = strdup(optarg);
+                schedule_count = 0;
+                for (char *save = NULL, *s = strtok_r(schedule_list, ",", &save); s != NULL && schedule_count < MAX_MATRIX;\
+                     s = strtok_r(NULL, ",", &save))
+                    schedules[schedule_count++] = s;
+                valid = schedule_count > 0;
+                break;
+            case 'n': valid = (runs = atoi(optarg)) > 0; break;
+            case 'g': valid = (config.max_generations = atoi(optarg)) > 0; break;
+            case 's': seed = strtoull(optarg, NULL, 10); break;
+            case 'v': config.fixed_length = 0; break;
+            case 'o': valid = (output = fopen(optarg, "w")) != NULL; break;
+            case 'w': samples_path = optarg; break;
+            case 'b': baseline_path = optarg; break;
+            case 'a': valid = (alpha = atof(optarg)) > 0; break;
+            case 'c': valid = pin_to_cpu(atoi(optarg)) == 0; break;
+            default: valid = 0;
+        }
+        if (!valid){
+            fprintf(stderr, "Usage: %s [-l lengths] [-p populations] [-m schedules] [-n seeds] [-g max generations] [-s seed] [-v]"\
+                    " [-o summary] [-w samples] [-b baseline samples] [-a alpha] [-c cpu]\n", argv[0]);
+            return 1;
+        }
+    }
+    for (int m = 0; m < schedule_count; m++)
+        if (strlen(schedules[m]) >= SCHEDULE_SIZE || set_schedule(&config, schedules[m]) != 0){
+            fprintf(stderr, "Invalid schedule %s\n", schedules[m]);
+            return 1;
+        }
+    Samples baseline = {0};
+    if (baseline_path != NULL && read_samples(baseline_path, &baseline) != 0){
+        perror(baseline_path);
+        return 1;
+    }
+
+    // The runs are sequential on one worker, so the wall times are not disturbed by each other
+    Worker worker = {0};
+    Samples samples = {0};
+    for (int l = 0; l < length_count; l++)
+        for (int p = 0; p < population_count; p++)
+            for (int m = 0; m < schedule_count; m++){
+                set_schedule(&config, schedules[m]);
+                config.population_size = populations[p];
+                for (int r = 0; r < runs; r++){
+                    Sample sample = {0};
+                    sample.length = lengths[l];
+                    sample.population = populations[p];
+                    snprintf(sample.schedule, sizeof(sample.schedule), "%s", schedules[m]);
+                    sample.seed = seed + r;
+                    // The target word depends on the seed only, so every configuration searches the same words,
+                    // and is drawn from another sequence than the population
+                    seed_random(~sample.seed);
+                    Individual word = create_individual(lengths[l], lengths[l]);
+                    JobResult result = solve_word(&worker, &config, word.genome, sample.seed, NULL);
+                    free_individual(word);
+                    sample.solved = result.solved;
+                    sample.generations = result.generations;
+                    sample.evaluations = result.evaluations;
+                    sample.wall_time = result.wall_time;
+                    add_sample(&samples, &sample);
+                }
+            }
+    free_worker(&worker);
+
+    if (samples_path != NULL){
+        FILE *file = fopen(samples_path, "w");
+        if (file == NULL){
+            perror(samples_path);
+            return 1;
+        }
+        fprintf(file, "length,population,schedule,seed,solved,generations,evaluations,wall_time\n");
+        for (size_t i = 0; i < samples.size; i++){
+            Sample *s = &samples.items[i];
+            fprintf(file, "%d,%zu,%s,%llu,%d,%d,%zu,%.6f\n", s->length, s->population, s->schedule,\
+                    (unsigned long long)s->seed, s->solved, s->generations, s->evaluations, s->wall_time);
+        }
+        fclose(file);
+    }
+
+    fprintf(output, "length,population,schedule,runs,solved,generations_p50,generations_p90,generations_p99,"\
+            "evaluations_p50,evaluations_p90,evaluations_p99,time_p50,time_p90,time_p99");
+    if (baseline_path != NULL)
+        fprintf(output, ",baseline_runs,baseline_time_p50,time_ratio,time_p_value,evaluations_ratio,evaluations_p_value,verdict");
+    fprintf(output, "\n");
+    int regression = 0;
+    size_t capacity = samples.size > baseline.size ? samples.size : baseline.size;
+    double *values = malloc((capacity + 1) * sizeof(double));
+    double *reference = malloc((capacity + 1) * sizeof(double));
+    for (int l = 0; l < length_count; l++)
+        for (int p = 0; p < population_count; p++)
+            for (int m = 0; m < schedule_count; m++){
+                int solved = 0;
+                for (size_t i = 0; i < samples.size; i++)
+                    solved += samples.items[i].solved && samples.items[i].length == (int)lengths[l] &&\
+                              samples.items[i].population == populations[p] && strcmp(samples.items[i].schedule, schedules[m]) == 0;
+                fprintf(output, "%zu,%zu,%s,%d,%d", lengths[l], populations[p], schedules[m], runs, solved);
+                double current[3][3];
+                for (int field = 0; field < 3; field++){
+                    size_t count = collect(&samples, lengths[l], populations[p], schedules[m], field, values);
+                    current[field][0] = percentile(values, count, 0.5);
+                    current[field][1] = percentile(values, count, 0.9);
+                    current[field][2] = percentile(values, count, 0.99);
+                    fprintf(output, field == 2 ? ",%.6f,%.6f,%.6f" : ",%.0f,%.0f,%.0f", current[field][0], current[field][1], current[field][2]);
+                }
+                if (baseline_path != NULL){
+                    double p_values[3], ratios[3];
+                    size_t baseline_runs = 0;
+                    for (int field = 1; field < 3; field++){
+                        size_t count = collect(&samples, lengths[l], populations[p], schedules[m], field, values);
+                        baseline_runs = collect(&baseline, lengths[l], populations[p], schedules[m], field, reference);
+                        double z;
+                        p_values[field] = mann_whitney_u(values, count, reference, baseline_runs, &z);
+                        double reference_median = percentile(reference, baseline_runs, 0.5);
+                        ratios[field] = reference_median > 0 ? current[field][0] / reference_median : NAN;
+                    }
+                    const char *verdict = "same";
+                    if (baseline_runs == 0)
+                        verdict = "no baseline";
+                    else if (p_values[2] < alpha)
+                        verdict = ratios[2] > 1 ? "slower" : "faster";
+                    regression |= strcmp(verdict, "slower") == 0;
+                    fprintf(output, ",%zu,%.6f,%.3f,%.4f,%.3f,%.4f,%s", baseline_runs, percentile(reference, baseline_runs, 0.5),\
+                            ratios[2], p_values[2], ratios[1], p_values[1], verdict);
+                }
+                fprintf(output, "\n");
+            }
+    free(values);
+    free(reference);
+    free(samples.items);
+    free(baseline.items);
+    free(schedule_list);
+    if (output != stdout)
+        fclose(output);
+    return regression ? 2 : 0;
+}
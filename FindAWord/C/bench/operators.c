@@ -0,0 +1,253 @@
+#include <unistd.h>
+
+#include <bench.h>
+#include <jobs.h>
+
+// Genome lengths of the fitness, crossover and mutation cases
+static const int lengths[] = {8, 32, 128, 255};
+// Population sizes of the selection and pairing cases
+static const size_t populations[] = {256, 4096, 65536};
+// Genome length of the individuals of the selection and pairing cases
+#define POPULATION_LENGTH 32
+#define SELECTION_RATE 0.5f
+// Population size of the memory cases, whose measures are divided by it
+#define MEMORY_POPULATION 65536
+
+/**
+ * @brief Inputs of a fitness case.
+*/
+typedef struct {
+    FitnessFunction function;
+    const char *individual;
+    const char *word;
+    float sink;             /**< Sum of the scores, so the calls are not optimized away. */
+} FitnessCase;
+
+/**
+ * @brief Inputs of a selection or pairing case.
+*/
+typedef struct {
+    SelectionFunction selection;
+    PairingFunction pairing;
+    Population population;
+    Ranking ranking;
+    size_t *selected;       /**< The individuals given to the pairing function. */
+    size_t *scratch;        /**< Copy of selected, the pairing functions may reorder it. */
+    size_t selected_size;
+} PopulationCase;
+
+/**
+ * @brief Inputs of a crossover or mutation case.
+*/
+typedef struct {
+    CrossoverFunction crossover;
+    MutationFunction mutation;
+    Individual first;
+    Individual second;
+    Individual mutated;     /**< The individual mutated in place, reset to first when it reaches its bounds. */
+} GenomeCase;
+
+/**
+ * @brief Inputs of a memory case.
+*/
+typedef struct {
+    int packed;             /**< 1 for a packed population, 0 for a population. */
+    int length;             /**< The length of the individuals. */
+} MemoryCase;
+
+static void fitness_operation(void *datas){
+    FitnessCase *c = datas;
+    c->sink += c->function(c->individual, c->word, NULL);
+}
+
+static void selection_operation(void *datas){
+    PopulationCase *c = datas;
+    scratch_free(c->selection(c->population, &c->ranking, SELECTION_RATE, NULL));
+}
+
+static void pairing_operation(void *datas){
+    PopulationCase *c = datas;
+    memcpy(c->scratch, c->selected, c->selected_size * sizeof(size_t));
+    scratch_free(c->pairing(c->scratch, c->selected_size, &c->ranking));
+}
+
+static void crossover_operation(void *datas){
+    GenomeCase *c = datas;
+    free_individual(c->crossover(c->first, c->second, NULL));
+}
+
+/**
+ * @brief Mutates the same individual again and again. insertion_mutate and deletion_mutate stop changing it
+ * at its size bounds, so it is then reset to a copy of the first individual, an amortized cost included in the measure.
+ * @param datas The GenomeCase.
+*/
+static void mutation_operation(void *datas){
+    GenomeCase *c = datas;
+    c->mutated = c->mutation(c->mutated, NULL);
+    if (c->mutated.size <= c->mutated.min_size || c->mutated.size + 1 >= c->mutated.max_size){
+        free_individual(c->mutated);
+        c->mutated = c->first;
+        c->mutated.genome = malloc(c->first.size + 1);
+        memcpy(c->mutated.genome, c->first.genome, c->first.size + 1);
+    }
+}
+
+static void memory_operation(void *datas){
+    MemoryCase *c = datas;
+    if (c->packed)
+        free_packed_population(create_packed_population(MEMORY_POPULATION, c->length, c->length));
+    else
+        free_population(create_population(MEMORY_POPULATION, c->length, c->length));
+}
+
+/**
+ * @brief Creates an individual of a given length, whose size can then vary between half and twice the length.
+ * @param length The length.
+ * @return The individual.
+*/
+static Individual bench_individual(int length){
+    Individual individual = create_individual(length, length);
+    individual.min_size = length / 2;
+    individual.max_size = 2 * length + 2;
+    return individual;
+}
+
+static void bench_fitness(const BenchOptions *options){
+    for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++){
+        seed_random(options->seed);
+        Individual individual = bench_individual(lengths[l]);
+        Individual word = bench_individual(lengths[l]);
+        for (int f = 0; f < FITNESS_FUNCTION_COUNT; f++){
+            if (!bench_selected(options, "fitness", fitness_functions[f].name))
+                continue;
+            FitnessCase c = {.function = fitness_functions[f].function, .individual = individual.genome, .word = word.genome};
+            BenchResult result = {.group = "fitness", .name = fitness_functions[f].name, .length = lengths[l]};
+            measure_operation(options, fitness_operation, &c, &result);
+            write_bench_result(options, &result);
+        }
+        free_individual(individual);
+        free_individual(word);
+    }
+}
+
+static void bench_population(const BenchOptions *options){
+    for (size_t s = 0; s < sizeof(populations) / sizeof(populations[0]); s++){
+        seed_random(options->seed);
+        PopulationCase c = {0};
+        c.population = create_population(populations[s], POPULATION_LENGTH, POPULATION_LENGTH);
+        c.ranking = create_ranking(populations[s]);
+        for (size_t i = 0; i < populations[s]; i++)
+            c.ranking.scores[i] = (float)random_int() / RAND_MAX;
+        rank_scores(&c.ranking, populations[s]);
+        c.selected_size = populations[s] * SELECTION_RATE;
+        c.selected = truncation_selection(c.population, &c.ranking, SELECTION_RATE, NULL);
+        c.scratch = malloc(c.selected_size * sizeof(size_t));
+        for (int f = 0; f < SELECTION_FUNCTION_COUNT; f++){
+            if (!bench_selected(options, "selection", selection_functions[f].name))
+                continue;
+            c.selection = selection_functions[f].function;
+            BenchResult result = {.group = "selection", .name = selection_functions[f].name, .length = POPULATION_LENGTH,\
+                                  .population = populations[s]};
+            measure_operation(options, selection_operation, &c, &result);
+            write_bench_result(options, &result);
+        }
+        for (int f = 0; f < PAIRING_FUNCTION_COUNT; f++){
+            if (!bench_selected(options, "pairing", pairing_functions[f].name))
+                continue;
+            c.pairing = pairing_functions[f].function;
+            BenchResult result = {.group = "pairing", .name = pairing_functions[f].name, .length = POPULATION_LENGTH,\
+                                  .population = populations[s]};
+            measure_operation(options, pairing_operation, &c, &result);
+            write_bench_result(options, &result);
+        }
+        scratch_free(c.selected);
+        free(c.scratch);
+        free_ranking(c.ranking);
+        free_population(c.population);
+    }
+}
+
+static void bench_genomes(const BenchOptions *options){
+    for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++){
+        seed_random(options->seed);
+        GenomeCase c = {0};
+        c.first = bench_individual(lengths[l]);
+        c.second = bench_individual(lengths[l]);
+        for (int f = 0; f < CROSSOVER_FUNCTION_COUNT; f++){
+            if (!bench_selected(options, "crossover", crossover_functions[f].name))
+                continue;
+            c.crossover = crossover_functions[f].function;
+            BenchResult result = {.group = "crossover", .name = crossover_functions[f].name, .length = lengths[l]};
+            measure_operation(options, crossover_operation, &c, &result);
+            write_bench_result(options, &result);
+        }
+        for (int f = 0; f < MUTATION_FUNCTION_COUNT; f++){
+            if (!bench_selected(options, "mutation", mutation_functions[f].name))
+                continue;
+            c.mutation = mutation_functions[f].function;
+            c.mutated = c.first;
+            c.mutated.genome = malloc(c.first.size + 1);
+            memcpy(c.mutated.genome, c.first.genome, c.first.size + 1);
+            BenchResult result = {.group = "mutation", .name = mutation_functions[f].name, .length = lengths[l]};
+            measure_operation(options, mutation_operation, &c, &result);
+            write_bench_result(options, &result);
+            free_individual(c.mutated);
+        }
+        free_individual(c.first);
+        free_individual(c.second);
+    }
+}
+
+/**
+ * @brief Measures the memory of an individual of a population and of a packed population : the creation and
+ * release of a population of MEMORY_POPULATION individuals is measured, and the time, bytes and allocations
+ * are divided by its size, so they are per individual.
+*/
+static void bench_memory(const BenchOptions *options){
+    const char *names[] = {"create_population", "create_packed_population"};
+    for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++)
+        for (int packed = 0; packed < 2; packed++){
+            if (!bench_selected(options, "memory", names[packed]))
+                continue;
+            MemoryCase c = {.packed = packed, .length = lengths[l]};
+            BenchResult result = {.group = "memory", .name = names[packed], .length = lengths[l], .population = MEMORY_POPULATION};
+            measure_operation(options, memory_operation, &c, &result);
+            result.ns_per_op /= MEMORY_POPULATION;
+            result.ns_min /= MEMORY_POPULATION;
+            result.ns_max /= MEMORY_POPULATION;
+            result.bytes_per_op /= MEMORY_POPULATION;
+            result.allocs_per_op /= MEMORY_POPULATION;
+            write_bench_result(options, &result);
+        }
+}
+
+/**
+ * @brief Measures the time and the allocations of every operator, over several genome lengths and population sizes.
+*/
+int main(int argc, char **argv){
+    BenchOptions options = default_bench_options();
+    Workspace *workspace = NULL;
+    int option;
+    while ((option = getopt(argc, argv, "f:o:r:t:s:c:k:w")) != -1){
+        if (option == 'w' && workspace == NULL){
+            // The operators allocate in a workspace sized for the largest cases, as in a generation
+            workspace = create_workspace(populations[sizeof(populations) / sizeof(populations[0]) - 1],\
+                                         lengths[sizeof(lengths) / sizeof(lengths[0]) - 1] + 1);
+            set_workspace(workspace);
+        }
+        else if (option == 'w' || parse_bench_option(&options, option, optarg) != 0){
+            fprintf(stderr, "Usage: %s [-f csv|json] [-o file] [-r repetitions] [-t ms per repetition] [-s seed] [-c cpu] [-k filter] [-w]\n", argv[0]);
+            return 1;
+        }
+    }
+    write_bench_header(&options);
+    bench_fitness(&options);
+    bench_population(&options);
+    bench_genomes(&options);
+    bench_memory(&options);
+    write_bench_footer(&options);
+    if (options.output != stdout)
+        fclose(options.output);
+    free_workspace(workspace);
+    return 0;
+}
@@ -0,0 +1,44 @@
+#ifndef ARENA_H
+#define ARENA_H
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include <gene.h>
+
+// Number of individuals evaluated between two prefetches of an arena backed population
+#define GENOME_CHUNK 65536
+
+/**
+ * @brief Memory of the genomes of a population, outside of the malloc heap.
+ * The arena is made of two spaces. A generation allocates its genomes one after the other in the active
+ * space, and the next generation flips to the other space, so the genomes of a generation are stored in
+ * the order of its individuals and are read sequentially by the fitness phase. Releasing a genome of the
+ * arena does nothing, its space is reused as a whole two generations later.
+ * The arena is anonymous memory, or a memory mapped file to evolve populations whose genomes do not fit
+ * in physical memory. An arena is used by one thread at a time.
+*/
+typedef struct genome_arena {
+    Gene *base;             /**< The two spaces, one after the other. */
+    size_t space_size;      /**< The size of a space in bytes. */
+    size_t used;            /**< The number of bytes allocated in the active space. */
+    int active;             /**< The index of the active space, 0 or 1. */
+    int fd;                 /**< The backing file, -1 for anonymous memory. */
+} GenomeArena;
+
+GenomeArena *create_genome_arena(size_t space_size, const char *path);
+GenomeArena *map_genome_arena(int fd, off_t offset, size_t size, size_t space_size);
+void free_genome_arena(GenomeArena *arena);
+GenomeArena *set_genome_arena(GenomeArena *arena);
+GenomeArena *current_genome_arena();
+Gene *arena_allocate(GenomeArena *arena, size_t size);
+int in_genome_arena(const GenomeArena *arena, const void *pointer);
+void flip_genome_arena(GenomeArena *arena);
+void reset_genome_arena(GenomeArena *arena);
+void prefetch_genomes(const GenomeArena *arena, const Gene *first, const Gene *last);
+
+#endif
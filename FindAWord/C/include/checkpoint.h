@@ -0,0 +1,103 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+#include <jobs.h>
+
+// First bytes of a checkpoint file
+#define CHECKPOINT_MAGIC "FAWCKPT"
+// Version of the layout of a checkpoint file, a file of another version is not restored
+#define CHECKPOINT_VERSION 1
+// Written as a native integer, a file written on a host of another byte order is not restored
+#define CHECKPOINT_BYTE_ORDER 0x01020304u
+// Alignment of the genomes in the file, a multiple of the page size of every host so they can be mapped
+#define CHECKPOINT_ALIGNMENT 65536
+// Size of the operator names stored in the header, with their terminator
+#define CHECKPOINT_NAME 64
+
+/**
+ * @brief Header of a checkpoint file.
+ * The header is followed at lengths_offset by the length of every genome, an array of uint32_t, and at
+ * genomes_offset by the genomes, one after the other in the order of the individuals, each with its
+ * terminator. The genomes are aligned on CHECKPOINT_ALIGNMENT bytes, so they are mapped as they are by
+ * restore_checkpoint. Every field has a fixed width, the integers are in the byte order of the host.
+*/
+typedef struct checkpoint_header {
+    char magic[8];              /**< CHECKPOINT_MAGIC. */
+    uint32_t version;           /**< CHECKPOINT_VERSION. */
+    uint32_t byte_order;        /**< CHECKPOINT_BYTE_ORDER. */
+    uint64_t header_size;       /**< sizeof(CheckpointHeader). */
+    uint64_t generation;        /**< The generation of the population. */
+    uint64_t size;              /**< The number of individuals. */
+    int32_t min_individual_size;    /**< The minimum size of an individual. */
+    int32_t max_individual_size;    /**< The maximum size of an individual. */
+    uint64_t random_state;      /**< State of the random generator of the thread which evolves the population. */
+    uint64_t lengths_offset;    /**< Offset of the genome lengths in the file. */
+    uint64_t genomes_offset;    /**< Offset of the genomes in the file, a multiple of CHECKPOINT_ALIGNMENT. */
+    uint64_t genomes_size;      /**< The number of bytes of the genomes, terminators included. */
+    uint64_t seed;              /**< The seed of the search. */
+    int32_t max_generations;    /**< The number of generations after which the search gives up. */
+    int32_t fixed_length;       /**< 1 if the individuals have the length of the word. */
+    int32_t random_operators;   /**< 1 if the operators are drawn at random each generation. */
+    int32_t word_length;        /**< The length of the target word. */
+    char word[JOB_MAX_WORD + 1];        /**< The target word. */
+    char fitness[CHECKPOINT_NAME];      /**< Name of the fitness function, empty if it has no name. */
+    char selection[CHECKPOINT_NAME];    /**< Name of the selection function. */
+    char pairing[CHECKPOINT_NAME];      /**< Name of the pairing function. */
+    char crossover[CHECKPOINT_NAME];    /**< Name of the crossover function. */
+    char mutation[CHECKPOINT_NAME];     /**< Name of the mutation function. */
+} CheckpointHeader;
+
+/**
+ * @brief Copy of a population ready to be written in a checkpoint file.
+*/
+typedef struct checkpoint_buffer {
+    CheckpointHeader header;    /**< The header of the file. */
+    uint32_t *lengths;          /**< The length of every genome. */
+    size_t lengths_capacity;    /**< The number of lengths the buffer can hold. */
+    Gene *genomes;              /**< The genomes with their terminators. */
+    size_t genomes_capacity;    /**< The number of bytes the buffer can hold. */
+} CheckpointBuffer;
+
+/**
+ * @brief Background writer of the checkpoints of a population.
+ * The writer has two buffers. The evolution loop copies the population in one while the thread of the
+ * writer writes the other one, so queueing a checkpoint costs a copy of the genomes in memory and never
+ * waits for the disk. A file is written next to its path and renamed over it once it is on the disk, so
+ * the path always holds a complete checkpoint.
+*/
+typedef struct checkpoint_writer {
+    char *path;                 /**< The checkpoint file. */
+    int interval;               /**< The number of generations between two checkpoints. */
+    CheckpointBuffer buffers[2];    /**< The double buffer. */
+    int queued;                 /**< The index of the buffer waiting to be written, -1 if none. */
+    int writing;                /**< The index of the buffer being written, -1 if none. */
+    int closed;                 /**< 1 once the writer is freed, the thread writes the queued buffer and exits. */
+    size_t written;             /**< The number of checkpoints written. */
+    size_t failed;              /**< The number of checkpoints which could not be written. */
+    pthread_mutex_t lock;       /**< Protects queued, writing, closed and the counters. */
+    pthread_cond_t changed;     /**< Signaled when a buffer is queued or written, or when the writer is closed. */
+    pthread_t thread;           /**< The thread writing the files. */
+} CheckpointWriter;
+
+int fill_checkpoint(CheckpointBuffer *buffer, Population p, const char *word, const JobConfig *config);
+int write_checkpoint_buffer(const char *path, const CheckpointBuffer *buffer);
+void free_checkpoint_buffer(CheckpointBuffer *buffer);
+int write_checkpoint(const char *path, Population p, const char *word, const JobConfig *config);
+Population restore_checkpoint(const char *path, size_t space_size, CheckpointHeader *header);
+int checkpoint_job_config(const CheckpointHeader *header, JobConfig *config);
+
+CheckpointWriter *create_checkpoint_writer(const char *path, int interval);
+int checkpoint_population(CheckpointWriter *writer, Population p, const char *word, const JobConfig *config);
+void flush_checkpoint_writer(CheckpointWriter *writer);
+void free_checkpoint_writer(CheckpointWriter *writer);
+
+#endif
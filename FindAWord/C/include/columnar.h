@@ -0,0 +1,36 @@
+#ifndef COLUMNAR_H
+#define COLUMNAR_H
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include <population.h>
+
+// Number of individuals scored together, a multiple of the widest vector register
+#define COLUMN_BLOCK 64
+
+/**
+ * @brief Column-major (position-major) copy of a fixed-length population.
+ * Gene j of individual i is stored at genes[j * stride + i], so the genes of all the individuals at a
+ * given position are contiguous and can be compared with a broadcast character of the target word.
+*/
+typedef struct column_population {
+    Gene *genes;    /**< The genes, one row of stride genes per position. */
+    size_t size;    /**< The number of individuals. */
+    size_t stride;  /**< The number of individuals rounded up to a multiple of COLUMN_BLOCK. */
+    int length;     /**< The length of every genome. */
+    size_t capacity;    /**< The number of genes the buffer can hold. */
+} ColumnPopulation;
+
+ColumnPopulation create_column_population(size_t size, int length);
+int reserve_column_population(ColumnPopulation *columns, size_t size, int length);
+void free_column_population(ColumnPopulation columns);
+int is_fixed_length(Population p, const char *word);
+void rows_to_columns(Population p, ColumnPopulation *columns);
+void columnar_hamming_fitness(const ColumnPopulation *columns, const char *word, float *scores);
+void columnar_manhattan_fitness(const ColumnPopulation *columns, const char *word, float *scores);
+
+#endif
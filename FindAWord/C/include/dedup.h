@@ -0,0 +1,36 @@
+#ifndef DEDUP_H
+#define DEDUP_H
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <individual.h>
+
+/**
+ * @brief What make_generation does with the duplicates of a population.
+*/
+typedef enum dedup_mode {
+    DEDUP_DROP,     /**< Duplicates are replaced by new random individuals before the evaluation. */
+    DEDUP_SHARE     /**< Duplicates are kept and take the score of their first copy without being evaluated. */
+} DedupMode;
+
+/**
+ * @brief Open addressing hash set of the genomes of a population.
+ * The table is attached to a population (Population.dedup) and reused from one generation to the next.
+ * Its slots hold the index of the first individual with a genome, so genomes are not copied.
+*/
+typedef struct dedup_table {
+    DedupMode mode;         /**< What is done with the duplicates. */
+    uint64_t *hashes;       /**< Hash of the genome of each slot. */
+    size_t *slots;          /**< Index of the individual of each slot plus one, 0 for an empty slot. */
+    int64_t *first;         /**< Index of the first copy of each individual, -1 for the first copy itself. */
+    size_t capacity;        /**< Number of slots, a power of two. */
+    size_t size;            /**< Number of individuals the first array can hold. */
+    size_t duplicates;      /**< Number of duplicates found by the last dedup_individuals. */
+} DedupTable;
+
+DedupTable *create_dedup_table(DedupMode mode);
+void free_dedup_table(DedupTable *table);
+int dedup_individuals(DedupTable *table, Individual *individuals, size_t size);
+
+#endif
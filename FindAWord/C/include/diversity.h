@@ -0,0 +1,36 @@
+#ifndef DIVERSITY_H
+#define DIVERSITY_H
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <individual.h>
+
+// Number of different genes
+#define GENE_SYMBOLS (MAXCHAR - MINCHAR + 1)
+
+/**
+ * @brief Per-position gene histograms and length histogram of a population.
+ * The model is attached to a population (Population.diversity) and updated by make_generation as it writes
+ * the individuals of the new generation, so the diversity measures cost O(max_size * GENE_SYMBOLS) instead of
+ * pairwise comparisons of the individuals.
+*/
+typedef struct diversity {
+    size_t *counts;     /**< Number of individuals with each gene at each position, max_size rows of GENE_SYMBOLS. */
+    size_t *lengths;    /**< Number of individuals of each length, max_size + 1 entries. */
+    int max_size;       /**< The maximum size an individual can have. */
+    size_t size;        /**< The number of individuals counted. */
+} Diversity;
+
+Diversity *create_diversity(int max_individual_size);
+void free_diversity(Diversity *diversity);
+void reset_diversity(Diversity *diversity);
+void add_to_diversity(Diversity *diversity, Individual individual);
+void remove_from_diversity(Diversity *diversity, Individual individual);
+void count_diversity(Diversity *diversity, Individual *individuals, size_t size);
+void merge_diversity(Diversity *diversity, const Diversity *other);
+float diversity_entropy(const Diversity *diversity, float *entropies);
+int diversity_consensus(const Diversity *diversity, char *consensus);
+float diversity_consensus_distance(const Diversity *diversity);
+
+#endif
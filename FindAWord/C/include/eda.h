@@ -0,0 +1,45 @@
+#ifndef EDA_H
+#define EDA_H
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <population.h>
+
+// Smallest probability of a gene or a length, so the model never loses a symbol
+#define EDA_MIN_PROBABILITY 0.0005f
+
+/**
+ * @brief Update rule of an estimation of distribution model.
+*/
+typedef enum eda_algorithm {
+    EDA_UMDA,   /**< The model is replaced by the frequencies of the selected individuals. */
+    EDA_PBIL    /**< The model moves towards the frequencies of the selected individuals by the learning rate. */
+} EdaAlgorithm;
+
+/**
+ * @brief Estimation of distribution model of the find-a-word problem.
+ * The model holds the probability of each gene at each position and the probability of each length.
+ * The positions are independent, so a new population is sampled gene by gene, with one alias table
+ * per position giving a gene in O(1).
+*/
+typedef struct eda_model {
+    EdaAlgorithm algorithm;     /**< The update rule. */
+    float learning_rate;        /**< The learning rate of EDA_PBIL. */
+    float selection_rate;       /**< The fraction of the best individuals the model is learnt from. */
+    int min_size;               /**< The minimum size an individual can have. */
+    int max_size;               /**< The maximum size an individual can have. */
+    float *probabilities;       /**< Probability of each gene at each position, max_size rows of GENE_SYMBOLS. */
+    float *length_probabilities;    /**< Probability of each length from min_size to max_size. */
+    float *alias_probabilities; /**< Probability to keep the drawn gene, max_size rows of GENE_SYMBOLS. */
+    uint8_t *aliases;           /**< Gene drawn instead, max_size rows of GENE_SYMBOLS. */
+    float *frequencies;         /**< Scratch buffer of the frequencies of the selected individuals. */
+} EdaModel;
+
+EdaModel *create_eda_model(EdaAlgorithm algorithm, int min_size_individual, int max_size_individual, float learning_rate, float selection_rate);
+void free_eda_model(EdaModel *model);
+Individual sample_individual(const EdaModel *model);
+Population eda_generation(Population p, const char *word, EdaModel *model, FitnessFunction fitness_function, void *fitness_optional_datas,\
+                          Ranking *ranking, GenerationStats *stats);
+
+#endif
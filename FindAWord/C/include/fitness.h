@@ -7,6 +7,9 @@
 #include <string.h>
 #include <individual.h>
 
+// Longest word whose Smith-Waterman score row is kept on the stack, plus one
+#define SMITH_WATERMAN_STACK 256
+
 /**
  * @brief Function pointer type for defining fitness functions.
  * This type defines a function pointer for fitness functions, which takes two strings and an optional data argument
@@ -18,6 +21,18 @@
 */
 typedef float (*FitnessFunction)(const char *, const char *, void *);
 
+/**
+ * @brief Function pointer type for defining integer distance functions.
+ * A distance function returns the raw, non normalized distance between the individual and the target word,
+ * where 0 represents a perfect match. Distances are bounded by a small multiple of the longest string
+ * (see each function), which allows ranking a population with a counting or radix sort.
+ * @param individual A pointer to a string representing the individual whose distance is being evaluated.
+ * @param word A pointer to a string representing the target word or phrase.
+ * @param optional_datas An optional pointer to additional data that may be used by the distance function.
+ * @return The distance between the individual and the word as a non negative integer.
+*/
+typedef int (*DistanceFunction)(const char *, const char *, void *);
+
 
 #define swap(x, y) do { \
     int temp_swap = x; \
@@ -31,6 +46,12 @@ char * union_set(const char *set1, const char *set2);
 char * intersection_set(const char * set1, const char *set2);
 
 
+int modified_hamming_distance(const char *individual, const char *word, void * optional_datas);
+int levenstein_distance(const char *individual, const char *word, void * optional_datas);
+int smith_waterman_distance(const char *individual, const char *word, void * optional_datas);
+int nlcs_distance(const char * individual, const char * word, void *optional_datas);
+int manhattan_distance(const char* individual, const char* word, void *optional_datas);
+
 float modified_hamming_distance_fitness(const char *individual, const char *word, void * optional_datas);
 float levenstein_distance_fitness(const char *individual, const char *word, void * optional_datas);
 float smith_waterman(const char *individual, const char *word, void * optional_datas);
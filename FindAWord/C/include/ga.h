@@ -0,0 +1,50 @@
+#ifndef GA_H
+#define GA_H
+#include <stddef.h>
+
+/**
+ * @brief Engine evolving a population towards a word, behind an opaque handle.
+ * The engine owns its population, genome arena, ranking and random generator, allocated by ga_create
+ * and reused by every ga_step. This header does not depend on the other headers, so libga.so can be
+ * used from other languages.
+*/
+typedef struct ga_engine GaEngine;
+
+/**
+ * @brief Parameters of an engine.
+*/
+typedef struct ga_config {
+    const char *word;           /**< The target word, copied. */
+    size_t population_size;     /**< The number of individuals, 0 for the default. */
+    int fixed_length;           /**< 1 if the individuals have the length of the word, 0 for lengths between 1 and twice its length. */
+    unsigned long long seed;    /**< Seed of the random generator of the engine. */
+    const char *fitness;        /**< Name of the fitness function, NULL for the default. */
+    const char *selection;      /**< Name of the selection function, NULL for the default. */
+    const char *pairing;        /**< Name of the pairing function, NULL for the default. */
+    const char *crossover;      /**< Name of the crossover function, NULL for the default. */
+    const char *mutation;       /**< Name of the mutation function, NULL for the default. */
+    int diversity;              /**< 1 to measure the entropy and the consensus distance of the generations. */
+} GaConfig;
+
+/**
+ * @brief Statistics of an engine.
+*/
+typedef struct ga_stats {
+    int generations;            /**< The number of generations run. */
+    size_t evaluations;         /**< The number of fitness function calls. */
+    float best_score;           /**< The best score of the last generation, lower is better. */
+    float mean_score;           /**< The mean score of the last generation. */
+    int solved;                 /**< 1 once the word was found. */
+    double elapsed;             /**< Time spent in ga_step, in seconds. */
+    float entropy;              /**< Mean positional entropy of the last generation, 0 without diversity. */
+    float consensus_distance;   /**< Mean distance of the last generation to its consensus, 0 without diversity. */
+} GaStats;
+
+GaEngine *ga_create(const GaConfig *config);
+// Returns the number of generations run, 0 only when the word was found by an earlier call, see GaStats.solved
+int ga_step(GaEngine *engine, int generations);
+const char *ga_best(const GaEngine *engine);
+GaStats ga_stats(const GaEngine *engine);
+void ga_destroy(GaEngine *engine);
+
+#endif
@@ -2,6 +2,7 @@
 #define GENE_H
 
 #include <stdlib.h>
+#include <random.h>
 
 #define MINCHAR 32
 #define MAXCHAR 127
@@ -0,0 +1,40 @@
+#ifndef GENERATION_VARIANTS_H
+#define GENERATION_VARIANTS_H
+
+/**
+ * @brief List of the generation variants, make_generation specialized at compile time.
+ * Each entry X(name, fitness, fitness_datas, selection, selection_datas, pairing, pairing_datas,
+ * crossover, crossover_datas, mutation, mutation_datas) defines the function make_generation_<name>.
+ * The optional data are expressions evaluated in the variant, where p, word, ranking and stats are
+ * its parameters: a compound literal such as &(float){0.2f} is a constant the compiler can propagate
+ * into the operator. The variants use the same optional data as main.c, so find_generation_variant
+ * can replace make_generation by a variant with the same behavior.
+ * Add an entry to specialize another combination; the other ones use make_generation.
+*/
+#define GENERATION_VARIANTS(X)\
+    X(hamming_truncation_random_uniform_random,\
+      modified_hamming_distance_fitness, NULL, truncation_selection, NULL, random_pairing_parents, ranking,\
+      uniform_crossover, NULL, random_mutate, NULL)\
+    X(hamming_truncation_random_uniform_swap,\
+      modified_hamming_distance_fitness, NULL, truncation_selection, NULL, random_pairing_parents, ranking,\
+      uniform_crossover, NULL, swap_mutate, &(float){0.2f})\
+    X(hamming_tournament_random_uniform_random,\
+      modified_hamming_distance_fitness, NULL, tournament_selection, NULL, random_pairing_parents, ranking,\
+      uniform_crossover, NULL, random_mutate, NULL)\
+    X(hamming_rank_assortative_multipoint_random,\
+      modified_hamming_distance_fitness, NULL, rank_based_selection, NULL, assortative_pairing_parents, ranking,\
+      multipoint_crossover, &(int){2}, random_mutate, NULL)\
+    X(hamming_truncation_consecutive_multipoint_swap,\
+      modified_hamming_distance_fitness, NULL, truncation_selection, NULL, consecutive_pairing_parents, ranking,\
+      multipoint_crossover, &(int){2}, swap_mutate, &(float){0.2f})\
+    X(manhattan_truncation_random_uniform_random,\
+      manhattan_distance_fitness, NULL, truncation_selection, NULL, random_pairing_parents, ranking,\
+      uniform_crossover, NULL, random_mutate, NULL)\
+    X(levenstein_truncation_random_uniform_insertion,\
+      levenstein_distance_fitness, NULL, truncation_selection, NULL, random_pairing_parents, ranking,\
+      uniform_crossover, NULL, insertion_mutate, NULL)\
+    X(levenstein_truncation_random_uniform_deletion,\
+      levenstein_distance_fitness, NULL, truncation_selection, NULL, random_pairing_parents, ranking,\
+      uniform_crossover, NULL, deletion_mutate, NULL)
+
+#endif
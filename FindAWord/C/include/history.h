@@ -0,0 +1,201 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+#define _GNU_SOURCE
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <jobs.h>
+
+// First bytes of a history file
+#define HISTORY_MAGIC "FAWHIST"
+// Version of the layout of a history file, a file of another version is not read
+#define HISTORY_VERSION 1
+// Written as a native integer, a file written on a host of another byte order is not read
+#define HISTORY_BYTE_ORDER 0x01020304u
+// Number of generation records of the ring buffer between the evolution loop and the writer thread, a power of two
+#define HISTORY_RING 4096
+// Number of records of a block of the file, each block stores its columns one after the other
+#define HISTORY_BLOCK 1024
+// Time the writer thread sleeps when the ring buffer is empty, in microseconds, long enough for its wake-ups not to slow the search
+#define HISTORY_POLL_INTERVAL 10000
+
+/**
+ * @brief The columns of a history file, in the order they are stored in a block.
+*/
+typedef enum history_column {
+    HISTORY_GENERATION,         /**< The generation of the population, int32. */
+    HISTORY_EVALUATIONS,        /**< The number of fitness function calls, uint64. */
+    HISTORY_BEST_SCORE,         /**< Score of the best individual, float. */
+    HISTORY_MEAN_SCORE,         /**< Mean score of the population, float. */
+    HISTORY_VARIANCE_SCORE,     /**< Variance of the scores, float. */
+    HISTORY_REPORTING_SCORE,    /**< Score of the best individual with the reporting function, float. */
+    HISTORY_DUPLICATE_RATIO,    /**< Ratio of duplicates, float. */
+    HISTORY_ENTROPY,            /**< Mean positional entropy, float. */
+    HISTORY_CONSENSUS_DISTANCE, /**< Mean distance to the consensus, float. */
+    HISTORY_EXACT_MATCH,        /**< 1 if the best individual is the word, int32. */
+    HISTORY_TIME,               /**< Seconds since the creation of the recorder, double. */
+    HISTORY_COLUMN_COUNT        /**< The number of columns. */
+} HistoryColumn;
+
+/**
+ * @brief Types of the values of the columns.
+*/
+typedef enum history_type {
+    HISTORY_INT32,
+    HISTORY_UINT64,
+    HISTORY_FLOAT,
+    HISTORY_DOUBLE
+} HistoryType;
+
+/**
+ * @brief Name and type of a column.
+*/
+typedef struct history_column_info {
+    const char *name;   /**< The name of the column. */
+    HistoryType type;   /**< The type of its values. */
+    size_t width;       /**< The size of a value in bytes. */
+} HistoryColumnInfo;
+
+extern const HistoryColumnInfo history_columns[HISTORY_COLUMN_COUNT];
+
+/**
+ * @brief Header of a history file.
+ * The header is followed by the blocks of records and the population snapshots, in the order the writer
+ * thread wrote them, then by the offset of every block (uint64_t) at blocks_offset and by the entries of the
+ * snapshots at snapshots_offset. A block holds HISTORY_BLOCK records, stored column by column: the values of
+ * a column are contiguous, at the sum of the widths of the columns before it times HISTORY_BLOCK. The last
+ * block is only filled up to record_count. The tables and the counts are written when the recorder is freed,
+ * a file with complete set to 0 was not closed. The integers are in the byte order of the host.
+*/
+typedef struct history_header {
+    char magic[8];              /**< HISTORY_MAGIC. */
+    uint32_t version;           /**< HISTORY_VERSION. */
+    uint32_t byte_order;        /**< HISTORY_BYTE_ORDER. */
+    uint64_t header_size;       /**< sizeof(HistoryHeader). */
+    uint32_t column_count;      /**< HISTORY_COLUMN_COUNT. */
+    uint32_t block_records;     /**< HISTORY_BLOCK. */
+    uint32_t complete;          /**< 1 once the recorder is freed and the tables are written. */
+    uint32_t word_length;       /**< The length of the target word. */
+    uint64_t record_count;      /**< The number of records. */
+    uint64_t block_count;       /**< The number of blocks. */
+    uint64_t snapshot_count;    /**< The number of snapshots. */
+    uint64_t dropped_records;   /**< The records lost because the ring buffer was full. */
+    uint64_t dropped_snapshots; /**< The snapshots lost because the writer thread was still writing the previous ones. */
+    uint64_t blocks_offset;     /**< Offset of the offsets of the blocks. */
+    uint64_t snapshots_offset;  /**< Offset of the snapshot entries. */
+    char word[JOB_MAX_WORD + 1];    /**< The target word. */
+} HistoryHeader;
+
+/**
+ * @brief Entry of a population snapshot in a history file.
+ * A snapshot holds the genomes of the population in the order of its individuals. Each genome is delta
+ * coded against the previous one: the length of their common prefix, the length of their common suffix
+ * and the length of the genes in between, as variable length integers. The genes in between follow as runs
+ * compared position by position to the previous genome: the number of equal genes, the number of different
+ * genes and these genes. The genomes of a converged population differ by a few genes, so a genome is a few bytes.
+ * A snapshot whose coded genomes would not be smaller than the genomes, such as a population still diverse,
+ * stores the genomes as they are.
+*/
+typedef struct history_snapshot {
+    int64_t generation;         /**< The generation of the population. */
+    uint64_t size;              /**< The number of genomes. */
+    uint64_t offset;            /**< Offset of the coded genomes in the file. */
+    uint64_t coded_size;        /**< The number of bytes of the coded genomes. */
+    uint64_t genomes_size;      /**< The number of bytes of the decoded genomes, terminators included. */
+    uint64_t delta_coded;       /**< 1 if the genomes are delta coded, 0 if they are stored with their terminators. */
+} HistorySnapshot;
+
+/**
+ * @brief Statistics of one generation, as queued in the ring buffer.
+*/
+typedef struct history_record {
+    int32_t generation;         /**< The generation of the population. */
+    int32_t exact_match;        /**< 1 if the best individual is the word. */
+    uint64_t evaluations;       /**< The number of fitness function calls. */
+    float best_score;           /**< Score of the best individual. */
+    float mean_score;           /**< Mean score of the population. */
+    float variance_score;       /**< Variance of the scores. */
+    float reporting_score;      /**< Score of the best individual with the reporting function. */
+    float duplicate_ratio;      /**< Ratio of duplicates. */
+    float entropy;              /**< Mean positional entropy. */
+    float consensus_distance;   /**< Mean distance to the consensus. */
+    int32_t snapshot;           /**< The snapshot buffer holding the population of the generation, -1 if none. */
+    double time;                /**< Seconds since the creation of the recorder. */
+} HistoryRecord;
+
+/**
+ * @brief Copy of the genomes of a population waiting to be coded by the writer thread.
+*/
+typedef struct history_snapshot_buffer {
+    atomic_int filled;          /**< 1 from the copy of a population until the writer thread has written it. */
+    int64_t generation;         /**< The generation of the population. */
+    size_t size;                /**< The number of genomes. */
+    Gene *genomes;              /**< The genomes with their terminators, one after the other. */
+    size_t genomes_size;        /**< The number of bytes of the genomes. */
+    size_t capacity;            /**< The number of bytes the buffer can hold. */
+} HistorySnapshotBuffer;
+
+/**
+ * @brief Recorder of the statistics of the generations of a population in a history file.
+ * The evolution loop appends the statistics of each generation to a single producer, single consumer ring
+ * buffer, without lock nor system call, and every snapshot_interval generations copies the genomes of the
+ * population in a free snapshot buffer. The writer thread drains the ring buffer into column-major blocks,
+ * codes the snapshots and appends them to the file. When the ring buffer is full, or both snapshot buffers
+ * are still being written, the generation is dropped and counted instead of waiting for the disk.
+*/
+typedef struct history_recorder {
+    HistoryRecord ring[HISTORY_RING];   /**< The records queued by the evolution loop. */
+    _Alignas(64) atomic_size_t head;    /**< The number of records queued, written by the evolution loop. */
+    _Alignas(64) atomic_size_t tail;    /**< The number of records taken, written by the writer thread, on its own cache line. */
+    _Alignas(64) size_t cached_tail;    /**< The tail last read by the evolution loop, so it reads the tail only when the ring looks full. */
+    HistorySnapshotBuffer snapshots[2];     /**< The population copies queued by the evolution loop. */
+    int snapshot_interval;      /**< The number of generations between two snapshots, 0 to disable them. */
+    double start_time;          /**< Time of the creation of the recorder. */
+    size_t dropped_records;     /**< The records dropped by the evolution loop. */
+    size_t dropped_snapshots;   /**< The snapshots dropped by the evolution loop. */
+    atomic_int closed;          /**< 1 once the recorder is freed, the writer thread drains the ring buffer and exits. */
+    int fd;                     /**< The history file. */
+    HistoryHeader header;       /**< The header of the file, completed by the writer thread. */
+    char *block;                /**< The block being filled by the writer thread. */
+    size_t block_fill;          /**< The number of records of the block. */
+    uint64_t *block_offsets;    /**< The offsets of the blocks written. */
+    HistorySnapshot *snapshot_entries;  /**< The entries of the snapshots written. */
+    size_t entries_capacity;    /**< The number of offsets and entries the tables can hold. */
+    uint8_t *coded;             /**< Buffer of the coded genomes of a snapshot. */
+    size_t coded_capacity;      /**< The number of bytes the buffer can hold. */
+    uint64_t end;               /**< The size of the file. */
+    int failed;                 /**< 1 once a write failed, the writer thread stops writing. */
+    pthread_t thread;           /**< The writer thread. */
+} HistoryRecorder;
+
+/**
+ * @brief History file mapped in memory.
+*/
+typedef struct history_reader {
+    const char *base;           /**< The mapped file. */
+    size_t size;                /**< The size of the file. */
+    const HistoryHeader *header;        /**< The header of the file. */
+    const uint64_t *block_offsets;      /**< The offsets of the blocks. */
+    const HistorySnapshot *snapshots;   /**< The entries of the snapshots. */
+    size_t column_offsets[HISTORY_COLUMN_COUNT];    /**< Offset of each column in a block. */
+} HistoryReader;
+
+HistoryRecorder *create_history_recorder(const char *path, const char *word, int snapshot_interval);
+int record_generation(HistoryRecorder *recorder, Population p, const GenerationStats *stats);
+int free_history_recorder(HistoryRecorder *recorder);
+
+HistoryReader *open_history(const char *path);
+double history_value(const HistoryReader *reader, HistoryColumn column, size_t index);
+Gene *read_history_snapshot(const HistoryReader *reader, size_t index);
+void close_history(HistoryReader *reader);
+
+#endif
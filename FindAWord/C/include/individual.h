@@ -2,6 +2,9 @@
 #define INDIVIDUAL_H
 
 #include <gene.h>
+#include <arena.h>
+#include <workspace.h>
+#include <profile.h>
 
 /**
  * @brief Struct representing an individual in a genetic algorithm.
@@ -15,5 +18,7 @@ typedef struct individual{
 
 Individual create_individual(int min_size_individual, int max_size_individual);
 void free_individual(Individual individual);
+Gene *allocate_genome(size_t size);
+void release_genome(Gene *genome);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,153 @@
+#ifndef JOBS_H
+#define JOBS_H
+#include <stdio.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include <population.h>
+#include <packed.h>
+#include <eda.h>
+
+// Longest target word a job accepts, the genome arenas of the workers are sized for it
+#define JOB_MAX_WORD 255
+
+// The number of operators of each kind which can be chosen by name
+#define FITNESS_FUNCTION_COUNT 9
+#define SELECTION_FUNCTION_COUNT 4
+#define PAIRING_FUNCTION_COUNT 5
+#define CROSSOVER_FUNCTION_COUNT 3
+#define MUTATION_FUNCTION_COUNT 5
+// The number of engines which can be chosen by name
+#define ENGINE_COUNT 4
+// Learning rate of the ENGINE_PBIL model
+#define JOB_EDA_LEARNING_RATE 0.3f
+// Fraction of the best individuals the models of ENGINE_UMDA and ENGINE_PBIL are learnt from
+#define JOB_EDA_SELECTION_RATE 0.2f
+
+/**
+ * @brief The generation engines a job can run.
+*/
+typedef enum job_engine {
+    ENGINE_GENERATION,  /**< make_generation and its variants, with the operators of the job. */
+    ENGINE_PACKED,      /**< packed_make_generation, on genomes packed on 7 bits, with its fixed operators. */
+    ENGINE_UMDA,        /**< eda_generation with an EDA_UMDA model, with the fitness function of the job. */
+    ENGINE_PBIL         /**< eda_generation with an EDA_PBIL model, with the fitness function of the job. */
+} JobEngine;
+
+extern const char *engine_names[ENGINE_COUNT];
+
+/**
+ * @brief Operators with their function names, used to choose them by name.
+*/
+typedef struct { const char *name; FitnessFunction function; } NamedFitnessFunction;
+typedef struct { const char *name; SelectionFunction function; } NamedSelectionFunction;
+typedef struct { const char *name; PairingFunction function; } NamedPairingFunction;
+typedef struct { const char *name; CrossoverFunction function; } NamedCrossoverFunction;
+typedef struct { const char *name; MutationFunction function; } NamedMutationFunction;
+
+extern const NamedFitnessFunction fitness_functions[FITNESS_FUNCTION_COUNT];
+extern const NamedSelectionFunction selection_functions[SELECTION_FUNCTION_COUNT];
+extern const NamedPairingFunction pairing_functions[PAIRING_FUNCTION_COUNT];
+extern const NamedCrossoverFunction crossover_functions[CROSSOVER_FUNCTION_COUNT];
+extern const NamedMutationFunction mutation_functions[MUTATION_FUNCTION_COUNT];
+
+/**
+ * @brief Parameters of the search of one target word.
+*/
+typedef struct job_config {
+    size_t population_size;                 /**< The number of individuals. */
+    int max_generations;                    /**< The number of generations after which the job gives up. */
+    int fixed_length;                       /**< 1 if the individuals have the length of the word, 0 for lengths between 1 and twice the length of the word. */
+    int random_operators;                   /**< 1 to draw the operators at random each generation, the operators below are then ignored. */
+    uint64_t seed;                          /**< Seed of the random generator, combined with the index of the job. */
+    JobEngine engine;                       /**< The generation engine, the operators below are only used by ENGINE_GENERATION, and the fitness function by the EDA engines. */
+    int diversity;                          /**< 1 to keep the gene histograms of the population, see Diversity, except with ENGINE_PACKED. */
+    FitnessFunction fitness_function;       /**< The fitness function. */
+    SelectionFunction selection_function;   /**< The selection function. */
+    PairingFunction pairing_function;       /**< The pairing function. */
+    CrossoverFunction crossover_function;   /**< The crossover function. */
+    MutationFunction mutation_function;     /**< The mutation function. */
+} JobConfig;
+
+/**
+ * @brief Result of the search of one target word.
+*/
+typedef struct job_result {
+    int solved;             /**< 1 if the word was found. */
+    int cancelled;          /**< 1 if the job was stopped by request_stop before finding the word. */
+    int failed;             /**< 1 if the search could not run: invalid word, or its allocations failed. */
+    int generations;        /**< The number of generations run. */
+    size_t evaluations;     /**< The number of fitness function calls. */
+    double wall_time;       /**< Elapsed time in seconds. */
+    float entropy;          /**< Mean positional entropy of the last population, 0 without diversity. */
+    float consensus_distance;   /**< Mean distance of the last population to its consensus, 0 without diversity. */
+} JobResult;
+
+/**
+ * @brief Resources of a worker thread, allocated once and reused by all its jobs.
+*/
+typedef struct worker {
+    GenomeArena *arena;     /**< Arena of the genomes of the populations of the worker. */
+    Workspace *workspace;   /**< Workspace of the buffers of the generations of the worker. */
+    size_t capacity;        /**< The number of individuals the arena and the workspace are sized for. */
+    Ranking ranking;        /**< Ranking shared by the generations of the worker. */
+    ScoreCache *score_cache;    /**< Scores of the children of the populations of the worker, used by the jobs which keep their operators. */
+    StopSignal *stop;       /**< Stop signal of the jobs which do not have their own. */
+    struct job_runner *runner;  /**< The runner of the worker thread, NULL for a worker used directly. */
+} Worker;
+
+struct job;
+
+/**
+ * @brief Function called by the worker thread when a job is finished.
+ * @param job The finished job, freed after the call.
+ * @param result The result of the job.
+ * @param optional_datas The data given with the job.
+*/
+typedef void (*JobCallback)(const struct job *, JobResult, void *);
+
+/**
+ * @brief A target word waiting in the queue of a job runner.
+*/
+typedef struct job {
+    char *word;                 /**< The target word. */
+    size_t index;               /**< The order in which the job was submitted. */
+    JobConfig config;           /**< The parameters of the search. */
+    StopSignal *stop;           /**< Optional stop signal to cancel the job, NULL to use the signal of the worker. */
+    JobCallback callback;       /**< Function called with the result. */
+    void *callback_datas;       /**< Optional data to be passed to the callback. */
+    struct job *next;           /**< The next job of the queue. */
+} Job;
+
+/**
+ * @brief Pool of worker threads solving the jobs of a shared queue.
+*/
+typedef struct job_runner {
+    pthread_t *threads;         /**< The worker threads. */
+    Worker *workers;            /**< The resources of each worker thread. */
+    int worker_count;           /**< The number of worker threads. */
+    pthread_mutex_t lock;       /**< Lock of the queue and of the counters. */
+    pthread_cond_t available;   /**< Signaled when a job is queued or the runner is closed. */
+    Job *head;                  /**< The first job of the queue. */
+    Job *tail;                  /**< The last job of the queue. */
+    int closed;                 /**< 1 once no more jobs will be submitted. */
+    int joined;                 /**< 1 once the worker threads have exited. */
+    size_t submitted;           /**< The number of jobs submitted. */
+    size_t finished;            /**< The number of jobs finished. */
+    size_t solved;              /**< The number of jobs which found their word. */
+} JobRunner;
+
+JobConfig default_job_config();
+int set_job_operator(JobConfig *config, const char *kind, const char *name);
+int set_job_engine(JobConfig *config, const char *name);
+int prepare_worker(Worker *worker, size_t population_size);
+void free_worker(Worker *worker);
+JobResult solve_word(Worker *worker, const JobConfig *config, const char *word, uint64_t seed, StopSignal *stop);
+
+JobRunner *create_job_runner(int worker_count);
+int submit_job(JobRunner *runner, const char *word, const JobConfig *config, StopSignal *stop, JobCallback callback, void *callback_datas);
+void close_job_runner(JobRunner *runner);
+void free_job_runner(JobRunner *runner);
+size_t run_jobs(const JobConfig *config, int worker_count, FILE *input, FILE *output, size_t *solved);
+
+#endif
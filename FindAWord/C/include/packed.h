@@ -0,0 +1,51 @@
+#ifndef PACKED_H
+#define PACKED_H
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+#include <population.h>
+
+// Bits of a packed gene, enough for the MAXCHAR - MINCHAR + 1 = 96 genes
+#define PACKED_GENE_BITS 7
+#define PACKED_GENE_MASK 0x7FULL
+// Genes stored in one 64 bits word
+#define PACKED_GENES_PER_WORD 9
+// The lengths are stored on 8 bits
+#define PACKED_MAX_LENGTH 255
+
+/**
+ * @brief Population whose genomes are packed on 7 bits per gene.
+ * A gene is stored as gene - MINCHAR, 9 genes per 64 bits word, without terminator, in one contiguous
+ * buffer of words_per_individual words per individual. An individual of length 27 takes 25 bytes instead of
+ * an Individual and a separately allocated genome, so populations of 100M+ individuals fit in memory.
+*/
+typedef struct packed_population {
+    uint64_t *words;            /**< The packed genomes. */
+    uint8_t *lengths;           /**< The length of each genome. */
+    uint8_t *distances;         /**< Scratch buffer holding the distance of each individual to the word. */
+    size_t size;                /**< The number of individuals in the population. */
+    int min_individual_size;    /**< The minimum size an individual can have. */
+    int max_individual_size;    /**< The maximum size an individual can have. */
+    int words_per_individual;   /**< The number of words of a genome. */
+    int generation;             /**< The current generation of the population. */
+} PackedPopulation;
+
+PackedPopulation create_packed_population(size_t size, int min_size_individual, int max_size_individual);
+void free_packed_population(PackedPopulation p);
+PackedPopulation pack_population(Population p);
+Individual unpack_individual(const PackedPopulation *p, size_t index);
+
+void pack_genes(const Gene *genes, int length, uint64_t *words);
+void unpack_genes(const uint64_t *words, int length, Gene *genes);
+
+int packed_hamming_distance(const uint64_t *individual, int individual_length, const uint64_t *word, int word_length);
+int packed_uniform_crossover(const uint64_t *p1, int p1_length, const uint64_t *p2, int p2_length, uint64_t *child);
+void packed_random_mutate(uint64_t *genome, int length, float mutation_rate);
+
+void packed_make_generation(PackedPopulation *p, PackedPopulation *next, const char *word, float mutation_rate, GenerationStats *stats);
+
+#endif
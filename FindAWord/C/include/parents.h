@@ -4,15 +4,19 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
+#include <ranking.h>
+#include <random.h>
+#include <workspace.h>
 
 /**
  * @brief Struct representing the parents selected for crossover.
  * The Parents struct contains the indices of the two parents selected for crossover.
 */
 typedef struct parents {
-    int p1; /**< Index of the first parent */
-    int p2; /**< Index of the second parent */
+    size_t p1; /**< Index of the first parent */
+    size_t p2; /**< Index of the second parent */
 } Parents;
 
 /**
@@ -23,12 +27,15 @@ typedef struct parents {
  * @param pop_size Number of individuals in the population.
  * @param optional_data Optional pointer to additional data needed by the pairing function.
  * @return Parents* Pointer to an array of Parents struct representing the pairs of
- * indices for parents in the population.
+ * indices for parents in the population, allocated with scratch_alloc.
 */
-typedef Parents* (*PairingFunction)(int *, int, void *);
+typedef Parents* (*PairingFunction)(size_t *, size_t, void *);
 
-Parents * consecutive_pairing_parents(int *selected_indices, int selected_size,  void * optional_datas);
-Parents * random_pairing_parents(int *selected_indices, int selected_size, void * optional_datas);
-Parents * non_sequential_pairing_parents(int *selected_indices, int selected_size, void * optional_datas);
+Parents * consecutive_pairing_parents(size_t *selected_indices, size_t selected_size,  void * optional_datas);
+Parents * random_pairing_parents(size_t *selected_indices, size_t selected_size, void * optional_datas);
+Parents * non_sequential_pairing_parents(size_t *selected_indices, size_t selected_size, void * optional_datas);
+Parents * assortative_pairing_parents(size_t *selected_indices, size_t selected_size, void * optional_datas);
+Parents * disassortative_pairing_parents(size_t *selected_indices, size_t selected_size, void * optional_datas);
+void shuffle_indices(size_t *indices, size_t size);
 
 #endif
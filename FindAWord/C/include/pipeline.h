@@ -0,0 +1,114 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+
+#include <population.h>
+#include <workspace.h>
+
+// Number of consecutive slots of a generation bred, scored and published at once by a thread
+#define PIPELINE_BLOCK 64
+// Proportion of the population kept as elites, as the truncation elitism of make_generation
+#define PIPELINE_ELITISM_RATE 0.4f
+// Proportion of the population selected for mating by tournament, as the selection rate of make_generation
+#define PIPELINE_SELECTION_RATE 0.4f
+
+/**
+ * @brief Selection state of one thread of a pipeline, filled from the blocks the thread publishes.
+*/
+typedef struct pipeline_thread {
+    struct pipeline *pipeline;  /**< The pipeline of the thread. */
+    int index;                  /**< The index of the thread, 0 for the thread calling pipeline_generation. */
+    pthread_t thread;           /**< The thread, unused for the thread 0. */
+    Workspace *workspace;       /**< The workspace of the crossover and mutation functions of the thread. */
+    uint64_t *best;             /**< Max-heap of the keys of the best individuals of the blocks of the thread, sorted once they are all published. */
+    size_t best_count;          /**< The number of keys of the heap. */
+    double sum;                 /**< Sum of the scores of the blocks of the thread. */
+    double sum_squares;         /**< Sum of the squared scores of the blocks of the thread. */
+    size_t evaluations;         /**< The number of fitness function calls of the thread. */
+    size_t allocations;         /**< The allocations of the thread in the generation, see scratch_allocations. */
+    Diversity *diversity;       /**< The gene histograms of the blocks of the thread, NULL without diversity model. */
+    int claimed;                /**< 1 if an individual of the blocks of the thread was claimed as the winner of the stop signal. */
+} PipelineThread;
+
+/**
+ * @brief Generation engine overlapping the selection of a generation with its breeding on several threads.
+ * make_generation runs its phases one after the other: the population is evaluated, ranked, then selected,
+ * paired and bred. A pipeline runs them in one parallel pass per generation: the threads take the blocks of
+ * PIPELINE_BLOCK slots of the new generation one after the other, write the elites, the children and the random
+ * individuals of a block, score them and publish the block to the selection of the next generation before
+ * taking the next block. A published block goes into the top-k heap of its thread, so when the last block is
+ * published the best individuals are already ranked in the heaps of the threads, and the pass ends with their
+ * merge instead of a sort of the population. The selection is the truncation elitism and the tournament
+ * selection of make_generation. The winner of a tournament of tournament_size random contestants is the
+ * individual of rank r with a probability of (1 - r / size)^t - (1 - (r + 1) / size)^t, so its rank is drawn by
+ * inverting this distribution, as rank_based_selection does, and is always below ranked_size: the top-k heaps
+ * hold every elite and every possible winner. The ranks do not depend on the scores, so they are drawn by the
+ * blocks of the generation as it is bred, and the winners are read from the merged heaps. The pairing, crossover and mutation functions are the operators
+ * of parents.c, crossover.c and mutation.c, the crossover and mutation functions are called from every thread.
+ * Each block draws from a random generator seeded from the seed, the generation and the block, so a search
+ * does not depend on the number of threads nor on the order the threads take the blocks.
+ * The genomes of a generation are stored in one buffer, max_individual_size + 1 genes per individual, and
+ * the individuals are bred from the previous buffer into the other one. With a diversity model, each thread
+ * counts the individuals of its blocks in a model of its own, merged into the model of the pipeline once the
+ * generation is published. With a stop signal, the threads check it before taking a block: once a stop is
+ * requested, by a winner of a block or by another thread, they take no more blocks, and the generation being
+ * bred is dropped.
+*/
+typedef struct pipeline {
+    Population populations[2];  /**< The current generation and the generation being bred, with their individuals. */
+    Gene *genomes[2];           /**< The genomes of the individuals of each population. */
+    float *scores[2];           /**< The scores of the individuals of each population. */
+    uint64_t *keys[2];          /**< The ranking key of each individual of each population, see pipeline_key. */
+    int current;                /**< The index of the current generation in the arrays above. */
+    size_t size;                /**< The number of individuals. */
+    size_t stride;              /**< The number of genes between two genomes of a buffer. */
+    size_t block_count;         /**< The number of blocks of a generation. */
+    size_t elite_size;          /**< The number of elites of a generation. */
+    size_t selected_size;       /**< The number of tournaments of a generation. */
+    size_t tournament_size;     /**< The number of contestants of a tournament, as in tournament_selection. */
+    size_t ranked_size;         /**< The number of best individuals ranked, the elites and the possible winners of a tournament. */
+    size_t *order;              /**< The indices of the ranked_size best individuals of the current generation, best first. */
+    size_t *winner_ranks;       /**< The ranks of the winners of the tournaments, drawn by the blocks of the generation being bred. */
+    size_t *winners;            /**< The winners of the tournaments of the current generation. */
+    Parents *parents;           /**< The pairs of winners bred into the generation being bred. */
+    size_t parents_size;        /**< The number of pairs. */
+    atomic_size_t next_block;   /**< The next block of the generation to breed. */
+    int initial;                /**< 1 while the first generation is scored, its individuals are already in place. */
+    const char *word;           /**< The target word. */
+    uint64_t seed;              /**< The seed of the random generators of the blocks. */
+    FitnessFunction fitness_function;       /**< The fitness function. */
+    void *fitness_optional_datas;           /**< Optional data of the fitness function. */
+    PairingFunction pairing_function;       /**< The pairing function. */
+    void *pairing_optional_datas;           /**< Optional data of the pairing function. */
+    CrossoverFunction crossover_function;   /**< The crossover function. */
+    void *crossover_optional_datas;         /**< Optional data of the crossover function. */
+    MutationFunction mutation_function;     /**< The mutation function. */
+    void *mutation_optional_datas;          /**< Optional data of the mutation function. */
+    Diversity *diversity;       /**< The gene histograms of the current generation, owned by the caller, NULL to disable. */
+    StopSignal *stop;           /**< The stop signal, owned by the caller, NULL to breed every block. */
+    int thread_count;           /**< The number of threads, the thread calling pipeline_generation included. */
+    PipelineThread *threads;    /**< The threads, thread_count of them. */
+    int running;                /**< The number of threads started, the thread 0 excluded. */
+    size_t round;               /**< The number of generations the threads were released for. */
+    int pending;                /**< The number of started threads still working on the generation. */
+    int closed;                 /**< 1 once the pipeline is freed, the threads exit instead of waiting for a generation. */
+    pthread_mutex_t lock;       /**< Protects round, pending and closed. */
+    pthread_cond_t released;    /**< Signaled when a generation starts or when the pipeline is closed. */
+    pthread_cond_t finished;    /**< Signaled when the last started thread is done with a generation. */
+} Pipeline;
+
+Pipeline *create_pipeline(Population p, const char *word, int thread_count, uint64_t seed,\
+                          FitnessFunction fitness_function, void *fitness_optional_datas, SelectionFunction selection_function,\
+                          PairingFunction pairing_function, void *pairing_optional_datas,\
+                          CrossoverFunction crossover_function, void *crossover_optional_datas,\
+                          MutationFunction mutation_function, void *mutation_optional_datas);
+Population pipeline_generation(Pipeline *pipeline, GenerationStats *stats);
+Population pipeline_population(const Pipeline *pipeline);
+void free_pipeline(Pipeline *pipeline);
+
+#endif
@@ -1,12 +1,20 @@
 #ifndef POPULATION_H
 #define POPULATION_H
 
+#include <time.h>
 #include <individual.h>
 #include <fitness.h>
 #include <parents.h>
 #include <crossover.h>
 #include <mutation.h>
 #include <selection.h>
+#include <ranking.h>
+#include <dedup.h>
+#include <diversity.h>
+#include <stop.h>
+#include <score_cache.h>
+#include <generation_variants.h>
+#include <probes.h>
 
 #ifndef POP_STRUCT
 #define POP_STRUCT
@@ -15,19 +23,128 @@
 */
 typedef struct population{
     Individual *individuals;    /**< An array of individuals in the population. */
-    int size;                   /**< The number of individuals in the population. */
+    size_t size;                /**< The number of individuals in the population. */
     int min_individual_size;    /**< The minimum size an individual can have. */
     int max_individual_size;    /**< The maximum size an individual can have. */
     int generation;             /**< The current generation of the population. */
+    struct dedup_table *dedup;  /**< Optional hash set of the genomes removing or sharing duplicates, NULL to disable. */
+    struct diversity *diversity;    /**< Optional gene histograms of the individuals, NULL to disable. */
+    struct genome_arena *arena;     /**< Optional arena holding the genomes, NULL to allocate them with malloc. */
+    struct stop_signal *stop;       /**< Optional early termination signal, shared between threads, NULL to disable. */
+    struct workspace *workspace;    /**< Optional workspace holding the buffers of the generations, NULL to allocate them with malloc. */
+    struct score_cache *score_cache;    /**< Optional scores computed while the population was bred, NULL to evaluate every generation. */
 } Population;
 #endif
 
-Population create_population(int size, int min_size_individual, int max_size_individual);
+/**
+ * @brief The phases of make_generation, in the order they run.
+*/
+typedef enum generation_phase {
+    PHASE_DEDUP,        /**< Search of the duplicates of the population, when it has a dedup table. */
+    PHASE_FITNESS,      /**< Evaluation of the population with the fitness function. */
+    PHASE_RANKING,      /**< Sort of the scores and score statistics. */
+    PHASE_SELECTION,    /**< Elitism selection and selection function. */
+    PHASE_ELITISM,      /**< Move of the elites into the new generation, a copy with a genome arena. */
+    PHASE_PAIRING,      /**< Pairing function. */
+    PHASE_BREEDING,     /**< Crossover and mutation functions, each child written in the new generation and, with a score cache, scored. */
+    PHASE_REFILL,       /**< Random individuals filling the new generation. */
+    PHASE_COUNT         /**< The number of phases. */
+} GenerationPhase;
+
+/**
+ * @brief Statistics of one generation, filled by make_generation.
+ * The scores describe the evaluated population. The caller can set a reporting fitness function, which is
+ * computed for the best individual only, to follow the run with a fitness which does not change between generations.
+*/
+typedef struct generation_stats {
+    FitnessFunction reporting_function;     /**< Optional fitness function computed for the best individual, set by the caller. */
+    void *reporting_optional_datas;         /**< Optional data to be passed to the reporting function, set by the caller. */
+    int64_t best_index;                     /**< Index of the best individual in the new generation, -1 if it was not kept. */
+    float best_score;                       /**< Score of the best individual. */
+    float mean_score;                       /**< Mean score of the population. */
+    float variance_score;                   /**< Variance of the scores of the population. */
+    float reporting_score;                  /**< Score of the best individual with the reporting function, -1 without reporting function. */
+    size_t evaluations;                     /**< The number of fitness function calls. */
+    float duplicate_ratio;                  /**< Ratio of duplicates found in the population, 0 without dedup table. */
+    float entropy;                          /**< Mean positional entropy of the new generation, 0 without diversity model. */
+    float consensus_distance;               /**< Mean distance of the new generation to its consensus, 0 without diversity model. */
+    int exact_match;                        /**< 1 if the best individual is equal to the word, 0 otherwise. */
+    int stopped;                            /**< 1 if the stop signal of the population stopped the generation, which returned the evaluated population. */
+    size_t allocations;                     /**< The number of allocations which grew the workspace or called malloc, see scratch_allocations. */
+    double phase_time[PHASE_COUNT];         /**< Elapsed time of each phase in seconds, from the profile ticks of -DGA_PROFILE only. */
+} GenerationStats;
+
+/**
+ * @brief Returns the current time of the monotonic clock in seconds.
+ * @return The current time in seconds.
+*/
+static inline double now_seconds(){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Each phase boundary fires the phase probe, a nop until a tracer attaches, which times the phases from the
+// timestamps of the probes. The clock is only read with -DGA_PROFILE (make profile): phase_time is then the sum
+// of the ticks counted by the PROFILE_LAP of the phase, which comes just before its PHASE_END.
+#ifdef GA_PROFILE
+/**
+ * @brief Adds the ticks profiled since *start to a phase of the generation statistics.
+ * @param stats The generation statistics.
+ * @param phase The phase which just ended.
+ * @param start The profiled ticks at the start of the phase, updated to the current ones.
+*/
+static inline void end_phase(GenerationStats *stats, GenerationPhase phase, uint64_t *start){
+    stats->phase_time[phase] += profile_seconds(generation_profile.total_ticks - *start);
+    *start = generation_profile.total_ticks;
+}
+
+// Declares the start of the first phase, in profiled ticks
+#define PHASE_START(start) uint64_t start = generation_profile.total_ticks
+// Ends a phase, see end_phase, and starts the next one
+#define PHASE_END(stats, ended, start) do {\
+    GA_PROBE1(phase, ended);\
+    end_phase(stats, ended, &(start));\
+} while (0)
+#else
+#define PHASE_START(start)
+#define PHASE_END(stats, ended, start) GA_PROBE1(phase, ended)
+#endif
+
+Population create_population(size_t size, int min_size_individual, int max_size_individual);
 Population make_generation(Population p, const char * word, FitnessFunction fitness_function, void *fitness_optional_datas, \
                             SelectionFunction selection_function, void *selection_optional_datas,\
                             PairingFunction pairing_function, void * pairing_optional_datas,\
                             CrossoverFunction crossover_function, void * crossover_optional_datas,\
-                            MutationFunction mutation_function, void * mutation_optional_datas);
+                            MutationFunction mutation_function, void * mutation_optional_datas,\
+                            Ranking *ranking, GenerationStats *stats);
+Population make_generation_int(Population p, const char * word, DistanceFunction distance_function, void *distance_optional_datas, \
+                            SelectionFunction selection_function, void *selection_optional_datas,\
+                            PairingFunction pairing_function, void * pairing_optional_datas,\
+                            CrossoverFunction crossover_function, void * crossover_optional_datas,\
+                            MutationFunction mutation_function, void * mutation_optional_datas,\
+                            Ranking *ranking, GenerationStats *stats);
 void free_population(Population p);
+void reset_generation_stats(GenerationStats *stats);
+
+/**
+ * @brief Function pointer type of a generation variant, make_generation specialized for a fixed set of operators.
+ * @param p The population to generate the new generation from.
+ * @param word The target word to evolve towards.
+ * @param ranking The ranking of the evaluated population, or NULL.
+ * @param stats The statistics of the generation, or NULL.
+ * @return The new generation of individuals.
+*/
+typedef Population (*GenerationFunction)(Population, const char *, Ranking *, GenerationStats *);
+
+#define DECLARE_GENERATION_VARIANT(name, fitness, fitness_datas, selection, selection_datas, pairing, pairing_datas,\
+                                   crossover, crossover_datas, mutation, mutation_datas)\
+    Population make_generation_##name(Population p, const char * word, Ranking *ranking, GenerationStats *stats);
+
+GENERATION_VARIANTS(DECLARE_GENERATION_VARIANT)
+
+GenerationFunction find_generation_variant(FitnessFunction fitness_function, SelectionFunction selection_function,\
+                                           PairingFunction pairing_function, CrossoverFunction crossover_function,\
+                                           MutationFunction mutation_function);
 
 #endif
@@ -0,0 +1,65 @@
+#ifndef PROBES_H
+#define PROBES_H
+// Static tracepoints (USDT) of the provider find_a_word, for perf, bpftrace or SystemTap :
+//   generation_start(generation, population_size)
+//   generation_end(generation, evaluations, exact_match)
+//   phase(phase)                                   phase is the GenerationPhase which just ended
+//   exact_match(generation, index, genome)         genome is a char pointer
+//   crossover(parent1_size, parent2_size, child_size)
+//   mutation(size_before, size_after)
+// A probe is a single nop until a tracer attaches to it. The probes use sys/sdt.h when it is installed,
+// else the notes are emitted by the fallback below on x86-64 ELF targets, and -DGA_NO_PROBES removes them.
+#include <stdint.h>
+
+#if defined(GA_NO_PROBES)
+#define GA_PROBE_ENABLED 0
+#elif defined(__has_include) && __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define GA_PROBE_ENABLED 1
+#define GA_PROBE1(name, a) DTRACE_PROBE1(find_a_word, name, a)
+#define GA_PROBE2(name, a, b) DTRACE_PROBE2(find_a_word, name, a, b)
+#define GA_PROBE3(name, a, b, c) DTRACE_PROBE3(find_a_word, name, a, b, c)
+#elif defined(__ELF__) && defined(__x86_64__)
+#define GA_PROBE_ENABLED 1
+// A nop at the probe site and a stapsdt note with its address, the provider, the name of the probe and the
+// location of its arguments, all 8 bytes signed. The .stapsdt.base symbol lets the tracer relocate the address.
+#define GA_PROBE_NOTE(name, arguments)\
+    "990: nop\n"\
+    ".pushsection .note.stapsdt,\"\",\"note\"\n"\
+    ".balign 4\n"\
+    ".4byte 992f-991f, 994f-993f, 3\n"\
+    "991: .asciz \"stapsdt\"\n"\
+    "992: .balign 4\n"\
+    "993: .8byte 990b\n"\
+    ".8byte _.stapsdt.base\n"\
+    ".8byte 0\n"\
+    ".asciz \"find_a_word\"\n"\
+    ".asciz \"" #name "\"\n"\
+    ".asciz \"" arguments "\"\n"\
+    "994: .balign 4\n"\
+    ".popsection\n"\
+    ".ifndef _.stapsdt.base\n"\
+    ".pushsection .stapsdt.base,\"aG\",\"progbits\",.stapsdt.base,comdat\n"\
+    ".weak _.stapsdt.base\n"\
+    ".hidden _.stapsdt.base\n"\
+    "_.stapsdt.base: .space 1\n"\
+    ".size _.stapsdt.base, 1\n"\
+    ".popsection\n"\
+    ".endif\n"
+#define GA_PROBE1(name, a) __asm__ __volatile__(GA_PROBE_NOTE(name, "-8@%0")\
+    :: "nor"((int64_t) (a)))
+#define GA_PROBE2(name, a, b) __asm__ __volatile__(GA_PROBE_NOTE(name, "-8@%0 -8@%1")\
+    :: "nor"((int64_t) (a)), "nor"((int64_t) (b)))
+#define GA_PROBE3(name, a, b, c) __asm__ __volatile__(GA_PROBE_NOTE(name, "-8@%0 -8@%1 -8@%2")\
+    :: "nor"((int64_t) (a)), "nor"((int64_t) (b)), "nor"((int64_t) (c)))
+#else
+#define GA_PROBE_ENABLED 0
+#endif
+
+#if !GA_PROBE_ENABLED
+#define GA_PROBE1(name, a) ((void) 0)
+#define GA_PROBE2(name, a, b) ((void) 0)
+#define GA_PROBE3(name, a, b, c) ((void) 0)
+#endif
+
+#endif
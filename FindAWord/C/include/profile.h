@@ -0,0 +1,92 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+// Instrumentation of the phases of make_generation, compiled only with -DGA_PROFILE (make profile).
+// Without it, the macros below expand to nothing and no profiling code or data is left.
+#ifdef GA_PROFILE
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+#include <string.h>
+#include <pthread.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/**
+ * @brief The profiled phases, finer than the GenerationPhase of the generation statistics.
+*/
+typedef enum profile_phase {
+    PROFILE_DEDUP,              /**< Search of the duplicates. */
+    PROFILE_FITNESS,            /**< Fitness function and exact match search, and scores of the children with a score cache. */
+    PROFILE_RANKING,            /**< Sort of the scores and score statistics. */
+    PROFILE_ELITE_SELECTION,    /**< Truncation selection of the elites. */
+    PROFILE_SELECTION,          /**< Selection function. */
+    PROFILE_ELITISM,            /**< Move of the elites, a copy with a genome arena. */
+    PROFILE_PAIRING,            /**< Pairing function. */
+    PROFILE_CROSSOVER,          /**< Crossover function, and crossover and mutation of the packed children. */
+    PROFILE_MUTATION,           /**< Mutation function. */
+    PROFILE_COPY,               /**< Writing of each child in the new generation. */
+    PROFILE_REFILL,             /**< Random individuals of the refill, and the individuals sampled by eda_generation. */
+    PROFILE_PIPELINE,           /**< Parallel pass of a pipeline generation: breeding, scores and top-k heaps. */
+    PROFILE_PHASE_COUNT         /**< The number of phases. */
+} ProfilePhase;
+
+/**
+ * @brief Counters accumulated over the generations run by a thread.
+*/
+typedef struct profile {
+    uint64_t ticks[PROFILE_PHASE_COUNT];    /**< Time spent in each phase, in profile_ticks units. */
+    uint64_t calls[PROFILE_PHASE_COUNT];    /**< The number of times each phase was timed. */
+    uint64_t total_ticks;                   /**< Sum of the ticks of the phases, from which the phase_time of the generation statistics are taken. */
+    uint64_t generations;                   /**< The number of generations. */
+    uint64_t evaluations;                   /**< The number of fitness function calls. */
+    uint64_t allocations;                   /**< The number of allocations of the generations. */
+    uint64_t allocated_bytes;               /**< The bytes allocated by the generations. */
+    uint64_t copied_bytes;                  /**< The bytes of genomes copied into the new generations. */
+} Profile;
+
+extern __thread Profile generation_profile;
+
+/**
+ * @brief Reads the time stamp counter, or the monotonic clock in nanoseconds without one.
+ * @return The current time in ticks.
+*/
+static inline uint64_t profile_ticks(){
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+// Declares a tick counter started now
+#define PROFILE_START(start) uint64_t start = profile_ticks()
+// Adds the ticks elapsed since start to a phase and restarts the counter
+#define PROFILE_LAP(phase, start) do {\
+    uint64_t profile_now = profile_ticks();\
+    generation_profile.ticks[phase] += profile_now - (start);\
+    generation_profile.total_ticks += profile_now - (start);\
+    generation_profile.calls[phase]++;\
+    (start) = profile_now;\
+} while (0)
+// Adds to a counter of the profile
+#define PROFILE_ADD(counter, n) (generation_profile.counter += (n))
+// Ends a generation of the profile, with the statistics of the generation
+#define PROFILE_GENERATION(stats) end_profile_generation((stats)->evaluations)
+
+void set_profile_output(FILE *output, uint64_t interval);
+void end_profile_generation(size_t evaluations);
+void write_profile(FILE *output, const Profile *profile);
+double profile_seconds(uint64_t ticks);
+void reset_profile();
+
+#else
+#define PROFILE_START(start)
+#define PROFILE_LAP(phase, start)
+#define PROFILE_ADD(counter, n)
+#define PROFILE_GENERATION(stats)
+#endif
+
+#endif
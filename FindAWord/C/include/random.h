@@ -0,0 +1,38 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+#include <stdlib.h>
+#include <stdint.h>
+
+// State of the random generator of the current thread
+extern __thread uint64_t random_state;
+
+void seed_random(uint64_t seed);
+
+/**
+ * @brief Draws a random integer in [0, RAND_MAX], as rand() does.
+ * The generator is a xorshift64* with one state per thread, so the threads solving different words
+ * neither share a lock nor a sequence, and a seeded thread draws the same sequence on every run.
+ * @return A random integer.
+*/
+static inline int random_int(){
+    uint64_t x = random_state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    random_state = x;
+    return (int) (((x * 0x2545F4914F6CDD1DULL) >> 33) & RAND_MAX);
+}
+
+/**
+ * @brief Draws a random index in [0, size[.
+ * random_int() only covers [0, RAND_MAX], so two draws are combined for populations larger than RAND_MAX.
+ * @param size The number of indices, not 0.
+ * @return A random index.
+*/
+static inline size_t random_index(size_t size){
+    if (size <= (size_t) RAND_MAX)
+        return (size_t) random_int() % size;
+    return (((uint64_t) random_int() << 31) ^ (uint64_t) random_int()) % size;
+}
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef RANKING_H
+#define RANKING_H
+#include <stdlib.h>
+#include <string.h>
+
+// Digit size used by the radix sort of integer scores
+#define RADIX_BITS 8
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+#define RADIX_MASK (RADIX_BUCKETS - 1)
+
+/**
+ * @brief Structure representing an individual's index and its corresponding score
+*/
+typedef struct {
+    size_t idx;     /**< Index of the individual in the population */
+    float score;    /**< Score of the individual */
+} IndividualScore;
+
+/**
+ * @brief Ranking of a population for one generation.
+ * The ranking is computed once per generation by make_generation and shared by the elitism,
+ * the selection function and the caller. Its buffers are allocated once by create_ranking
+ * and reused from one generation to the next. Lower scores are better.
+*/
+typedef struct ranking {
+    float *scores;      /**< Fitness score of each individual. */
+    size_t *order;      /**< Indices of the individuals sorted from the best to the worst score. */
+    size_t *ranks;      /**< Rank of each individual, the inverse permutation of order. */
+    IndividualScore *entries;   /**< Scratch buffer used to sort the scores. */
+    size_t size;        /**< The number of ranked individuals. */
+    size_t capacity;    /**< The number of individuals the buffers can hold. */
+    size_t best_index;  /**< Index of the best individual, order[0]. */
+    float best_score;   /**< Score of the best individual. */
+    float mean_score;   /**< Mean score of the population. */
+} Ranking;
+
+int score_cmp(const void* a, const void* b);
+size_t* radix_sort_indices(const int *keys, size_t size);
+
+Ranking create_ranking(size_t capacity);
+int reserve_ranking(Ranking *ranking, size_t size);
+int rank_scores(Ranking *ranking, size_t size);
+int rank_distances(Ranking *ranking, const int *distances, size_t size);
+void free_ranking(Ranking ranking);
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef SCORE_CACHE_H
+#define SCORE_CACHE_H
+#include <stdlib.h>
+#include <string.h>
+
+#include <fitness.h>
+
+/**
+ * @brief Scores of a population computed while it was bred, reused by its evaluation.
+ * The cache is attached to a population (Population.score_cache) and reused from one generation to the next.
+ * make_generation scores each child right after its crossover and mutation, while its genome is still in the
+ * cache of the processor, and writes it with its score straight into its slot of the new generation. The
+ * elites keep the scores they were ranked with and the random individuals are scored as they are created.
+ * The next generation takes these scores instead of evaluating its population again when it has the same
+ * fitness function, optional data and word, so the searches which keep their fitness function evaluate each
+ * individual once, as it is born. A generation with another fitness function evaluates its population as
+ * without cache, unless the caller gave it in next_fitness_function before the previous generation was bred.
+ * A fixed-length population with the modified Hamming or Manhattan fitness is scored through its column-major
+ * layout once it is bred, the elites excluded, instead of child by child.
+*/
+typedef struct score_cache {
+    float *scores;                      /**< The scores of the population of generation, when valid. */
+    float *next_scores;                 /**< The scores of the generation being bred. */
+    size_t capacity;                    /**< The number of scores the arrays can hold. */
+    int valid;                          /**< 1 if scores holds the scores of the population of generation. */
+    int generation;                     /**< The generation of the population scored. */
+    size_t size;                        /**< The number of individuals scored. */
+    FitnessFunction fitness_function;   /**< The fitness function of the scores. */
+    void *fitness_optional_datas;       /**< The optional data of the fitness function. */
+    const char *word;                   /**< The target word of the scores. */
+    FitnessFunction next_fitness_function;  /**< The fitness function of the next generation, set by the caller when it changes it, NULL to keep the one of the generation. */
+} ScoreCache;
+
+ScoreCache *create_score_cache();
+void free_score_cache(ScoreCache *cache);
+int reserve_score_cache(ScoreCache *cache, size_t size);
+
+#endif
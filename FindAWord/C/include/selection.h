@@ -3,7 +3,10 @@
 #define SELECTION_H
 #include <string.h>
 #include <stdlib.h>
+#include <math.h>
 #include <individual.h>
+#include <ranking.h>
+#include <random.h>
 
 #ifndef POP_STRUCT
 #define POP_STRUCT
@@ -12,42 +15,38 @@
 */
 typedef struct population{
     Individual *individuals;    /**< An array of individuals in the population. */
-    int size;                   /**< The number of individuals in the population. */
+    size_t size;                /**< The number of individuals in the population. */
     int min_individual_size;    /**< The minimum size an individual can have. */
     int max_individual_size;    /**< The maximum size an individual can have. */
     int generation;             /**< The current generation of the population. */
+    struct dedup_table *dedup;  /**< Optional hash set of the genomes removing or sharing duplicates, NULL to disable. */
+    struct diversity *diversity;    /**< Optional gene histograms of the individuals, NULL to disable. */
+    struct genome_arena *arena;     /**< Optional arena holding the genomes, NULL to allocate them with malloc. */
+    struct stop_signal *stop;       /**< Optional early termination signal, shared between threads, NULL to disable. */
+    struct workspace *workspace;    /**< Optional workspace holding the buffers of the generations, NULL to allocate them with malloc. */
+    struct score_cache *score_cache;    /**< Optional scores computed while the population was bred, NULL to evaluate every generation. */
 } Population;
 #endif
 
+
 // Define a small value to prevent division by zero
 #define EPSILON 0.000001f
 
 /**
  * @brief A function pointer type definition for a selection function.
- * This function takes in a population, an array of fitness scores, a selection pressure value, and optional data.
+ * This function takes in a population, the ranking of its fitness scores, a selection pressure value, and optional data.
  * It returns an array of indices of the selected individuals from the population for mating.
  * @param population The population to select from.
- * @param fitness_scores An array of fitness scores for the individuals in the population.
+ * @param ranking The ranking of the population, computed once per generation by make_generation.
  * @param selection_rate A value indicating how much pressure to apply for selecting fitter individuals.
  * @param optional_data Optional data that may be needed by the selection function.
- * @return An array of indices of selected individuals from the population for mating.
-*/
-typedef int* (*SelectionFunction)(Population, float *, float, void *);
-
-/**
- * @brief Structure representing an individual's index and its corresponding score
+ * @return An array of indices of selected individuals from the population for mating, allocated with scratch_alloc.
 */
-typedef struct {
-    int idx;        /**< Index of the individual in the population */
-    float score;    /**< Score of the individual */
-} IndividualScore;
-
-int score_cmp(const void* a, const void* b);
-
+typedef size_t* (*SelectionFunction)(Population, Ranking *, float, void *);
 
-int* truncation_selection(Population p, float * fitness_scores, float selection_rate, void *optional_datas);
-int *rank_based_selection(Population p, float * fitness_scores, float selection_rate, void *optional_datas);
-int* roulette_wheel_selection(Population p, float * fitness_scores, float selection_rate, void *optional_datas);
-int* tournament_selection(Population p, float * fitness_scores, float selection_rate, void *optional_datas);
+size_t* truncation_selection(Population p, Ranking * ranking, float selection_rate, void *optional_datas);
+size_t* rank_based_selection(Population p, Ranking * ranking, float selection_rate, void *optional_datas);
+size_t* roulette_wheel_selection(Population p, Ranking * ranking, float selection_rate, void *optional_datas);
+size_t* tournament_selection(Population p, Ranking * ranking, float selection_rate, void *optional_datas);
 
 #endif
\ No newline at end of file
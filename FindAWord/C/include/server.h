@@ -0,0 +1,50 @@
+#ifndef SERVER_H
+#define SERVER_H
+#define _GNU_SOURCE
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include <jobs.h>
+
+// Longest request line, longer lines are answered with an error and skipped
+#define SERVER_LINE_MAX 4096
+// Timeout of poll in milliseconds, the delay before a shutdown signal is seen
+#define SERVER_POLL_TIMEOUT 200
+// Largest population of a request, the resources of a worker keep the size of its largest job
+#define SERVER_MAX_POPULATION 65536
+// Smallest population of a request, the tournaments of tournament_selection have size / 4 contestants
+#define SERVER_MIN_POPULATION 4
+
+/**
+ * @brief A solve request in flight, from its submission to its answer.
+*/
+typedef struct request {
+    char *id;                       /**< The identifier given by the client, echoed in the answer. */
+    StopSignal *stop;               /**< The stop signal of the job, raised by CANCEL. */
+    struct connection *connection;  /**< The connection the answer is written to. */
+    struct request *next;           /**< The next request in flight on the connection. */
+} Request;
+
+/**
+ * @brief A client connection.
+ * The connection is shared by the server thread, which reads the requests, and the worker threads,
+ * which write the answers. It is freed when the client is gone and its last request answered.
+*/
+typedef struct connection {
+    int fd;                         /**< The socket, closed when the connection is freed. */
+    pthread_mutex_t lock;           /**< Lock of the writes, of the requests and of the reference count. */
+    int references;                 /**< 1 for the server thread while the client is connected, plus 1 per request in flight. */
+    int closed;                     /**< 1 once the client is gone, the answers are then dropped. */
+    Request *requests;              /**< The requests in flight. */
+    char buffer[SERVER_LINE_MAX];   /**< The bytes read and not yet parsed. */
+    size_t used;                    /**< The number of bytes in the buffer. */
+    int skipping;                   /**< 1 while skipping the rest of a too long line. */
+} Connection;
+
+int run_server(const char *socket_path, int worker_count, const JobConfig *defaults);
+
+#endif
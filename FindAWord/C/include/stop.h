@@ -0,0 +1,54 @@
+#ifndef STOP_H
+#define STOP_H
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <selection.h>
+
+// Number of individuals evaluated between two checks of a stop requested by another thread
+#define STOP_CHECK_INTERVAL 64
+
+/**
+ * @brief Early termination signal, shared by the populations evolved towards the same word.
+ * make_generation stops as soon as an individual is the word or reaches the threshold, without running
+ * the phases after the fitness phase, and the populations of the other threads sharing the signal stop
+ * their fitness phase at their next check. The first winner is copied in the signal.
+*/
+typedef struct stop_signal {
+    atomic_int stopped;     /**< 1 once a stop is requested. */
+    atomic_int claimed;     /**< 1 once a winner is claimed. */
+    float threshold;        /**< Score at or below which an individual wins, negative to stop on the word only. */
+    char *winner;           /**< Copy of the genome of the winner, NULL until a winner is claimed. */
+    float winner_score;     /**< Score of the winner. */
+} StopSignal;
+
+StopSignal *create_stop_signal(float threshold);
+void free_stop_signal(StopSignal *stop);
+void reset_stop_signal(StopSignal *stop);
+void request_stop(StopSignal *stop);
+int claim_stop(StopSignal *stop, const char *genome, float score);
+
+/**
+ * @brief Checks whether a stop was requested, by a winner or by the caller.
+ * @param stop The stop signal.
+ * @return 1 if a stop was requested, 0 otherwise.
+*/
+static inline int stop_requested(StopSignal *stop){
+    return atomic_load_explicit(&stop->stopped, memory_order_acquire);
+}
+
+/**
+ * @brief Checks whether an evaluated individual wins.
+ * @param stop The stop signal.
+ * @param genome The genome of the individual.
+ * @param score The score of the individual.
+ * @param word The target word.
+ * @return 1 if the individual is the word or its score reaches the threshold, 0 otherwise.
+*/
+static inline int is_winner(const StopSignal *stop, const char *genome, float score, const char *word){
+    // The float fitness functions may not return exactly 0 on a match
+    return score <= stop->threshold || (score <= EPSILON && strcmp(genome, word) == 0);
+}
+
+#endif
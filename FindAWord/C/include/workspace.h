@@ -0,0 +1,70 @@
+#ifndef WORKSPACE_H
+#define WORKSPACE_H
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+// Number of size classes of a workspace, the blocks of class c are WORKSPACE_MIN_BLOCK << c bytes
+#define WORKSPACE_CLASSES 40
+// Smallest block of a workspace, header included
+#define WORKSPACE_MIN_BLOCK 32
+// Header of a block, it keeps the alignment of malloc
+#define WORKSPACE_HEADER 16
+// Bytes reserved for the buffers of one individual besides its genomes: individual arrays, indices, parents and scores
+#define WORKSPACE_INDIVIDUAL_BYTES 256
+// Bytes reserved whatever the size of the population
+#define WORKSPACE_MIN_RESERVE (1 << 20)
+
+/**
+ * @brief Header of a block, just before the memory returned by scratch_alloc.
+ * An allocation which fell back to malloc has the header too, without workspace, so scratch_free finds
+ * where a block goes back from its header alone.
+*/
+typedef struct scratch_block {
+    size_t size_class;                  /**< The size class of the block, WORKSPACE_CLASSES for a block of malloc. */
+    union {
+        struct workspace *owner;        /**< The workspace of the block while it is used, NULL for a block of malloc. */
+        struct scratch_block *next;     /**< The next free block of the class, when the block is free. */
+    };
+} ScratchBlock;
+
+/**
+ * @brief Scratch memory of the generations of a population, outside of the malloc heap.
+ * The buffers a generation allocates and frees (individual arrays, selected indices, parents, children and
+ * their genomes, selection and fitness scratch buffers) are blocks of power of two size classes carved from
+ * a region reserved once from the size of the population. A freed block goes to the free list of its class
+ * and is reused by the next allocation of the class, so once every class has reached the peak of a generation
+ * a steady-state generation allocates nothing. The genomes and the smaller buffers share the smallest class
+ * used, sized for the longest genome, so the lengths of the genomes changing from one generation to the next
+ * do not move blocks between classes. Allocations which do not fit in the region fall back to malloc.
+ * A workspace is used by one thread at a time. A block records its workspace in its header, so a block freed
+ * while another workspace is the current one goes back to its own workspace instead of free.
+*/
+typedef struct workspace {
+    char *base;                                 /**< The reserved region. */
+    size_t size;                                /**< The size of the region in bytes. */
+    size_t used;                                /**< The number of bytes carved from the region. */
+    ScratchBlock *free_blocks[WORKSPACE_CLASSES];   /**< The free blocks of each size class. */
+    size_t min_class;                           /**< The size class of the allocations of a genome or smaller. */
+    struct column_population *columns;          /**< Column-major copy of a fixed-length population, NULL until it is used. */
+    size_t generations;                         /**< The number of generations run with the workspace. */
+    size_t strict_after;                        /**< Generations after which an allocation aborts the program, 0 to disable. */
+} Workspace;
+
+Workspace *create_workspace(size_t population_size, int max_individual_size);
+void free_workspace(Workspace *workspace);
+Workspace *set_workspace(Workspace *workspace);
+Workspace *current_workspace();
+int in_workspace(const Workspace *workspace, const void *pointer);
+void *scratch_alloc(size_t size);
+void *scratch_calloc(size_t count, size_t size);
+void scratch_free(void *pointer);
+size_t scratch_allocations();
+void end_workspace_generation(Workspace *workspace, size_t allocations);
+
+#endif
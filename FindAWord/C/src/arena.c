@@ -0,0 +1,166 @@
+#include <arena.h>
+
+// Arena used by allocate_genome on the current thread
+static __thread GenomeArena *current_arena = NULL;
+
+/**
+ * @brief Creates a genome arena of two spaces of space_size bytes.
+ * The memory is reserved, not committed: pages are only used when genomes are written in them.
+ * With a file, the file is created (or truncated) to the size of the arena and mapped, and the kernel is
+ * told that the arena is read sequentially.
+ * @param space_size The size of a space in bytes, enough for the genomes of one generation with their terminators.
+ * It is rounded up to whole pages, so giving a space back to the system never touches the other one.
+ * @param path The backing file, or NULL for anonymous memory.
+ * @return The genome arena, or NULL on failure.
+*/
+GenomeArena *create_genome_arena(size_t space_size, const char *path){
+    GenomeArena *arena = calloc(1, sizeof(GenomeArena));
+    if (arena == NULL)
+        return NULL;
+    size_t page = (size_t) sysconf(_SC_PAGESIZE);
+    space_size = (space_size + page - 1) & ~(page - 1);
+    arena->space_size = space_size;
+    arena->fd = -1;
+    void *base;
+    if (path != NULL){
+        arena->fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0600);
+        if (arena->fd == -1 || ftruncate(arena->fd, 2 * space_size) != 0){
+            free_genome_arena(arena);
+            return NULL;
+        }
+        base = mmap(NULL, 2 * space_size, PROT_READ | PROT_WRITE, MAP_SHARED, arena->fd, 0);
+    }
+    else
+        base = mmap(NULL, 2 * space_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (base == MAP_FAILED){
+        free_genome_arena(arena);
+        return NULL;
+    }
+    arena->base = base;
+    madvise(base, 2 * space_size, MADV_SEQUENTIAL);
+    return arena;
+}
+
+/**
+ * @brief Creates an anonymous genome arena whose first space starts with genomes read from a file.
+ * The size bytes at offset in the file are mapped copy-on-write at the beginning of the first space, which
+ * is the active one, so the genomes are used where they are in the file and only the pages read are loaded.
+ * The file can be closed once the arena is created, it must not be truncated while the arena is used.
+ * @param fd The file.
+ * @param offset The offset of the genomes in the file, a multiple of the page size.
+ * @param size The number of bytes of the genomes.
+ * @param space_size The size of a space in bytes for the next generations, raised to size if it is smaller.
+ * @return The genome arena, or NULL on failure.
+*/
+GenomeArena *map_genome_arena(int fd, off_t offset, size_t size, size_t space_size){
+    GenomeArena *arena = create_genome_arena(space_size > size ? space_size : size, NULL);
+    if (arena == NULL)
+        return NULL;
+    if (size != 0 && mmap(arena->base, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, offset) == MAP_FAILED){
+        free_genome_arena(arena);
+        return NULL;
+    }
+    arena->used = size;
+    return arena;
+}
+
+/**
+ * @brief Frees a genome arena. The genomes allocated in it must no longer be used.
+ * The backing file is kept, it is removed by the caller.
+ * @param arena The genome arena, or NULL.
+*/
+void free_genome_arena(GenomeArena *arena){
+    if (arena == NULL)
+        return;
+    if (current_arena == arena)
+        current_arena = NULL;
+    if (arena->base != NULL)
+        munmap(arena->base, 2 * arena->space_size);
+    if (arena->fd != -1)
+        close(arena->fd);
+    free(arena);
+}
+
+/**
+ * @brief Sets the arena used by allocate_genome and release_genome on the current thread.
+ * @param arena The genome arena, or NULL to allocate the genomes with malloc.
+ * @return The previous arena of the thread.
+*/
+GenomeArena *set_genome_arena(GenomeArena *arena){
+    GenomeArena *previous = current_arena;
+    current_arena = arena;
+    return previous;
+}
+
+/**
+ * @brief Returns the arena used by allocate_genome and release_genome on the current thread.
+ * @return The genome arena, or NULL.
+*/
+GenomeArena *current_genome_arena(){
+    return current_arena;
+}
+
+/**
+ * @brief Allocates size bytes after the last genome of the active space.
+ * @param arena The genome arena.
+ * @param size The number of bytes.
+ * @return The allocated memory, or NULL if the active space is full.
+*/
+Gene *arena_allocate(GenomeArena *arena, size_t size){
+    if (arena->used + size > arena->space_size)
+        return NULL;
+    Gene *genome = arena->base + arena->active * arena->space_size + arena->used;
+    arena->used += size;
+    return genome;
+}
+
+/**
+ * @brief Checks whether a pointer was allocated in an arena.
+ * @param arena The genome arena.
+ * @param pointer The pointer.
+ * @return 1 if the pointer is in one of the spaces, 0 otherwise.
+*/
+int in_genome_arena(const GenomeArena *arena, const void *pointer){
+    const Gene *p = pointer;
+    return p >= arena->base && p < arena->base + 2 * arena->space_size;
+}
+
+/**
+ * @brief Switches the allocations to the other space, whose genomes are the ones of the previous generation.
+ * They must have been released. Their pages are given back to the system, and for a file the blocks are
+ * deallocated, so they are not written back to the disk.
+ * @param arena The genome arena.
+*/
+void flip_genome_arena(GenomeArena *arena){
+    arena->active ^= 1;
+    arena->used = 0;
+    Gene *space = arena->base + arena->active * arena->space_size;
+    madvise(space, arena->space_size, MADV_DONTNEED);
+    if (arena->fd != -1)
+        fallocate(arena->fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, (off_t) (arena->active * arena->space_size), arena->space_size);
+}
+
+/**
+ * @brief Empties both spaces of an arena, to reuse it for another population.
+ * The genomes of the arena must have been released. The pages are kept, so a pooled arena does not fault
+ * them in again.
+ * @param arena The genome arena.
+*/
+void reset_genome_arena(GenomeArena *arena){
+    arena->active = 0;
+    arena->used = 0;
+}
+
+/**
+ * @brief Asks the kernel to read the genomes between two genomes of an arena ahead of their use.
+ * @param arena The genome arena.
+ * @param first The first genome.
+ * @param last The last genome, allocated after the first one.
+*/
+void prefetch_genomes(const GenomeArena *arena, const Gene *first, const Gene *last){
+    if (!in_genome_arena(arena, first) || !in_genome_arena(arena, last) || last < first)
+        return;
+    size_t page = (size_t) sysconf(_SC_PAGESIZE);
+    uintptr_t start = (uintptr_t) first & ~(page - 1);
+    madvise((void *) start, (uintptr_t) last - start + 1, MADV_WILLNEED);
+}
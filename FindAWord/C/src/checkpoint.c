@@ -0,0 +1,396 @@
+#include <checkpoint.h>
+
+/**
+ * @brief Copies the name of an operator of a table in a field of the header, or an empty name if it is not in the table.
+*/
+#define NAME_OPERATOR(table, count, operator, field)\
+    do {\
+        (field)[0] = '\0';\
+        for (int k = 0; k < (count); k++)\
+            if ((table)[k].function == (operator)){\
+                strncpy((field), (table)[k].name, CHECKPOINT_NAME - 1);\
+                break;\
+            }\
+    } while (0)
+
+/**
+ * @brief Rounds an offset up to a multiple of an alignment.
+ * @param offset The offset.
+ * @param alignment The alignment, a power of two.
+ * @return The aligned offset.
+*/
+static inline uint64_t align_offset(uint64_t offset, uint64_t alignment){
+    return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+/**
+ * @brief Copies a population, the random state of the thread and the configuration of the search in a checkpoint buffer.
+ * The buffers only grow, so a buffer reused for the checkpoints of a population is allocated once.
+ * @param buffer The checkpoint buffer, zeroed before its first use.
+ * @param p The population.
+ * @param word The target word, of at most JOB_MAX_WORD characters.
+ * @param config The parameters of the search, or NULL.
+ * @return 0 on success, -1 if the word is too long or if the allocation failed.
+*/
+int fill_checkpoint(CheckpointBuffer *buffer, Population p, const char *word, const JobConfig *config){
+    size_t word_length = strlen(word);
+    if (word_length > JOB_MAX_WORD)
+        return -1;
+    size_t genomes_size = 0;
+    for (size_t i = 0; i < p.size; i++)
+        genomes_size += p.individuals[i].size + 1;
+    if (p.size > buffer->lengths_capacity){
+        uint32_t *lengths = realloc(buffer->lengths, sizeof(uint32_t) * p.size);
+        if (lengths == NULL)
+            return -1;
+        buffer->lengths = lengths;
+        buffer->lengths_capacity = p.size;
+    }
+    if (genomes_size > buffer->genomes_capacity){
+        Gene *genomes = realloc(buffer->genomes, genomes_size);
+        if (genomes == NULL)
+            return -1;
+        buffer->genomes = genomes;
+        buffer->genomes_capacity = genomes_size;
+    }
+    Gene *genome = buffer->genomes;
+    for (size_t i = 0; i < p.size; i++){
+        buffer->lengths[i] = p.individuals[i].size;
+        memcpy(genome, p.individuals[i].genome, p.individuals[i].size);
+        genome[p.individuals[i].size] = '\0';
+        genome += p.individuals[i].size + 1;
+    }
+
+    CheckpointHeader *header = &buffer->header;
+    memset(header, 0, sizeof(CheckpointHeader));
+    memcpy(header->magic, CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+    header->version = CHECKPOINT_VERSION;
+    header->byte_order = CHECKPOINT_BYTE_ORDER;
+    header->header_size = sizeof(CheckpointHeader);
+    header->generation = p.generation;
+    header->size = p.size;
+    header->min_individual_size = p.min_individual_size;
+    header->max_individual_size = p.max_individual_size;
+    header->random_state = random_state;
+    header->lengths_offset = align_offset(sizeof(CheckpointHeader), sizeof(uint64_t));
+    header->genomes_offset = align_offset(header->lengths_offset + sizeof(uint32_t) * p.size, CHECKPOINT_ALIGNMENT);
+    header->genomes_size = genomes_size;
+    header->word_length = word_length;
+    memcpy(header->word, word, word_length);
+    if (config != NULL){
+        header->seed = config->seed;
+        header->max_generations = config->max_generations;
+        header->fixed_length = config->fixed_length;
+        header->random_operators = config->random_operators;
+        NAME_OPERATOR(fitness_functions, FITNESS_FUNCTION_COUNT, config->fitness_function, header->fitness);
+        NAME_OPERATOR(selection_functions, SELECTION_FUNCTION_COUNT, config->selection_function, header->selection);
+        NAME_OPERATOR(pairing_functions, PAIRING_FUNCTION_COUNT, config->pairing_function, header->pairing);
+        NAME_OPERATOR(crossover_functions, CROSSOVER_FUNCTION_COUNT, config->crossover_function, header->crossover);
+        NAME_OPERATOR(mutation_functions, MUTATION_FUNCTION_COUNT, config->mutation_function, header->mutation);
+    }
+    return 0;
+}
+
+/**
+ * @brief Writes size bytes at an offset of a file, retrying the partial writes.
+ * @param fd The file.
+ * @param data The bytes.
+ * @param size The number of bytes.
+ * @param offset The offset in the file.
+ * @return 0 on success, -1 on failure.
+*/
+static int write_all(int fd, const void *data, size_t size, off_t offset){
+    const char *p = data;
+    while (size > 0){
+        ssize_t written = pwrite(fd, p, size, offset);
+        if (written <= 0)
+            return -1;
+        p += written;
+        size -= written;
+        offset += written;
+    }
+    return 0;
+}
+
+/**
+ * @brief Writes a checkpoint buffer in a file.
+ * The file is written as path.tmp, flushed to the disk and renamed to path, so a crash during the write
+ * leaves the previous checkpoint in place.
+ * @param path The checkpoint file.
+ * @param buffer The filled checkpoint buffer.
+ * @return 0 on success, -1 on failure.
+*/
+int write_checkpoint_buffer(const char *path, const CheckpointBuffer *buffer){
+    size_t path_length = strlen(path);
+    char temporary_path[path_length + 5];
+    memcpy(temporary_path, path, path_length);
+    memcpy(temporary_path + path_length, ".tmp", 5);
+    int fd = open(temporary_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1)
+        return -1;
+    const CheckpointHeader *header = &buffer->header;
+    int result = write_all(fd, header, sizeof(CheckpointHeader), 0);
+    if (result == 0)
+        result = write_all(fd, buffer->lengths, sizeof(uint32_t) * header->size, header->lengths_offset);
+    if (result == 0)
+        result = write_all(fd, buffer->genomes, header->genomes_size, header->genomes_offset);
+    // The genomes are mapped up to the end of their last page by restore_checkpoint
+    if (result == 0)
+        result = ftruncate(fd, header->genomes_offset + header->genomes_size);
+    if (result == 0)
+        result = fsync(fd);
+    if (close(fd) != 0)
+        result = -1;
+    if (result == 0)
+        result = rename(temporary_path, path);
+    if (result != 0)
+        unlink(temporary_path);
+    return result == 0 ? 0 : -1;
+}
+
+/**
+ * @brief Frees the buffers of a checkpoint buffer.
+ * @param buffer The checkpoint buffer.
+*/
+void free_checkpoint_buffer(CheckpointBuffer *buffer){
+    free(buffer->lengths);
+    free(buffer->genomes);
+    memset(buffer, 0, sizeof(CheckpointBuffer));
+}
+
+/**
+ * @brief Writes a checkpoint of a population on the calling thread.
+ * @param path The checkpoint file.
+ * @param p The population.
+ * @param word The target word.
+ * @param config The parameters of the search, or NULL.
+ * @return 0 on success, -1 on failure.
+*/
+int write_checkpoint(const char *path, Population p, const char *word, const JobConfig *config){
+    CheckpointBuffer buffer = {0};
+    int result = fill_checkpoint(&buffer, p, word, config);
+    if (result == 0)
+        result = write_checkpoint_buffer(path, &buffer);
+    free_checkpoint_buffer(&buffer);
+    return result;
+}
+
+/**
+ * @brief Restores a population from a checkpoint file.
+ * The genomes are not copied: the file is mapped copy-on-write in the first space of a new genome arena, and
+ * the individuals point to their genomes in the mapping. The lengths are read to find the genomes, each
+ * must be at most the maximum size of the header and be followed by its terminator in the mapping.
+ * The population has the arena, which is owned by the caller and freed with free_genome_arena after the
+ * population. The random state of the checkpoint is not set, it is given in the header with the word and
+ * the configuration of the search.
+ * @param path The checkpoint file.
+ * @param space_size The size of a space of the arena for the next generations, see create_genome_arena.
+ * @param header The header of the checkpoint, filled.
+ * @return The population, of size 0 if the file could not be read or is not a checkpoint of this version.
+*/
+Population restore_checkpoint(const char *path, size_t space_size, CheckpointHeader *header){
+    Population p;
+    memset(&p, 0, sizeof(Population));
+    int fd = open(path, O_RDONLY);
+    if (fd == -1)
+        return p;
+    struct stat file;
+    uint32_t *lengths = NULL;
+    if (fstat(fd, &file) != 0 || pread(fd, header, sizeof(CheckpointHeader), 0) != sizeof(CheckpointHeader))
+        goto end;
+    if (memcmp(header->magic, CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC)) != 0 || header->version != CHECKPOINT_VERSION ||\
+        header->byte_order != CHECKPOINT_BYTE_ORDER || header->header_size != sizeof(CheckpointHeader) ||\
+        header->word_length < 0 || header->word_length > JOB_MAX_WORD || header->size == 0 ||\
+        header->min_individual_size < 0 || header->min_individual_size > header->max_individual_size ||\
+        header->genomes_offset % CHECKPOINT_ALIGNMENT != 0 ||\
+        header->lengths_offset + sizeof(uint32_t) * header->size > header->genomes_offset ||\
+        header->genomes_offset + header->genomes_size > (uint64_t) file.st_size)
+        goto end;
+    header->word[header->word_length] = '\0';
+
+    lengths = malloc(sizeof(uint32_t) * header->size);
+    if (lengths == NULL || pread(fd, lengths, sizeof(uint32_t) * header->size, header->lengths_offset) != (ssize_t) (sizeof(uint32_t) * header->size))
+        goto end;
+    uint64_t genomes_size = 0;
+    for (size_t i = 0; i < header->size; i++){
+        if (lengths[i] > (uint32_t) header->max_individual_size)
+            goto end;
+        genomes_size += (uint64_t) lengths[i] + 1;
+    }
+    if (genomes_size != header->genomes_size)
+        goto end;
+
+    p.individuals = scratch_alloc(sizeof(Individual) * header->size);
+    if (p.individuals == NULL)
+        goto end;
+    p.arena = map_genome_arena(fd, header->genomes_offset, header->genomes_size, space_size);
+    if (p.arena == NULL){
+        scratch_free(p.individuals);
+        p.individuals = NULL;
+        goto end;
+    }
+    Gene *genome = p.arena->base;
+    for (size_t i = 0; i < header->size; i++){
+        // A genome without its terminator would be read past its end by the fitness functions
+        if (genome[lengths[i]] != '\0'){
+            scratch_free(p.individuals);
+            free_genome_arena(p.arena);
+            memset(&p, 0, sizeof(Population));
+            goto end;
+        }
+        p.individuals[i].genome = genome;
+        p.individuals[i].size = lengths[i];
+        p.individuals[i].min_size = header->min_individual_size;
+        p.individuals[i].max_size = header->max_individual_size;
+        genome += lengths[i] + 1;
+    }
+    p.size = header->size;
+    p.min_individual_size = header->min_individual_size;
+    p.max_individual_size = header->max_individual_size;
+    p.generation = header->generation;
+
+end:
+    free(lengths);
+    close(fd);
+    return p;
+}
+
+/**
+ * @brief Sets the parameters of a job configuration from the header of a checkpoint.
+ * @param header The header of the checkpoint.
+ * @param config The configuration, whose operators are kept when the checkpoint has no name for them.
+ * @return 0 on success, -1 if an operator name is unknown.
+*/
+int checkpoint_job_config(const CheckpointHeader *header, JobConfig *config){
+    config->population_size = header->size;
+    config->max_generations = header->max_generations;
+    config->fixed_length = header->fixed_length;
+    config->random_operators = header->random_operators;
+    config->seed = header->seed;
+    const char *kinds[] = {"fitness", "selection", "pairing", "crossover", "mutation"};
+    const char *names[] = {header->fitness, header->selection, header->pairing, header->crossover, header->mutation};
+    for (int k = 0; k < 5; k++)
+        if (names[k][0] != '\0' && strnlen(names[k], CHECKPOINT_NAME) < CHECKPOINT_NAME &&\
+            set_job_operator(config, kinds[k], names[k]) != 0)
+            return -1;
+    return 0;
+}
+
+/**
+ * @brief Body of the thread of a checkpoint writer: writes the queued buffers until the writer is closed.
+ * @param datas The checkpoint writer.
+ * @return NULL.
+*/
+static void *checkpoint_thread(void *datas){
+    CheckpointWriter *writer = datas;
+    pthread_mutex_lock(&writer->lock);
+    for (;;){
+        while (writer->queued == -1 && !writer->closed)
+            pthread_cond_wait(&writer->changed, &writer->lock);
+        if (writer->queued == -1)
+            break;
+        writer->writing = writer->queued;
+        writer->queued = -1;
+        pthread_mutex_unlock(&writer->lock);
+        int result = write_checkpoint_buffer(writer->path, &writer->buffers[writer->writing]);
+        pthread_mutex_lock(&writer->lock);
+        if (result == 0)
+            writer->written++;
+        else
+            writer->failed++;
+        writer->writing = -1;
+        pthread_cond_broadcast(&writer->changed);
+    }
+    pthread_mutex_unlock(&writer->lock);
+    return NULL;
+}
+
+/**
+ * @brief Creates a checkpoint writer and starts its thread.
+ * @param path The checkpoint file, copied.
+ * @param interval The number of generations between two checkpoints.
+ * @return The checkpoint writer, or NULL on failure.
+*/
+CheckpointWriter *create_checkpoint_writer(const char *path, int interval){
+    if (interval <= 0)
+        return NULL;
+    CheckpointWriter *writer = calloc(1, sizeof(CheckpointWriter));
+    if (writer == NULL)
+        return NULL;
+    writer->path = strdup(path);
+    writer->interval = interval;
+    writer->queued = -1;
+    writer->writing = -1;
+    if (writer->path == NULL){
+        free(writer);
+        return NULL;
+    }
+    pthread_mutex_init(&writer->lock, NULL);
+    pthread_cond_init(&writer->changed, NULL);
+    if (pthread_create(&writer->thread, NULL, checkpoint_thread, writer) != 0){
+        pthread_mutex_destroy(&writer->lock);
+        pthread_cond_destroy(&writer->changed);
+        free(writer->path);
+        free(writer);
+        return NULL;
+    }
+    return writer;
+}
+
+/**
+ * @brief Queues a checkpoint of a population when its generation is a multiple of the interval of the writer.
+ * The population is copied in the buffer which is not being written, replacing a checkpoint still waiting
+ * for the thread, so the call never waits for the disk.
+ * @param writer The checkpoint writer.
+ * @param p The population, with the random state of the calling thread.
+ * @param word The target word.
+ * @param config The parameters of the search, or NULL.
+ * @return 1 if a checkpoint was queued, 0 if it is not the generation of a checkpoint, -1 on failure.
+*/
+int checkpoint_population(CheckpointWriter *writer, Population p, const char *word, const JobConfig *config){
+    if (p.generation % writer->interval != 0)
+        return 0;
+    pthread_mutex_lock(&writer->lock);
+    // The thread only takes queued buffers, so the buffer is filled without the lock
+    int filling = writer->writing == 0 ? 1 : 0;
+    writer->queued = -1;
+    pthread_mutex_unlock(&writer->lock);
+    if (fill_checkpoint(&writer->buffers[filling], p, word, config) != 0)
+        return -1;
+    pthread_mutex_lock(&writer->lock);
+    writer->queued = filling;
+    pthread_cond_broadcast(&writer->changed);
+    pthread_mutex_unlock(&writer->lock);
+    return 1;
+}
+
+/**
+ * @brief Waits until the queued checkpoint, if any, is written.
+ * @param writer The checkpoint writer.
+*/
+void flush_checkpoint_writer(CheckpointWriter *writer){
+    pthread_mutex_lock(&writer->lock);
+    while (writer->queued != -1 || writer->writing != -1)
+        pthread_cond_wait(&writer->changed, &writer->lock);
+    pthread_mutex_unlock(&writer->lock);
+}
+
+/**
+ * @brief Writes the queued checkpoint, stops the thread of a writer and frees it.
+ * @param writer The checkpoint writer, or NULL.
+*/
+void free_checkpoint_writer(CheckpointWriter *writer){
+    if (writer == NULL)
+        return;
+    pthread_mutex_lock(&writer->lock);
+    writer->closed = 1;
+    pthread_cond_broadcast(&writer->changed);
+    pthread_mutex_unlock(&writer->lock);
+    pthread_join(writer->thread, NULL);
+    pthread_mutex_destroy(&writer->lock);
+    pthread_cond_destroy(&writer->changed);
+    free_checkpoint_buffer(&writer->buffers[0]);
+    free_checkpoint_buffer(&writer->buffers[1]);
+    free(writer->path);
+    free(writer);
+}
@@ -0,0 +1,196 @@
+#include <columnar.h>
+
+// Maximum number of positions counted in 8 bits before the counts are flushed
+#define COLUMN_CHUNK 255
+
+/**
+ * @brief Creates a column population able to hold size individuals of the given length.
+ * @param size The number of individuals.
+ * @param length The length of every genome.
+ * @return The column population. Its genes are NULL if the allocation failed.
+*/
+ColumnPopulation create_column_population(size_t size, int length){
+    ColumnPopulation columns;
+    memset(&columns, 0, sizeof(ColumnPopulation));
+    reserve_column_population(&columns, size, length);
+    return columns;
+}
+
+/**
+ * @brief Makes sure a column population can hold size individuals of the given length.
+ * The buffer is aligned on COLUMN_BLOCK bytes and only grows, so a column population reused
+ * across generations is allocated once.
+ * @param columns The column population.
+ * @param size The number of individuals.
+ * @param length The length of every genome.
+ * @return 0 on success, -1 if the allocation failed.
+*/
+int reserve_column_population(ColumnPopulation *columns, size_t size, int length){
+    size_t stride = (size + COLUMN_BLOCK - 1) / COLUMN_BLOCK * COLUMN_BLOCK;
+    size_t capacity = stride * length;
+    if (capacity > columns->capacity){
+        Gene *genes = aligned_alloc(COLUMN_BLOCK, capacity == 0 ? COLUMN_BLOCK : capacity);
+        if (genes == NULL)
+            return -1;
+        free(columns->genes);
+        columns->genes = genes;
+        columns->capacity = capacity;
+    }
+    columns->size = size;
+    columns->stride = stride;
+    columns->length = length;
+    return 0;
+}
+
+/**
+ * @brief Frees the genes of a column population.
+ * @param columns The column population to free.
+*/
+void free_column_population(ColumnPopulation columns){
+    free(columns.genes);
+}
+
+/**
+ * @brief Checks whether every individual of the population has the length of the word.
+ * This is the case when the minimum and the maximum size of the individuals are both the length of the
+ * word, since the crossover and mutation functions keep the length between these bounds.
+ * @param p The population.
+ * @param word The target word.
+ * @return 1 if the population is fixed-length, 0 otherwise.
+*/
+int is_fixed_length(Population p, const char *word){
+    int word_length = strlen(word);
+    return p.min_individual_size == word_length && p.max_individual_size == word_length && word_length != 0;
+}
+
+/**
+ * @brief Copies the genomes of a fixed-length population into its column-major layout.
+ * The genes missing from a shorter genome, and the genes of the padding individuals, are set to 0,
+ * which never matches a character of the word.
+ * @param p The population.
+ * @param columns The column population, resized to the population.
+*/
+void rows_to_columns(Population p, ColumnPopulation *columns){
+    int length = p.max_individual_size;
+    if (reserve_column_population(columns, p.size, length) != 0)
+        return;
+    size_t stride = columns->stride;
+    for (size_t i = 0; i < p.size; i++){
+        const Gene *genome = p.individuals[i].genome;
+        int size = p.individuals[i].size < length ? p.individuals[i].size : length;
+        int j = 0;
+        for (; j < size; j++)
+            columns->genes[j * stride + i] = genome[j];
+        for (; j < length; j++)
+            columns->genes[j * stride + i] = 0;
+    }
+    // Padding individuals of the last block
+    for (int j = 0; j < length; j++)
+        memset(columns->genes + j * stride + p.size, 0, stride - p.size);
+}
+
+/**
+ * @brief Counts, for a block of COLUMN_BLOCK individuals, the positions from..to-1 equal to the word.
+ * The character of the word is broadcast and compared with the genes of 32 (AVX2), 16 (SSE2) or
+ * one (scalar fallback) individuals per instruction. to - from must not exceed COLUMN_CHUNK.
+ * @param block The first gene of the block at position 0.
+ * @param stride The stride of the column population.
+ * @param word The target word.
+ * @param from The first position.
+ * @param to The position after the last one.
+ * @param matches The number of matches of each individual of the block.
+*/
+static inline void count_block_matches(const Gene *block, size_t stride, const char *word, int from, int to, uint8_t *matches){
+#if defined(__AVX2__)
+    __m256i acc0 = _mm256_setzero_si256(), acc1 = _mm256_setzero_si256();
+    for (int j = from; j < to; j++){
+        const Gene *row = block + j * stride;
+        __m256i c = _mm256_set1_epi8(word[j]);
+        // cmpeq gives -1 on a match
+        acc0 = _mm256_sub_epi8(acc0, _mm256_cmpeq_epi8(_mm256_load_si256((const __m256i *) row), c));
+        acc1 = _mm256_sub_epi8(acc1, _mm256_cmpeq_epi8(_mm256_load_si256((const __m256i *) (row + 32)), c));
+    }
+    _mm256_storeu_si256((__m256i *) matches, acc0);
+    _mm256_storeu_si256((__m256i *) (matches + 32), acc1);
+#elif defined(__SSE2__)
+    __m128i acc[4] = {_mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128()};
+    for (int j = from; j < to; j++){
+        const Gene *row = block + j * stride;
+        __m128i c = _mm_set1_epi8(word[j]);
+        for (int k = 0; k < 4; k++)
+            acc[k] = _mm_sub_epi8(acc[k], _mm_cmpeq_epi8(_mm_load_si128((const __m128i *) (row + 16 * k)), c));
+    }
+    for (int k = 0; k < 4; k++)
+        _mm_storeu_si128((__m128i *) (matches + 16 * k), acc[k]);
+#else
+    memset(matches, 0, COLUMN_BLOCK);
+    for (int j = from; j < to; j++){
+        const Gene *row = block + j * stride;
+        Gene c = word[j];
+        for (int k = 0; k < COLUMN_BLOCK; k++)
+            matches[k] += row[k] == c;
+    }
+#endif
+}
+
+/**
+ * @brief Computes the modified Hamming distance fitness of every individual of a fixed-length population.
+ * The scores are the ones of modified_hamming_distance_fitness, the mismatches divided by the length.
+ * Complexity : O(n * L / 32) with AVX2
+ * @param columns The column population.
+ * @param word The target word, of the length of the columns.
+ * @param scores The score of each individual.
+*/
+void columnar_hamming_fitness(const ColumnPopulation *columns, const char *word, float *scores){
+    int length = columns->length;
+    uint8_t matches[COLUMN_BLOCK];
+    int total[COLUMN_BLOCK];
+    for (size_t b = 0; b < columns->size; b += COLUMN_BLOCK){
+        const Gene *block = columns->genes + b;
+        memset(total, 0, sizeof(total));
+        for (int from = 0; from < length; from += COLUMN_CHUNK){
+            int to = from + COLUMN_CHUNK < length ? from + COLUMN_CHUNK : length;
+            count_block_matches(block, columns->stride, word, from, to, matches);
+            for (int k = 0; k < COLUMN_BLOCK; k++)
+                total[k] += matches[k];
+        }
+        size_t block_size = columns->size - b < COLUMN_BLOCK ? columns->size - b : COLUMN_BLOCK;
+        for (size_t k = 0; k < block_size; k++)
+            scores[b + k] = (float) (length - total[k]) / length;
+    }
+}
+
+/**
+ * @brief Computes the Manhattan distance fitness of every individual of a fixed-length population.
+ * The scores are the ones of manhattan_distance_fitness. The absolute differences are accumulated
+ * in 16 bits over a block of individuals, a loop the compiler vectorizes.
+ * @param columns The column population.
+ * @param word The target word, of the length of the columns.
+ * @param scores The score of each individual.
+*/
+void columnar_manhattan_fitness(const ColumnPopulation *columns, const char *word, float *scores){
+    int length = columns->length;
+    uint16_t distances[COLUMN_BLOCK];
+    long total[COLUMN_BLOCK];
+    for (size_t b = 0; b < columns->size; b += COLUMN_BLOCK){
+        const Gene *block = columns->genes + b;
+        memset(total, 0, sizeof(total));
+        for (int from = 0; from < length; from += COLUMN_CHUNK){
+            int to = from + COLUMN_CHUNK < length ? from + COLUMN_CHUNK : length;
+            memset(distances, 0, sizeof(distances));
+            for (int j = from; j < to; j++){
+                const Gene *row = block + j * columns->stride;
+                int c = word[j];
+                for (int k = 0; k < COLUMN_BLOCK; k++){
+                    int difference = row[k] - c;
+                    distances[k] += difference < 0 ? -difference : difference;
+                }
+            }
+            for (int k = 0; k < COLUMN_BLOCK; k++)
+                total[k] += distances[k];
+        }
+        size_t block_size = columns->size - b < COLUMN_BLOCK ? columns->size - b : COLUMN_BLOCK;
+        for (size_t k = 0; k < block_size; k++)
+            scores[b + k] = total[k] / (length * 96.0f);
+    }
+}
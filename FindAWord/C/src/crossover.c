@@ -21,14 +21,14 @@ Individual uniform_crossover(Individual p1, Individual p2, void * optional_datas
     int min_len = p1_len < p2_len ? p1_len : p2_len;
 
     // Choose length of child randomly from either parent
-    int child_len = rand() % 2 ? p1_len : p2_len;
+    int child_len = random_int() % 2 ? p1_len : p2_len;
 
     // Perform crossover by selecting characters from parents with a 50% chance for each character
     Individual child;
-    child.genome = malloc(sizeof(Gene) * (child_len + 1));
+    child.genome = scratch_alloc(sizeof(Gene) * (child_len + 1));
     int i;
     for (i = 0; i < min_len; i++) {
-        if (rand() % 2 == 0) {
+        if (random_int() % 2 == 0) {
             child.genome[i] = p1.genome[i];
         } else {
             child.genome[i] = p2.genome[i];
@@ -37,7 +37,7 @@ Individual uniform_crossover(Individual p1, Individual p2, void * optional_datas
 
     // If child length is greater than min_xy, fill the remaining characters with characters from a parent or randomly
     for (i = min_len; i < child_len; i++) {
-        if (rand() % 2 == 0) {
+        if (random_int() % 2 == 0) {
             if (i < p1_len) {
                 child.genome[i] = p1.genome[i];
             } else {
@@ -70,12 +70,12 @@ Individual multipoint_crossover(Individual p1, Individual p2, void *optional_dat
     int nb_points = (optional_datas == NULL) ? 2 : *(int *) optional_datas;
     int p1_len = p1.size, p2_len = p2.size;
     int min_len = (p1_len < p2_len) ? p1_len : p2_len;
-    int child_len = ((rand() % 2) == 0) ? p1_len : p2_len;
+    int child_len = ((random_int() % 2) == 0) ? p1_len : p2_len;
     int slice_size = min_len / nb_points, min_slice = 0, max_slice = slice_size;
 
     // Allocate memory for child genome
     Individual child;
-    child.genome = malloc((child_len + 1) * sizeof(Gene));
+    child.genome = scratch_alloc((child_len + 1) * sizeof(Gene));
     child.min_size = p1.min_size;
     child.max_size = p1.max_size;
     child.size = child_len;
@@ -84,7 +84,7 @@ Individual multipoint_crossover(Individual p1, Individual p2, void *optional_dat
     Gene *parent_genome;
     int i;
     for (i = 0; i < nb_points; i++, min_slice += slice_size, max_slice += slice_size) {
-        parent_genome = ((rand() % 2) == 0) ? p1.genome : p2.genome;
+        parent_genome = ((random_int() % 2) == 0) ? p1.genome : p2.genome;
         memcpy(child.genome + min_slice, parent_genome + min_slice, (max_slice - min_slice) * sizeof(Gene));
     }
 
@@ -112,22 +112,22 @@ Individual probalistic_crossover(Individual p1, Individual p2, void *optional_da
     p1_len = p1.size;
     p2_len = p2.size;
 
-    int child_len = rand() % 2 ? p1_len : p2_len;
+    int child_len = random_int() % 2 ? p1_len : p2_len;
     double probabilities_array[child_len];
     for (int i = 0; i < child_len; i++) {
-        probabilities_array[i] = ((double)rand() / RAND_MAX);
+        probabilities_array[i] = ((double)random_int() / RAND_MAX);
     }
     Individual child;
-    child.genome = malloc(sizeof(Gene) * (child_len + 1));
+    child.genome = scratch_alloc(sizeof(Gene) * (child_len + 1));
     for (int i = 0; i < child_len; i++) {
         if (i >= p1_len) {
-            child.genome[i] = (rand() / RAND_MAX >= probabilities_array[i]) ? p2.genome[i] : create_gene();  // Append the selected gene to new_individual
+            child.genome[i] = (random_int() / RAND_MAX >= probabilities_array[i]) ? p2.genome[i] : create_gene();  // Append the selected gene to new_individual
         }
         else if (i >= p2_len) {
-            child.genome[i] = (rand() / RAND_MAX >= probabilities_array[i]) ? p1.genome[i] : create_gene();  // Append the selected gene to new_individual
+            child.genome[i] = (random_int() / RAND_MAX >= probabilities_array[i]) ? p1.genome[i] : create_gene();  // Append the selected gene to new_individual
         }
         else {
-            child.genome[i] = (rand() / RAND_MAX >= probabilities_array[i]) ? p1.genome[i] : p2.genome[i];  // Append the selected gene to new_individual
+            child.genome[i] = (random_int() / RAND_MAX >= probabilities_array[i]) ? p1.genome[i] : p2.genome[i];  // Append the selected gene to new_individual
         }
     }
 
@@ -0,0 +1,140 @@
+#include <dedup.h>
+
+// FNV-1a constants
+#define FNV_OFFSET 0xcbf29ce484222325ULL
+#define FNV_PRIME 0x100000001b3ULL
+// Tries to draw a random individual which is not a duplicate
+#define DEDUP_REFILL_TRIES 4
+
+/**
+ * @brief Creates an empty dedup table, its buffers are allocated by the first dedup_individuals.
+ * @param mode What is done with the duplicates.
+ * @return The dedup table, or NULL if the allocation failed.
+*/
+DedupTable *create_dedup_table(DedupMode mode){
+    DedupTable *table = calloc(1, sizeof(DedupTable));
+    if (table != NULL)
+        table->mode = mode;
+    return table;
+}
+
+/**
+ * @brief Frees a dedup table.
+ * @param table The dedup table, or NULL.
+*/
+void free_dedup_table(DedupTable *table){
+    if (table == NULL)
+        return;
+    free(table->hashes);
+    free(table->slots);
+    free(table->first);
+    free(table);
+}
+
+/**
+ * @brief Makes sure a dedup table can hold size individuals with a load factor of at most 1/2.
+ * @param table The dedup table.
+ * @param size The number of individuals.
+ * @return 0 on success, -1 if the allocation failed.
+*/
+static int reserve_dedup_table(DedupTable *table, size_t size){
+    size_t capacity = 16;
+    while (capacity < 2 * size)
+        capacity <<= 1;
+    if (capacity > table->capacity){
+        uint64_t *hashes = malloc(sizeof(uint64_t) * capacity);
+        size_t *slots = malloc(sizeof(size_t) * capacity);
+        if (hashes == NULL || slots == NULL){
+            free(hashes);
+            free(slots);
+            return -1;
+        }
+        free(table->hashes);
+        free(table->slots);
+        table->hashes = hashes;
+        table->slots = slots;
+        table->capacity = capacity;
+    }
+    if (size > table->size){
+        int64_t *first = malloc(sizeof(int64_t) * size);
+        if (first == NULL)
+            return -1;
+        free(table->first);
+        table->first = first;
+        table->size = size;
+    }
+    return 0;
+}
+
+/**
+ * @brief Hashes a genome with FNV-1a.
+ * @param individual The individual.
+ * @return The hash of its genome.
+*/
+static inline uint64_t hash_genome(Individual individual){
+    uint64_t hash = FNV_OFFSET;
+    for (int i = 0; i < individual.size; i++){
+        hash ^= (unsigned char) individual.genome[i];
+        hash *= FNV_PRIME;
+    }
+    // The last multiplication leaves the low bits used by the slots poorly mixed
+    return hash ^ (hash >> 32);
+}
+
+/**
+ * @brief Inserts an individual in a dedup table.
+ * @param table The dedup table.
+ * @param individuals The individuals.
+ * @param index The index of the individual to insert.
+ * @return The index of the first individual with the same genome, or -1 if the genome was not in the table.
+*/
+static int64_t insert_genome(DedupTable *table, Individual *individuals, size_t index){
+    uint64_t hash = hash_genome(individuals[index]);
+    size_t mask = table->capacity - 1;
+    size_t slot = (size_t) (hash & mask);
+    while (table->slots[slot] != 0){
+        size_t other = table->slots[slot] - 1;
+        if (table->hashes[slot] == hash && individuals[other].size == individuals[index].size\
+            && memcmp(individuals[other].genome, individuals[index].genome, individuals[index].size) == 0)
+            return (int64_t) other;
+        slot = (slot + 1) & mask;
+    }
+    table->slots[slot] = index + 1;
+    table->hashes[slot] = hash;
+    return -1;
+}
+
+/**
+ * @brief Finds the duplicates of a population.
+ * In DEDUP_SHARE mode, table->first[i] is set to the index of the first individual with the genome of
+ * the individual i, or -1. In DEDUP_DROP mode, the duplicates are replaced by new random individuals
+ * and table->first is -1 for every individual.
+ * @param table The dedup table.
+ * @param individuals The individuals of the population.
+ * @param size The number of individuals.
+ * The number of duplicates found is written in table->duplicates.
+ * @return 0 on success, -1 if the allocation failed.
+*/
+int dedup_individuals(DedupTable *table, Individual *individuals, size_t size){
+    if (reserve_dedup_table(table, size) != 0)
+        return -1;
+    memset(table->slots, 0, sizeof(size_t) * table->capacity);
+    table->duplicates = 0;
+    for (size_t i = 0; i < size; i++){
+        int64_t first = insert_genome(table, individuals, i);
+        if (first != -1){
+            table->duplicates++;
+            if (table->mode == DEDUP_DROP){
+                // A new random individual is almost never a duplicate, but it is checked anyway
+                for (int tries = 0; tries < DEDUP_REFILL_TRIES && first != -1; tries++){
+                    Individual replacement = create_individual(individuals[i].min_size, individuals[i].max_size);
+                    free_individual(individuals[i]);
+                    individuals[i] = replacement;
+                    first = insert_genome(table, individuals, i);
+                }
+            }
+        }
+        table->first[i] = table->mode == DEDUP_SHARE ? first : -1;
+    }
+    return 0;
+}
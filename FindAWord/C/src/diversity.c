@@ -0,0 +1,198 @@
+#include <diversity.h>
+
+/**
+ * @brief Creates an empty diversity model.
+ * @param max_individual_size The maximum size an individual can have.
+ * @return The diversity model, or NULL if the allocation failed.
+*/
+Diversity *create_diversity(int max_individual_size){
+    Diversity *diversity = malloc(sizeof(Diversity));
+    if (diversity == NULL)
+        return NULL;
+    diversity->max_size = max_individual_size;
+    diversity->size = 0;
+    diversity->counts = calloc((size_t) max_individual_size * GENE_SYMBOLS, sizeof(size_t));
+    diversity->lengths = calloc(max_individual_size + 1, sizeof(size_t));
+    if (diversity->counts == NULL || diversity->lengths == NULL){
+        free_diversity(diversity);
+        return NULL;
+    }
+    return diversity;
+}
+
+/**
+ * @brief Frees a diversity model.
+ * @param diversity The diversity model, or NULL.
+*/
+void free_diversity(Diversity *diversity){
+    if (diversity == NULL)
+        return;
+    free(diversity->counts);
+    free(diversity->lengths);
+    free(diversity);
+}
+
+/**
+ * @brief Removes every individual from a diversity model.
+ * @param diversity The diversity model.
+*/
+void reset_diversity(Diversity *diversity){
+    memset(diversity->counts, 0, sizeof(size_t) * diversity->max_size * GENE_SYMBOLS);
+    memset(diversity->lengths, 0, sizeof(size_t) * (diversity->max_size + 1));
+    diversity->size = 0;
+}
+
+/**
+ * @brief Adds an individual to a diversity model, or removes it.
+ * @param diversity The diversity model.
+ * @param individual The individual.
+ * @param delta 1 to add the individual, -1 to remove it, the unsigned counts wrap back.
+*/
+static inline void update_diversity(Diversity *diversity, Individual individual, size_t delta){
+    int size = individual.size < diversity->max_size ? individual.size : diversity->max_size;
+    size_t *counts = diversity->counts;
+    for (int i = 0; i < size; i++)
+        counts[i * GENE_SYMBOLS + (unsigned char) individual.genome[i] - MINCHAR] += delta;
+    diversity->lengths[size] += delta;
+    diversity->size += delta;
+}
+
+/**
+ * @brief Adds an individual to a diversity model.
+ * @param diversity The diversity model.
+ * @param individual The individual, with genes between MINCHAR and MAXCHAR.
+*/
+void add_to_diversity(Diversity *diversity, Individual individual){
+    update_diversity(diversity, individual, 1);
+}
+
+/**
+ * @brief Removes an individual previously added to a diversity model.
+ * @param diversity The diversity model.
+ * @param individual The individual.
+*/
+void remove_from_diversity(Diversity *diversity, Individual individual){
+    update_diversity(diversity, individual, (size_t) -1);
+}
+
+/**
+ * @brief Counts all the individuals of a population in a diversity model, for example after creating the population.
+ * @param diversity The diversity model, reset first.
+ * @param individuals The individuals of the population.
+ * @param size The number of individuals.
+*/
+void count_diversity(Diversity *diversity, Individual *individuals, size_t size){
+    reset_diversity(diversity);
+    for (size_t i = 0; i < size; i++)
+        update_diversity(diversity, individuals[i], 1);
+}
+
+/**
+ * @brief Adds the individuals counted by another diversity model, for example the model of another thread.
+ * @param diversity The diversity model.
+ * @param other The model whose individuals are added, with the same maximum size.
+*/
+void merge_diversity(Diversity *diversity, const Diversity *other){
+    for (size_t i = 0; i < (size_t) diversity->max_size * GENE_SYMBOLS; i++)
+        diversity->counts[i] += other->counts[i];
+    for (int l = 0; l <= diversity->max_size; l++)
+        diversity->lengths[l] += other->lengths[l];
+    diversity->size += other->size;
+}
+
+/**
+ * @brief Computes the Shannon entropy, in bits, of the genes at each position.
+ * The entropy of a position is computed on the individuals long enough to have a gene at this position.
+ * It is 0 when they all have the same gene and log2(GENE_SYMBOLS) when the genes are uniformly distributed.
+ * @param diversity The diversity model.
+ * @param entropies The entropy of each position, max_size entries, or NULL.
+ * @return The mean entropy of the positions held by at least one individual.
+*/
+float diversity_entropy(const Diversity *diversity, float *entropies){
+    double sum = 0.0;
+    int positions = 0;
+    size_t having = diversity->size;
+    for (int i = 0; i < diversity->max_size; i++){
+        // The individuals of length i do not have a gene at position i
+        having -= diversity->lengths[i];
+        double entropy = 0.0;
+        if (having > 0){
+            const size_t *counts = diversity->counts + i * GENE_SYMBOLS;
+            for (int g = 0; g < GENE_SYMBOLS; g++){
+                if (counts[g] != 0){
+                    double frequency = (double) counts[g] / having;
+                    entropy -= frequency * log2(frequency);
+                }
+            }
+            sum += entropy;
+            positions++;
+        }
+        if (entropies != NULL)
+            entropies[i] = (float) entropy;
+    }
+    return positions != 0 ? (float) (sum / positions) : 0.0f;
+}
+
+/**
+ * @brief Returns the most frequent length of a diversity model.
+ * @param diversity The diversity model.
+ * @return The length of the consensus string.
+*/
+static int consensus_length(const Diversity *diversity){
+    int length = 0;
+    for (int l = 1; l <= diversity->max_size; l++)
+        if (diversity->lengths[l] > diversity->lengths[length])
+            length = l;
+    return length;
+}
+
+/**
+ * @brief Returns the most frequent gene at a position of a diversity model.
+ * @param diversity The diversity model.
+ * @param position The position.
+ * @return The index of the consensus gene, gene - MINCHAR.
+*/
+static int consensus_gene(const Diversity *diversity, int position){
+    const size_t *counts = diversity->counts + position * GENE_SYMBOLS;
+    int best = 0;
+    for (int g = 1; g < GENE_SYMBOLS; g++)
+        if (counts[g] > counts[best])
+            best = g;
+    return best;
+}
+
+/**
+ * @brief Computes the consensus string: the most frequent length, and the most frequent gene at each position.
+ * @param diversity The diversity model.
+ * @param consensus The consensus string, max_size + 1 characters.
+ * @return The length of the consensus string.
+*/
+int diversity_consensus(const Diversity *diversity, char *consensus){
+    int length = consensus_length(diversity);
+    for (int i = 0; i < length; i++)
+        consensus[i] = (char) (consensus_gene(diversity, i) + MINCHAR);
+    consensus[length] = '\0';
+    return length;
+}
+
+/**
+ * @brief Computes the mean modified Hamming distance of the individuals to the consensus string.
+ * At a position of the consensus, the individuals long enough which do not have the consensus gene add 1,
+ * and every individual adds the difference between its length and the length of the consensus.
+ * @param diversity The diversity model.
+ * @return The mean distance to the consensus string, 0 for an empty model.
+*/
+float diversity_consensus_distance(const Diversity *diversity){
+    if (diversity->size == 0)
+        return 0.0f;
+    int length = consensus_length(diversity);
+    double distance = 0.0;
+    for (int l = 0; l <= diversity->max_size; l++)
+        distance += (double) diversity->lengths[l] * abs(l - length);
+    size_t having = diversity->size;
+    for (int i = 0; i < length; i++){
+        having -= diversity->lengths[i];
+        distance += (double) (having - diversity->counts[i * GENE_SYMBOLS + consensus_gene(diversity, i)]);
+    }
+    return (float) distance / diversity->size;
+}
@@ -0,0 +1,336 @@
+#include <eda.h>
+
+/**
+ * @brief Builds the alias table of a distribution with the Vose algorithm.
+ * Drawing a symbol k uniformly and keeping it with probability alias_probabilities[k], or taking
+ * aliases[k] otherwise, draws the symbols with the probabilities of the distribution.
+ * Complexity : O(size)
+ * @param probabilities The distribution, which sums to 1.
+ * @param size The number of symbols, at most 256.
+ * @param alias_probabilities The probability to keep each symbol.
+ * @param aliases The symbol taken instead of each symbol.
+*/
+static void build_alias_table(const float *probabilities, int size, float *alias_probabilities, uint8_t *aliases){
+    float scaled[256];
+    int small[256], large[256];
+    int small_size = 0, large_size = 0;
+    for (int k = 0; k < size; k++){
+        scaled[k] = probabilities[k] * size;
+        if (scaled[k] < 1.0f)
+            small[small_size++] = k;
+        else
+            large[large_size++] = k;
+    }
+    while (small_size != 0 && large_size != 0){
+        int s = small[--small_size];
+        int l = large[--large_size];
+        alias_probabilities[s] = scaled[s];
+        aliases[s] = (uint8_t) l;
+        scaled[l] = scaled[l] + scaled[s] - 1.0f;
+        if (scaled[l] < 1.0f)
+            small[small_size++] = l;
+        else
+            large[large_size++] = l;
+    }
+    // The remaining symbols are kept, up to rounding errors
+    while (large_size != 0){
+        int l = large[--large_size];
+        alias_probabilities[l] = 1.0f;
+        aliases[l] = (uint8_t) l;
+    }
+    while (small_size != 0){
+        int s = small[--small_size];
+        alias_probabilities[s] = 1.0f;
+        aliases[s] = (uint8_t) s;
+    }
+}
+
+/**
+ * @brief Bounds the probabilities of a distribution below by EDA_MIN_PROBABILITY and normalizes it.
+ * @param probabilities The distribution.
+ * @param size The number of symbols.
+*/
+static void bound_distribution(float *probabilities, int size){
+    float sum = 0.0f;
+    for (int k = 0; k < size; k++){
+        if (probabilities[k] < EDA_MIN_PROBABILITY)
+            probabilities[k] = EDA_MIN_PROBABILITY;
+        sum += probabilities[k];
+    }
+    for (int k = 0; k < size; k++)
+        probabilities[k] /= sum;
+}
+
+/**
+ * @brief Rebuilds the alias tables of all the positions of a model.
+ * @param model The model.
+*/
+static void build_alias_tables(EdaModel *model){
+    for (int i = 0; i < model->max_size; i++)
+        build_alias_table(model->probabilities + i * GENE_SYMBOLS, GENE_SYMBOLS,\
+                          model->alias_probabilities + i * GENE_SYMBOLS, model->aliases + i * GENE_SYMBOLS);
+}
+
+/**
+ * @brief Creates a model where every gene and every length are equally likely.
+ * @param algorithm The update rule.
+ * @param min_size_individual The minimum size of each individual.
+ * @param max_size_individual The maximum size of each individual.
+ * @param learning_rate The learning rate of EDA_PBIL, in ]0, 1].
+ * @param selection_rate The fraction of the best individuals the model is learnt from, in ]0, 1].
+ * @return The model, or NULL if the allocation failed.
+*/
+EdaModel *create_eda_model(EdaAlgorithm algorithm, int min_size_individual, int max_size_individual, float learning_rate, float selection_rate){
+    EdaModel *model = calloc(1, sizeof(EdaModel));
+    if (model == NULL)
+        return NULL;
+    model->algorithm = algorithm;
+    model->learning_rate = learning_rate;
+    model->selection_rate = selection_rate;
+    model->min_size = min_size_individual;
+    model->max_size = max_size_individual;
+    size_t genes = (size_t) max_size_individual * GENE_SYMBOLS;
+    int lengths = max_size_individual - min_size_individual + 1;
+    model->probabilities = malloc(sizeof(float) * genes);
+    model->length_probabilities = malloc(sizeof(float) * lengths);
+    model->alias_probabilities = malloc(sizeof(float) * genes);
+    model->aliases = malloc(sizeof(uint8_t) * genes);
+    model->frequencies = malloc(sizeof(float) * (genes > (size_t) lengths ? genes : (size_t) lengths));
+    if (model->probabilities == NULL || model->length_probabilities == NULL || model->alias_probabilities == NULL\
+        || model->aliases == NULL || model->frequencies == NULL){
+        free_eda_model(model);
+        return NULL;
+    }
+    for (size_t k = 0; k < genes; k++)
+        model->probabilities[k] = 1.0f / GENE_SYMBOLS;
+    for (int l = 0; l < lengths; l++)
+        model->length_probabilities[l] = 1.0f / lengths;
+    build_alias_tables(model);
+    return model;
+}
+
+/**
+ * @brief Frees a model.
+ * @param model The model, or NULL.
+*/
+void free_eda_model(EdaModel *model){
+    if (model == NULL)
+        return;
+    free(model->probabilities);
+    free(model->length_probabilities);
+    free(model->alias_probabilities);
+    free(model->aliases);
+    free(model->frequencies);
+    free(model);
+}
+
+/**
+ * @brief Samples an individual from a model.
+ * One draw of random_int() gives a gene: its remainder modulo GENE_SYMBOLS is the column of the alias table,
+ * and its quotient the coin deciding between the column and its alias.
+ * @param model The model.
+ * @return The new individual. Its genome is NULL if the allocation failed.
+*/
+Individual sample_individual(const EdaModel *model){
+    Individual c;
+    c.min_size = model->min_size;
+    c.max_size = model->max_size;
+    // Draw the length by inverting the cumulative distribution, there are few lengths
+    int lengths = model->max_size - model->min_size + 1;
+    float u = (float) random_int() / ((float) RAND_MAX + 1.0f);
+    int l = 0;
+    while (l < lengths - 1 && u >= model->length_probabilities[l]){
+        u -= model->length_probabilities[l];
+        l++;
+    }
+    c.size = model->min_size + l;
+    c.genome = allocate_genome(sizeof(Gene) * (c.size + 1));
+    if (c.genome == NULL)
+        return c;
+    const float coin_scale = 1.0f / ((float) (RAND_MAX / GENE_SYMBOLS) + 1.0f);
+    for (int i = 0; i < c.size; i++){
+        int r = random_int();
+        int k = r % GENE_SYMBOLS;
+        float coin = (float) (r / GENE_SYMBOLS) * coin_scale;
+        int row = i * GENE_SYMBOLS;
+        int gene = coin < model->alias_probabilities[row + k] ? k : model->aliases[row + k];
+        c.genome[i] = (Gene) (gene + MINCHAR);
+    }
+    c.genome[c.size] = '\0';
+    return c;
+}
+
+/**
+ * @brief Learns a distribution from counts with the update rule of the model.
+ * @param model The model.
+ * @param probabilities The distribution to update.
+ * @param counts The counts of the selected individuals, overwritten.
+ * @param size The number of symbols.
+ * @param total The number of selected individuals counted. The distribution is kept when it is 0.
+*/
+static void learn_distribution(const EdaModel *model, float *probabilities, float *counts, int size, size_t total){
+    if (total == 0)
+        return;
+    float rate = model->algorithm == EDA_PBIL ? model->learning_rate : 1.0f;
+    for (int k = 0; k < size; k++)
+        probabilities[k] = (1.0f - rate) * probabilities[k] + rate * counts[k] / total;
+    bound_distribution(probabilities, size);
+}
+
+/**
+ * @brief Learns the model from the best individuals of a ranked population.
+ * @param model The model.
+ * @param p The population.
+ * @param ranking The ranking of the population.
+*/
+static void learn_model(EdaModel *model, Population p, const Ranking *ranking){
+    size_t selected_size = (size_t) (model->selection_rate * p.size);
+    if (selected_size == 0)
+        selected_size = 1;
+    int lengths = model->max_size - model->min_size + 1;
+    float *counts = model->frequencies;
+
+    memset(counts, 0, sizeof(float) * lengths);
+    for (size_t r = 0; r < selected_size; r++)
+        counts[p.individuals[ranking->order[r]].size - model->min_size] += 1.0f;
+    learn_distribution(model, model->length_probabilities, counts, lengths, selected_size);
+
+    for (int i = 0; i < model->max_size; i++){
+        size_t having = 0;
+        memset(counts, 0, sizeof(float) * GENE_SYMBOLS);
+        for (size_t r = 0; r < selected_size; r++){
+            Individual c = p.individuals[ranking->order[r]];
+            if (i < c.size){
+                counts[(unsigned char) c.genome[i] - MINCHAR] += 1.0f;
+                having++;
+            }
+        }
+        learn_distribution(model, model->probabilities + i * GENE_SYMBOLS, counts, GENE_SYMBOLS, having);
+    }
+    build_alias_tables(model);
+}
+
+/**
+ * @brief Creates a new generation of individuals by estimation of distribution.
+ * It can replace make_generation: the population is evaluated and ranked once, the model is learnt from
+ * the selection_rate best individuals (UMDA or PBIL), and the new generation is the best individual
+ * followed by individuals sampled from the model. The statistics are the ones of make_generation, so the
+ * two engines can be compared on the number of evaluations and the time to solution.
+ * @param p The population to generate the new generation from, of individuals between the sizes of the model.
+ * @param word The target word to evolve towards.
+ * @param model The model, updated.
+ * @param fitness_function The fitness function to use to evaluate individuals.
+ * @param fitness_optional_datas Optional data to be passed to the fitness function.
+ * @param ranking The ranking of the evaluated population, reused across generations. NULL to use a temporary one.
+ * @param stats The statistics of the generation, or NULL. Its reporting function is set by the caller.
+ * @return The new generation of individuals.
+*/
+Population eda_generation(Population p, const char *word, EdaModel *model, FitnessFunction fitness_function, void *fitness_optional_datas,\
+                          Ranking *ranking, GenerationStats *stats){
+    size_t population_size = p.size;
+    int64_t exact_index = -1;
+    Ranking temporary_ranking;
+    GenerationStats temporary_stats = {0};
+
+    if (stats == NULL)
+        stats = &temporary_stats;
+    reset_generation_stats(stats);
+    if (population_size == 0)
+        return p;
+    int generation = p.generation;
+    GA_PROBE2(generation_start, generation, population_size);
+    if (ranking == NULL){
+        temporary_ranking = create_ranking(population_size);
+        ranking = &temporary_ranking;
+    }
+    if (reserve_ranking(ranking, population_size) != 0)
+        goto end;
+
+    PHASE_START(start);
+    PROFILE_START(ticks);
+    stats->evaluations = population_size;
+    for (size_t i = 0; i < population_size; i++){
+        if (p.stop != NULL && i % STOP_CHECK_INTERVAL == 0 && stop_requested(p.stop)){
+            stats->evaluations = i;
+            break;
+        }
+        ranking->scores[i] = fitness_function(p.individuals[i].genome, word, fitness_optional_datas);
+        if (exact_index == -1 && ranking->scores[i] <= EPSILON && strcmp(p.individuals[i].genome, word) == 0)
+            exact_index = (int64_t) i;
+        if (p.stop != NULL && is_winner(p.stop, p.individuals[i].genome, ranking->scores[i], word)){
+            if (claim_stop(p.stop, p.individuals[i].genome, ranking->scores[i])){
+                stats->best_index = (int64_t) i;
+                stats->best_score = ranking->scores[i];
+                stats->exact_match = exact_index != -1;
+            }
+            stats->evaluations = i + 1;
+            break;
+        }
+    }
+    PROFILE_LAP(PROFILE_FITNESS, ticks);
+    PHASE_END(stats, PHASE_FITNESS, start);
+    // Stopped by this population or by another one sharing the signal: the population is returned as evaluated
+    if (p.stop != NULL && stop_requested(p.stop)){
+        stats->stopped = 1;
+        goto end;
+    }
+
+    if (rank_scores(ranking, population_size) != 0)
+        goto end;
+    size_t best_index = exact_index != -1 ? (size_t) exact_index : ranking->best_index;
+    double variance = 0.0;
+    for (size_t i = 0; i < population_size; i++){
+        double deviation = ranking->scores[i] - ranking->mean_score;
+        variance += deviation * deviation;
+    }
+    stats->best_score = ranking->scores[best_index];
+    stats->mean_score = ranking->mean_score;
+    stats->variance_score = (float) (variance / population_size);
+    stats->exact_match = exact_index != -1;
+    if (stats->reporting_function != NULL)
+        stats->reporting_score = stats->reporting_function(p.individuals[best_index].genome, word, stats->reporting_optional_datas);
+    PROFILE_LAP(PROFILE_RANKING, ticks);
+    PHASE_END(stats, PHASE_RANKING, start);
+
+    learn_model(model, p, ranking);
+    PROFILE_LAP(PROFILE_SELECTION, ticks);
+    PHASE_END(stats, PHASE_SELECTION, start);
+
+    // The best individual is kept as the individual 0, the others are sampled from the model
+    GenomeArena *previous_arena = NULL;
+    if (p.arena != NULL){
+        previous_arena = set_genome_arena(p.arena);
+        flip_genome_arena(p.arena);
+    }
+    Workspace *previous_workspace = p.workspace != NULL ? set_workspace(p.workspace) : NULL;
+    Individual best = p.individuals[best_index];
+    Individual elite = best;
+    elite.genome = allocate_genome(sizeof(Gene) * (best.size + 1));
+    if (elite.genome != NULL){
+        memcpy(elite.genome, best.genome, sizeof(Gene) * (best.size + 1));
+        for (size_t i = 0; i < population_size; i++)
+            free_individual(p.individuals[i]);
+        p.individuals[0] = elite;
+        for (size_t i = 1; i < population_size; i++)
+            p.individuals[i] = sample_individual(model);
+        p.generation++;
+        stats->best_index = 0;
+        if (p.diversity != NULL){
+            count_diversity(p.diversity, p.individuals, population_size);
+            stats->entropy = diversity_entropy(p.diversity, NULL);
+            stats->consensus_distance = diversity_consensus_distance(p.diversity);
+        }
+    }
+    if (p.arena != NULL)
+        set_genome_arena(previous_arena);
+    if (p.workspace != NULL)
+        set_workspace(previous_workspace);
+    PROFILE_LAP(PROFILE_REFILL, ticks);
+    PHASE_END(stats, PHASE_BREEDING, start);
+
+end:
+    if (ranking == &temporary_ranking)
+        free_ranking(temporary_ranking);
+    GA_PROBE3(generation_end, generation, stats->evaluations, stats->exact_match);
+    return p;
+}
@@ -134,6 +134,45 @@ char* intersection_set(const char* set1, const char* set2) {
     return save_intersection_set;
 }
 
+/**
+ * @brief Counts the mismatches between two strings of known length, plus their length difference.
+ * Complexity :  O(min(m,n)) which m,n are strings length
+ * @param individual The first string.
+ * @param n The length of the first string.
+ * @param word The second string.
+ * @param m The length of the second string.
+ * @return The modified Hamming distance between the two strings.
+ */
+static inline int hamming_kernel(const char *individual, int n, const char *word, int m) {
+    int sum, min_mn, i;
+
+    min_mn = n < m ? n : m;
+
+    // If the lengths are different, add the difference to the sum
+    sum = n > m ? n - m : m - n;
+
+    // Compute the Hamming distance between the two strings
+    for (i = 0; i < min_mn; i++)
+        if (individual[i] != word[i])
+            sum++;
+    return sum;
+}
+
+/**
+ * @brief Calculates the modified Hamming distance between two strings.
+ *
+ * The modified Hamming distance is the number of characters that differ between the two strings, plus the absolute
+ * difference between the lengths of the two strings. It is bounded by the length of the longer string.
+ * Complexity :  O(min(m,n)) which m,n are strings length
+ * @param individual The first string.
+ * @param word The second string.
+ * @param optional_datas Optional parameters for the function.
+ * @return The raw distance, where 0 represents a perfect match.
+ */
+int modified_hamming_distance(const char *individual, const char *word, void * optional_datas) {
+    return hamming_kernel(individual, len(individual), word, len(word));
+}
+
 /**
  * @brief Calculates the modified Hamming distance between two strings and returns it as a fitness score.
  *
@@ -148,55 +187,28 @@ char* intersection_set(const char* set1, const char* set2) {
  * @return The fitness score, where a value of 0 represents a perfect match and a value of 1 represents a complete mismatch.
  */
 float modified_hamming_distance_fitness(const char *individual, const char *word, void * optional_datas) {
-    int n, m, sum, min_mn, max_mn, i;
-    const char *s1, *s2;
-
-    // Calculate the length of each string
-    n = len(individual);
-    m = len(word);
-
-    // Determine the shorter string
-    if (m < n){ 
-        min_mn = m; 
-        max_mn = n;
-        s1 = word; 
-        s2 = individual;
-    }else{
-        min_mn = n;
-        max_mn = m;
-        s1 = individual;
-        s2 = word;
-    }
-
-    // If the lengths are different, add the difference to the sum
-    if (max_mn != min_mn){ 
-        sum = max_mn - min_mn; 
-    }else{
-        sum = 0;
-    }
-
-    // Compute the Hamming distance between the two strings
-    for (i = 0; i < min_mn; i++)
-        if (*(s1++) != *(s2++))
-            sum++;
+    int n = len(individual);
+    int m = len(word);
+    int max_mn = n > m ? n : m;
 
     // Normalize the distance by the length of the longer string
-    return (float)sum / max_mn;
+    return (float)hamming_kernel(individual, n, word, m) / max_mn;
 }
 
 /**
- * @brief Calculate the Levenshtein distance between two strings and return the fitness value.
+ * @brief Computes the Levenshtein distance between two strings of known length.
  * Complexity O(mn)
  *
  * @param individual The first string to compare.
+ * @param n The length of the first string.
  * @param word The second string to compare.
- * @param optional_datas Optional data that can be passed to the function.
- * @return The fitness value as a floating point number.
+ * @param m The length of the second string.
+ * @return The number of insertions, deletions and substitutions needed to turn one string into the other.
  */
-float levenstein_distance_fitness(const char *individual, const char *word, void *optional_datas) {
-    int n, m, max_len, i, j , i_pred, j_pred, cost, pred_cost;
-    n = len(individual)+1;
-    m = len(word)+1;
+static inline int levenstein_kernel(const char *individual, int n, const char *word, int m) {
+    int max_len, i, j , i_pred, j_pred, cost, pred_cost;
+    n++;
+    m++;
     max_len = n > m ? n : m;
 
     int distances[n][m];
@@ -220,46 +232,68 @@ float levenstein_distance_fitness(const char *individual, const char *word, void
             }
         }
     }
-    int m_len = max_len == 1 ? 1 : max_len -1;
-    return (float)(distances[n-1][m-1]) / m_len;
+    return distances[n-1][m-1];
 }
 
 /**
- * @brief Computes the Smith-Waterman similarity score between two strings.
+ * @brief Calculate the Levenshtein distance between two strings.
+ * The distance is bounded by the length of the longer string.
+ * Complexity O(mn)
+ *
+ * @param individual The first string to compare.
+ * @param word The second string to compare.
+ * @param optional_datas Optional data that can be passed to the function.
+ * @return The raw edit distance, where 0 represents a perfect match.
+ */
+int levenstein_distance(const char *individual, const char *word, void *optional_datas) {
+    return levenstein_kernel(individual, len(individual), word, len(word));
+}
+
+/**
+ * @brief Calculate the Levenshtein distance between two strings and return the fitness value.
+ * Complexity O(mn)
+ *
+ * @param individual The first string to compare.
+ * @param word The second string to compare.
+ * @param optional_datas Optional data that can be passed to the function.
+ * @return The fitness value as a floating point number.
+ */
+float levenstein_distance_fitness(const char *individual, const char *word, void *optional_datas) {
+    int n = len(individual);
+    int m = len(word);
+    int max_len = n > m ? n : m;
+    int m_len = max_len == 0 ? 1 : max_len;
+    return (float)levenstein_kernel(individual, n, word, m) / m_len;
+}
+
+/**
+ * @brief Computes the best Smith-Waterman local alignment score between two strings of known length.
  * 
- * The Smith-Waterman algorithm is a dynamic programming algorithm that computes 
- * the similarity between two strings by finding the optimal local alignment 
- * between them. This function implements the algorithm with a match score of 2, 
- * a mismatch score of -1, and a gap penalty of -1. The complexity of the 
- * algorithm is O(mn), where m and n are the lengths of the two input strings.
+ * The match score is 2, the mismatch score is -1 and the gap penalty is -1.
+ * The complexity of the algorithm is O(mn), where m and n are the lengths of the two input strings.
  * 
  * @param individual The first input string.
+ * @param n The length of the first string.
  * @param word The second input string.
- * @param optional_datas An optional pointer to additional data that can be used 
- *                            by the function (not used in this implementation).
- * @return The Smith-Waterman similarity score between the two input strings, 
- *         normalized by the maximum possible score.
- * @retval -1.0f if an error occurred during memory allocation for the score matrix.
+ * @param m The length of the second string.
+ * @return The maximum alignment score, bounded by twice the length of the shorter string.
+ * @retval -1 if an error occurred during memory allocation for the score matrix of a long word.
  */
-float smith_waterman(const char *individual, const char *word, void * optional_datas) {
+static inline int smith_waterman_kernel(const char *individual, int n, const char *word, int m) {
     int match_score = 2, mismatch_score = -1, gap_penalty = -1;
-    int n, m, max_mn, max_score = 0, i, j, match, upper_left, max_value, diagonal, intermediate_calc;
-
-    // Calculate length of the two strings
-    n = len(individual);
-    m = len(word);
-
-    // Determine the maximum length between the two strings
-    max_mn = n > m ? n : m;
+    int max_score = 0, i, j, match, upper_left, max_value, diagonal, intermediate_calc;
 
     // Increase m to account for the initialization of score_matrix
     m++;
 
-    // Allocate memory for score_matrix
-    int *score_matrix = calloc(m, sizeof(int));
+    // The row of a word of usual length is kept on the stack, a longer one is allocated
+    int stack_matrix[SMITH_WATERMAN_STACK];
+    int *score_matrix = m <= SMITH_WATERMAN_STACK ? stack_matrix : calloc(m, sizeof(int));
     if (score_matrix == NULL) {
-        return -1.0f;
+        return -1;
     }
+    if (score_matrix == stack_matrix)
+        memset(stack_matrix, 0, m * sizeof(int));
 
     // Populate score_matrix
     for (i = 1; i < n + 1; i++) {
@@ -292,7 +326,62 @@ float smith_waterman(const char *individual, const char *word, void * optional_d
     }
     
     // Free memory allocated for score_matrix
-    free(score_matrix);
+    if (score_matrix != stack_matrix)
+        free(score_matrix);
+
+    return max_score;
+}
+
+/**
+ * @brief Computes the Smith-Waterman distance between two strings.
+ * 
+ * The distance is the maximum possible alignment score (twice the length of the longer string)
+ * minus the best local alignment score, so it is bounded by twice the length of the longer string.
+ * 
+ * @param individual The first input string.
+ * @param word The second input string.
+ * @param optional_datas An optional pointer to additional data that can be used 
+ *                            by the function (not used in this implementation).
+ * @return The raw distance, where 0 represents a perfect match.
+ * @retval -1 if an error occurred during memory allocation for the score matrix.
+ */
+int smith_waterman_distance(const char *individual, const char *word, void * optional_datas) {
+    int n = len(individual);
+    int m = len(word);
+    int max_mn = n > m ? n : m;
+    int max_score = smith_waterman_kernel(individual, n, word, m);
+    if (max_score < 0)
+        return -1;
+    return (max_mn << 1) - max_score;
+}
+
+/**
+ * @brief Computes the Smith-Waterman similarity score between two strings.
+ * 
+ * The Smith-Waterman algorithm is a dynamic programming algorithm that computes 
+ * the similarity between two strings by finding the optimal local alignment 
+ * between them. This function implements the algorithm with a match score of 2, 
+ * a mismatch score of -1, and a gap penalty of -1. The complexity of the 
+ * algorithm is O(mn), where m and n are the lengths of the two input strings.
+ * 
+ * @param individual The first input string.
+ * @param word The second input string.
+ * @param optional_datas An optional pointer to additional data that can be used 
+ *                            by the function (not used in this implementation).
+ * @return The Smith-Waterman similarity score between the two input strings, 
+ *         normalized by the maximum possible score.
+ * @retval -1.0f if an error occurred during memory allocation for the score matrix.
+ */
+float smith_waterman(const char *individual, const char *word, void * optional_datas) {
+    int n = len(individual);
+    int m = len(word);
+
+    // Determine the maximum length between the two strings
+    int max_mn = n > m ? n : m;
+
+    int max_score = smith_waterman_kernel(individual, n, word, m);
+    if (max_score < 0)
+        return -1.0f;
 
     // Return the Smith-Waterman similarity score
     return 1.0f - (float)(max_score) / (max_mn << 1);
@@ -311,46 +400,37 @@ float jaccard_similarity_fitness(const char *individual, const char *word, void
     // Calculate the length of the difference between the two strings
     int diff_len = abs(len(individual) - len(word));
     
-    // Convert the strings to sets and calculate the union and intersection sets
-    char * individual_set = to_set(individual);
-    char * word_set = to_set(word);
-    char * union_set_str = union_set(individual_set, word_set);
-    char * intersection_set_str = intersection_set(individual_set, word_set);
+    // Mark the characters of each string, the sets are the marked characters
+    char individual_set[256] = {0};
+    char word_set[256] = {0};
+    for (const char *c = individual; *c != '\0'; c++)
+        individual_set[(unsigned char) *c] = 1;
+    for (const char *c = word; *c != '\0'; c++)
+        word_set[(unsigned char) *c] = 1;
 
     // Calculate the length of the union and intersection sets
-    int len_union_set = len(union_set_str);
-    int len_intersection_set = len(intersection_set_str);
+    int len_union_set = 0;
+    int len_intersection_set = 0;
+    for (int c = 0; c < 256; c++){
+        len_union_set += individual_set[c] | word_set[c];
+        len_intersection_set += individual_set[c] & word_set[c];
+    }
 
     // Calculate the Jaccard similarity distance
     float jaccard_similarity = (float)len_intersection_set / (len_union_set + diff_len);
-    
-    // Free the dynamically allocated memory used for the sets and their union/intersection
-    free(individual_set);
-    free(word_set);
-    free(union_set_str);
-    free(intersection_set_str);
 
     return 1 - jaccard_similarity;
 }
 
 /**
- * @brief Calculates the fitness score of an individual using the Normalized Longest Common Subsequence (NLCS) algorithm.
- *
- * The NLCS algorithm measures the similarity between two strings by calculating their longest common subsequence (LCS) and 
- * normalizing it by the length of the longer string.
- *
- * @param[in] individual The first string to compare.
- * @param[in] word The second string to compare.
- * @param[in] optional_datas Optional data that can be passed to the function. Not used in this implementation.
- * 
- * @return The fitness score of the individual. The score is a float between 0 and 1, where 1 means that the two strings are 
- *         identical and 0 means that they have no common characters.
+ * @brief Computes the longest common subsequence length used by the NLCS fitness.
+ * @param individual The first string to compare.
+ * @param n The length of the first string.
+ * @param word The second string to compare.
+ * @param m The length of the second string.
+ * @return The length of the longest common subsequence, bounded by the length of the shorter string.
  */
-float nlcs_fitness(const char * individual, const char * word, void * optional_datas){
-    int n = len(individual);
-    int m = len(word);
-    int max_mn = n > m ? n : m;
-
+static inline int nlcs_kernel(const char * individual, int n, const char * word, int m){
     int match_matrix[n][m];
 
     // Init match_matrix
@@ -377,9 +457,48 @@ float nlcs_fitness(const char * individual, const char * word, void * optional_d
             }
         }
     }
-    
+    return lcs_length;
+}
+
+/**
+ * @brief Computes the NLCS distance between two strings.
+ *
+ * The distance is the length of the longer string minus the length of the longest common subsequence,
+ * so it is bounded by the length of the longer string.
+ *
+ * @param[in] individual The first string to compare.
+ * @param[in] word The second string to compare.
+ * @param[in] optional_datas Optional data that can be passed to the function. Not used in this implementation.
+ * 
+ * @return The raw distance, where 0 represents a perfect match.
+ */
+int nlcs_distance(const char * individual, const char * word, void * optional_datas){
+    int n = len(individual);
+    int m = len(word);
+    int max_mn = n > m ? n : m;
+    return max_mn - nlcs_kernel(individual, n, word, m);
+}
+
+/**
+ * @brief Calculates the fitness score of an individual using the Normalized Longest Common Subsequence (NLCS) algorithm.
+ *
+ * The NLCS algorithm measures the similarity between two strings by calculating their longest common subsequence (LCS) and 
+ * normalizing it by the length of the longer string.
+ *
+ * @param[in] individual The first string to compare.
+ * @param[in] word The second string to compare.
+ * @param[in] optional_datas Optional data that can be passed to the function. Not used in this implementation.
+ * 
+ * @return The fitness score of the individual. The score is a float between 0 and 1, where 1 means that the two strings are 
+ *         identical and 0 means that they have no common characters.
+ */
+float nlcs_fitness(const char * individual, const char * word, void * optional_datas){
+    int n = len(individual);
+    int m = len(word);
+    int max_mn = n > m ? n : m;
+
     // Return 1 - Normalize LCS
-    return 1 - (float) lcs_length / max_mn;
+    return 1 - (float) nlcs_kernel(individual, n, word, m) / max_mn;
 }
 
 /**
@@ -438,8 +557,7 @@ float cosine_similarity_fitness(const char* individual, const char* word, void *
 */
 float ngram_overlap_fitness(const char* individual, const char* word, void * optional_datas) {
     int n = 2;
-    int i, j, k, count1, count2, intersection, _union, len1, len2, min_len;
-    char ngram1[n+1], ngram2[n+1];
+    int i, j, intersection, _union, len1, len2, min_len;
     
     // Get the lengths of the two strings and determine the minimum length
     len1 = len(individual);
@@ -449,25 +567,11 @@ float ngram_overlap_fitness(const char* individual, const char* word, void * opt
     // Make sure n is not greater than the minimum length
     n = n > min_len ? min_len : n;
     
-    // Allocate memory for the n-gram arrays
-    char** ngrams1 = (char**) malloc(sizeof(char*) * (len1 - n + 1));
-    char** ngrams2 = (char**) malloc(sizeof(char*) * (len2 - n + 1));
-    for (i = 0; i < len1 - n + 1; i++) {
-        ngrams1[i] = (char*) malloc(sizeof(char) * (n+1));
-        strncpy(ngrams1[i], &individual[i], n);
-        ngrams1[i][n] = '\0';
-    }
-    for (i = 0; i < len2 - n + 1; i++) {
-        ngrams2[i] = (char*) malloc(sizeof(char) * (n+1));
-        strncpy(ngrams2[i], &word[i], n);
-        ngrams2[i][n] = '\0';
-    }
-    
-    // Compute the intersection of the two sets of n-grams
+    // Compute the intersection of the two sets of n-grams, compared in place in the strings
     intersection = 0;
     for (i = 0; i < len1 - n + 1; i++) {
         for (j = 0; j < len2 - n + 1; j++) {
-            if (strcmp(ngrams1[i], ngrams2[j]) == 0) {
+            if (memcmp(&individual[i], &word[j], n) == 0) {
                 intersection++;
                 break;
             }
@@ -480,31 +584,20 @@ float ngram_overlap_fitness(const char* individual, const char* word, void * opt
     // Compute the n-gram overlap score
     float overlap_score = (float) intersection / (float) _union;
     
-    // Free the memory allocated for the n-gram arrays
-    for (i = 0; i < len1 - n + 1; i++) {
-        free(ngrams1[i]);
-    }
-    for (i = 0; i < len2 - n + 1; i++) {
-        free(ngrams2[i]);
-    }
-    free(ngrams1);
-    free(ngrams2);
-    
     return 1 - overlap_score;
 }
 
 /**
- * @brief Calculates the Manhattan distance between two strings, normalized by the maximum possible distance.
+ * @brief Sums the absolute character differences between two strings of known length.
+ * Every missing character of the shorter string costs 96, the maximum distance between two characters in the model.
  * @param individual The first string to compare.
+ * @param n The length of the first string.
  * @param word The second string to compare.
- * @param optional_datas Unused optional data.
- * @return The Manhattan distance fitness as the inverse of the distance, normalized by the maximum possible distance.
+ * @param m The length of the second string.
+ * @return The Manhattan distance between the two strings.
 */
-float manhattan_distance_fitness(const char* individual, const char* word, void * optional_datas) {
-    int n = len(individual);
-    int m = len(word);
+static inline long manhattan_kernel(const char* individual, int n, const char* word, int m) {
     int min_mn = n < m ? n : m;
-    int max_mn = n < m ? m : n;
     int i = 0;
     long manhattan_distance = 0;
 
@@ -512,8 +605,35 @@ float manhattan_distance_fitness(const char* individual, const char* word, void
     for (; i < min_mn; i++) 
         manhattan_distance += abs(individual[i] - word[i]);
     manhattan_distance += abs(m-n) * 96;
+    return manhattan_distance;
+}
+
+/**
+ * @brief Calculates the Manhattan distance between two strings.
+ * The distance is bounded by 96 times the length of the longer string.
+ * @param individual The first string to compare.
+ * @param word The second string to compare.
+ * @param optional_datas Unused optional data.
+ * @return The raw distance, where 0 represents a perfect match.
+*/
+int manhattan_distance(const char* individual, const char* word, void * optional_datas) {
+    return (int) manhattan_kernel(individual, len(individual), word, len(word));
+}
+
+/**
+ * @brief Calculates the Manhattan distance between two strings, normalized by the maximum possible distance.
+ * @param individual The first string to compare.
+ * @param word The second string to compare.
+ * @param optional_datas Unused optional data.
+ * @return The Manhattan distance fitness as the inverse of the distance, normalized by the maximum possible distance.
+*/
+float manhattan_distance_fitness(const char* individual, const char* word, void * optional_datas) {
+    int n = len(individual);
+    int m = len(word);
+    int max_mn = n < m ? m : n;
+
     // Compute the Manhattan distance fitness as the inverse of the distance
-    float manhattan_distance_fitness = manhattan_distance /(max_mn * 96.0f); // 96 is the maximum distance between two characters in the model
+    float manhattan_distance_fitness = manhattan_kernel(individual, n, word, m) /(max_mn * 96.0f); // 96 is the maximum distance between two characters in the model
 
     return manhattan_distance_fitness;
 }
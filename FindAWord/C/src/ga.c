@@ -0,0 +1,156 @@
+#include <ga.h>
+#include <jobs.h>
+
+/**
+ * @brief State of an engine, hidden from the users of ga.h.
+*/
+struct ga_engine {
+    JobConfig config;                       /**< The parameters of the search. */
+    char *word;                             /**< The target word. */
+    Worker worker;                          /**< The genome arena, workspace, ranking and stop signal of the engine. */
+    Population population;                  /**< The current population. */
+    GenerationFunction generation_function; /**< The generation variant of the operators, or NULL. */
+    GenerationStats stats;                  /**< Statistics of the last generation. */
+    uint64_t random_state;                  /**< State of the random generator between two steps. */
+    GaStats totals;                         /**< Statistics since the creation of the engine. */
+};
+
+/**
+ * @brief Creates an engine and its first population.
+ * @param config The parameters of the engine.
+ * @return The engine, or NULL if a parameter is invalid or the allocation failed.
+*/
+GaEngine *ga_create(const GaConfig *config){
+    if (config == NULL || config->word == NULL)
+        return NULL;
+    int length = strlen(config->word);
+    if (length == 0 || length > JOB_MAX_WORD)
+        return NULL;
+    GaEngine *engine = calloc(1, sizeof(GaEngine));
+    if (engine == NULL)
+        return NULL;
+    engine->config = default_job_config();
+    if (config->population_size > 1)
+        engine->config.population_size = config->population_size;
+    engine->config.fixed_length = config->fixed_length;
+    engine->config.diversity = config->diversity;
+    const char *kinds[] = {"fitness", "selection", "pairing", "crossover", "mutation"};
+    const char *names[] = {config->fitness, config->selection, config->pairing, config->crossover, config->mutation};
+    for (int i = 0; i < 5; i++)
+        if (names[i] != NULL && set_job_operator(&engine->config, kinds[i], names[i]) != 0){
+            free(engine);
+            return NULL;
+        }
+    engine->word = strdup(config->word);
+    if (engine->word == NULL || prepare_worker(&engine->worker, engine->config.population_size) != 0){
+        free_worker(&engine->worker);
+        free(engine->word);
+        free(engine);
+        return NULL;
+    }
+    engine->generation_function = find_generation_variant(engine->config.fitness_function, engine->config.selection_function,\
+                                  engine->config.pairing_function, engine->config.crossover_function, engine->config.mutation_function);
+
+    // The engine draws from its own random sequence, the one of the calling thread is left as it was
+    uint64_t thread_state = random_state;
+    seed_random(config->seed);
+    int min_size = engine->config.fixed_length ? length : 1;
+    int max_size = engine->config.fixed_length ? length : 2 * length;
+    GenomeArena *previous_arena = set_genome_arena(engine->worker.arena);
+    Workspace *previous_workspace = set_workspace(engine->worker.workspace);
+    engine->population = create_population(engine->config.population_size, min_size, max_size);
+    set_genome_arena(previous_arena);
+    set_workspace(previous_workspace);
+    engine->population.arena = engine->worker.arena;
+    engine->population.workspace = engine->worker.workspace;
+    engine->population.stop = engine->worker.stop;
+    engine->population.score_cache = engine->worker.score_cache;
+    if (engine->config.diversity){
+        engine->population.diversity = create_diversity(max_size);
+        if (engine->population.diversity == NULL){
+            random_state = thread_state;
+            ga_destroy(engine);
+            return NULL;
+        }
+        count_diversity(engine->population.diversity, engine->population.individuals, engine->population.size);
+    }
+    engine->stats.best_index = -1;
+    engine->random_state = random_state;
+    random_state = thread_state;
+    return engine;
+}
+
+/**
+ * @brief Runs generations until the word is found.
+ * @param engine The engine.
+ * @param generations The maximum number of generations to run.
+ * @return The number of generations run, the one finding the word included, so 0 only when the word was
+ * found by an earlier call. -1 if the engine is NULL.
+*/
+int ga_step(GaEngine *engine, int generations){
+    if (engine == NULL)
+        return -1;
+    double start = now_seconds();
+    uint64_t thread_state = random_state;
+    random_state = engine->random_state;
+    JobConfig *config = &engine->config;
+    Ranking *ranking = &engine->worker.ranking;
+    int run = 0;
+    while (run < generations && !engine->totals.solved){
+        if (engine->generation_function != NULL)
+            engine->population = engine->generation_function(engine->population, engine->word, ranking, &engine->stats);
+        else
+            engine->population = make_generation(engine->population, engine->word, config->fitness_function, NULL,\
+                                 config->selection_function, NULL, config->pairing_function, ranking,\
+                                 config->crossover_function, NULL, config->mutation_function, NULL, ranking, &engine->stats);
+        run++;
+        engine->totals.evaluations += engine->stats.evaluations;
+        engine->totals.solved = engine->stats.exact_match;
+    }
+    engine->random_state = random_state;
+    random_state = thread_state;
+    engine->totals.generations += run;
+    engine->totals.best_score = engine->stats.best_score;
+    engine->totals.mean_score = engine->stats.mean_score;
+    engine->totals.entropy = engine->stats.entropy;
+    engine->totals.consensus_distance = engine->stats.consensus_distance;
+    engine->totals.elapsed += now_seconds() - start;
+    return run;
+}
+
+/**
+ * @brief Returns the best individual of the last generation.
+ * @param engine The engine.
+ * @return The genome of the individual, valid until the next ga_step, or NULL before the first one.
+*/
+const char *ga_best(const GaEngine *engine){
+    if (engine == NULL || engine->stats.best_index < 0)
+        return NULL;
+    return engine->population.individuals[engine->stats.best_index].genome;
+}
+
+/**
+ * @brief Returns the statistics of an engine since its creation.
+ * @param engine The engine.
+ * @return The statistics, zeroed if the engine is NULL.
+*/
+GaStats ga_stats(const GaEngine *engine){
+    GaStats stats = {0};
+    if (engine != NULL)
+        stats = engine->totals;
+    return stats;
+}
+
+/**
+ * @brief Frees an engine.
+ * @param engine The engine, or NULL.
+*/
+void ga_destroy(GaEngine *engine){
+    if (engine == NULL)
+        return;
+    free_diversity(engine->population.diversity);
+    free_population(engine->population);
+    free_worker(&engine->worker);
+    free(engine->word);
+    free(engine);
+}
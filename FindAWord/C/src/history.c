@@ -0,0 +1,600 @@
+#include <history.h>
+
+const HistoryColumnInfo history_columns[HISTORY_COLUMN_COUNT] = {
+    {"generation", HISTORY_INT32, sizeof(int32_t)},
+    {"evaluations", HISTORY_UINT64, sizeof(uint64_t)},
+    {"best_score", HISTORY_FLOAT, sizeof(float)},
+    {"mean_score", HISTORY_FLOAT, sizeof(float)},
+    {"variance_score", HISTORY_FLOAT, sizeof(float)},
+    {"reporting_score", HISTORY_FLOAT, sizeof(float)},
+    {"duplicate_ratio", HISTORY_FLOAT, sizeof(float)},
+    {"entropy", HISTORY_FLOAT, sizeof(float)},
+    {"consensus_distance", HISTORY_FLOAT, sizeof(float)},
+    {"exact_match", HISTORY_INT32, sizeof(int32_t)},
+    {"time", HISTORY_DOUBLE, sizeof(double)},
+};
+
+/**
+ * @brief Computes the offset of every column in a block.
+ * @param offsets The offsets, filled.
+ * @return The size of a block in bytes.
+*/
+static size_t column_offsets(size_t offsets[HISTORY_COLUMN_COUNT]){
+    size_t offset = 0;
+    for (int c = 0; c < HISTORY_COLUMN_COUNT; c++){
+        offsets[c] = offset;
+        offset += history_columns[c].width * HISTORY_BLOCK;
+    }
+    return offset;
+}
+
+/**
+ * @brief Writes a buffer at an offset of a file, retrying the partial writes.
+ * @param fd The file.
+ * @param data The buffer.
+ * @param size The number of bytes.
+ * @param offset The offset in the file.
+ * @return 0 on success, -1 on failure.
+*/
+static int write_all(int fd, const void *data, size_t size, off_t offset){
+    const char *p = data;
+    while (size > 0){
+        ssize_t written = pwrite(fd, p, size, offset);
+        if (written <= 0)
+            return -1;
+        p += written;
+        size -= written;
+        offset += written;
+    }
+    return 0;
+}
+
+/**
+ * @brief Appends a buffer at the end of the history file. Nothing is written once a write failed.
+ * The buffers are aligned on 8 bytes, so the columns and the tables can be read in place from the mapped file.
+ * @param recorder The recorder.
+ * @param data The buffer.
+ * @param size The number of bytes.
+ * @return The offset of the buffer in the file.
+*/
+static uint64_t append(HistoryRecorder *recorder, const void *data, size_t size){
+    uint64_t offset = (recorder->end + 7) & ~(uint64_t) 7;
+    if (!recorder->failed && write_all(recorder->fd, data, size, offset) != 0)
+        recorder->failed = 1;
+    recorder->end = offset + size;
+    return offset;
+}
+
+/**
+ * @brief Makes room for one more block offset and snapshot entry.
+ * @param recorder The recorder.
+ * @param count The number of entries of the fuller table.
+ * @return 0 on success, -1 if the allocation failed.
+*/
+static int reserve_entries(HistoryRecorder *recorder, size_t count){
+    if (count < recorder->entries_capacity)
+        return 0;
+    size_t capacity = recorder->entries_capacity == 0 ? 64 : recorder->entries_capacity * 2;
+    uint64_t *block_offsets = realloc(recorder->block_offsets, sizeof(uint64_t) * capacity);
+    if (block_offsets == NULL)
+        return -1;
+    recorder->block_offsets = block_offsets;
+    HistorySnapshot *entries = realloc(recorder->snapshot_entries, sizeof(HistorySnapshot) * capacity);
+    if (entries == NULL)
+        return -1;
+    recorder->snapshot_entries = entries;
+    recorder->entries_capacity = capacity;
+    return 0;
+}
+
+/**
+ * @brief Writes the block being filled at the end of the file.
+ * @param recorder The recorder.
+*/
+static void write_block(HistoryRecorder *recorder){
+    size_t offsets[HISTORY_COLUMN_COUNT];
+    size_t block_size = column_offsets(offsets);
+    if (reserve_entries(recorder, recorder->header.block_count) != 0){
+        recorder->failed = 1;
+        return;
+    }
+    recorder->block_offsets[recorder->header.block_count++] = append(recorder, recorder->block, block_size);
+    recorder->block_fill = 0;
+}
+
+/**
+ * @brief Appends a record to the columns of the block being filled, and writes the block once it is full.
+ * @param recorder The recorder.
+ * @param record The record.
+*/
+static void add_record(HistoryRecorder *recorder, const HistoryRecord *record){
+    size_t offsets[HISTORY_COLUMN_COUNT];
+    column_offsets(offsets);
+    char *block = recorder->block;
+    size_t i = recorder->block_fill;
+    ((int32_t *) (block + offsets[HISTORY_GENERATION]))[i] = record->generation;
+    ((uint64_t *) (block + offsets[HISTORY_EVALUATIONS]))[i] = record->evaluations;
+    ((float *) (block + offsets[HISTORY_BEST_SCORE]))[i] = record->best_score;
+    ((float *) (block + offsets[HISTORY_MEAN_SCORE]))[i] = record->mean_score;
+    ((float *) (block + offsets[HISTORY_VARIANCE_SCORE]))[i] = record->variance_score;
+    ((float *) (block + offsets[HISTORY_REPORTING_SCORE]))[i] = record->reporting_score;
+    ((float *) (block + offsets[HISTORY_DUPLICATE_RATIO]))[i] = record->duplicate_ratio;
+    ((float *) (block + offsets[HISTORY_ENTROPY]))[i] = record->entropy;
+    ((float *) (block + offsets[HISTORY_CONSENSUS_DISTANCE]))[i] = record->consensus_distance;
+    ((int32_t *) (block + offsets[HISTORY_EXACT_MATCH]))[i] = record->exact_match;
+    ((double *) (block + offsets[HISTORY_TIME]))[i] = record->time;
+    recorder->header.record_count++;
+    if (++recorder->block_fill == HISTORY_BLOCK)
+        write_block(recorder);
+}
+
+/**
+ * @brief Writes a variable length integer, 7 bits per byte, the high bit set on every byte but the last.
+ * @param out The output.
+ * @param value The integer.
+ * @return The number of bytes written, at most 10.
+*/
+static size_t put_varint(uint8_t *out, uint64_t value){
+    size_t n = 0;
+    while (value >= 0x80){
+        out[n++] = (uint8_t) (value | 0x80);
+        value >>= 7;
+    }
+    out[n++] = (uint8_t) value;
+    return n;
+}
+
+/**
+ * @brief Reads a variable length integer written by put_varint.
+ * @param in The input, advanced past the integer.
+ * @param end The end of the input.
+ * @param value The integer.
+ * @return 0 on success, -1 if the integer is truncated.
+*/
+static int get_varint(const uint8_t **in, const uint8_t *end, uint64_t *value){
+    *value = 0;
+    for (int shift = 0; shift < 64 && *in < end; shift += 7){
+        uint8_t byte = *(*in)++;
+        *value |= (uint64_t) (byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return 0;
+    }
+    return -1;
+}
+
+/**
+ * @brief Codes the genomes of a snapshot buffer and appends them to the file.
+ * @param recorder The recorder.
+ * @param buffer The snapshot buffer.
+*/
+static void write_snapshot(HistoryRecorder *recorder, const HistorySnapshotBuffer *buffer){
+    // A genome is at worst three integers followed by runs of one equal and one different gene, 3 bytes for 2 genes
+    size_t bound = 2 * buffer->genomes_size + 30 * buffer->size;
+    if (bound > recorder->coded_capacity){
+        uint8_t *coded = realloc(recorder->coded, bound);
+        if (coded == NULL){
+            recorder->failed = 1;
+            return;
+        }
+        recorder->coded = coded;
+        recorder->coded_capacity = bound;
+    }
+    if (reserve_entries(recorder, recorder->header.snapshot_count) != 0){
+        recorder->failed = 1;
+        return;
+    }
+    uint8_t *out = recorder->coded;
+    const Gene *previous = "";
+    size_t previous_size = 0;
+    const Gene *genome = buffer->genomes;
+    for (size_t i = 0; i < buffer->size; i++){
+        size_t size = strlen(genome);
+        size_t shortest = size < previous_size ? size : previous_size;
+        size_t prefix = 0;
+        while (prefix < shortest && genome[prefix] == previous[prefix])
+            prefix++;
+        size_t suffix = 0;
+        while (prefix + suffix < shortest && genome[size - 1 - suffix] == previous[previous_size - 1 - suffix])
+            suffix++;
+        size_t middle = size - prefix - suffix;
+        out += put_varint(out, prefix);
+        out += put_varint(out, suffix);
+        out += put_varint(out, middle);
+        // The genes between the prefix and the suffix are compared position by position to the previous ones
+        const Gene *genes = genome + prefix;
+        const Gene *previous_genes = previous + prefix;
+        size_t previous_middle = previous_size - prefix - suffix;
+        size_t position = 0;
+        while (position < middle){
+            size_t equal = 0;
+            while (position + equal < middle && position + equal < previous_middle && genes[position + equal] == previous_genes[position + equal])
+                equal++;
+            position += equal;
+            size_t different = 0;
+            while (position + different < middle && (position + different >= previous_middle || genes[position + different] != previous_genes[position + different]))
+                different++;
+            out += put_varint(out, equal);
+            out += put_varint(out, different);
+            memcpy(out, genes + position, different);
+            out += different;
+            position += different;
+        }
+        previous = genome;
+        previous_size = size;
+        genome += size + 1;
+    }
+    HistorySnapshot *entry = &recorder->snapshot_entries[recorder->header.snapshot_count++];
+    entry->generation = buffer->generation;
+    entry->size = buffer->size;
+    entry->genomes_size = buffer->genomes_size;
+    entry->delta_coded = (size_t) (out - recorder->coded) < buffer->genomes_size;
+    if (entry->delta_coded){
+        entry->coded_size = out - recorder->coded;
+        entry->offset = append(recorder, recorder->coded, entry->coded_size);
+    }
+    else {
+        entry->coded_size = buffer->genomes_size;
+        entry->offset = append(recorder, buffer->genomes, entry->coded_size);
+    }
+}
+
+/**
+ * @brief Writes the last block, the tables and the completed header of the file.
+ * @param recorder The recorder.
+*/
+static void finish_history(HistoryRecorder *recorder){
+    if (recorder->block_fill > 0)
+        write_block(recorder);
+    HistoryHeader *header = &recorder->header;
+    header->dropped_records = recorder->dropped_records;
+    header->dropped_snapshots = recorder->dropped_snapshots;
+    header->blocks_offset = append(recorder, recorder->block_offsets, sizeof(uint64_t) * header->block_count);
+    header->snapshots_offset = append(recorder, recorder->snapshot_entries, sizeof(HistorySnapshot) * header->snapshot_count);
+    header->complete = 1;
+    if (!recorder->failed && write_all(recorder->fd, header, sizeof(HistoryHeader), 0) != 0)
+        recorder->failed = 1;
+}
+
+/**
+ * @brief Body of the writer thread: drains the ring buffer until the recorder is closed.
+ * @param datas The recorder.
+ * @return NULL.
+*/
+static void *history_thread(void *datas){
+    HistoryRecorder *recorder = datas;
+    size_t tail = atomic_load_explicit(&recorder->tail, memory_order_relaxed);
+    struct timespec poll_interval = {0, HISTORY_POLL_INTERVAL * 1000L};
+    for (;;){
+        // Read before the head, so the records queued before the close are drained
+        int closed = atomic_load_explicit(&recorder->closed, memory_order_acquire);
+        size_t head = atomic_load_explicit(&recorder->head, memory_order_acquire);
+        if (tail == head){
+            if (closed)
+                break;
+            nanosleep(&poll_interval, NULL);
+            continue;
+        }
+        while (tail != head){
+            const HistoryRecord *record = &recorder->ring[tail & (HISTORY_RING - 1)];
+            add_record(recorder, record);
+            if (record->snapshot >= 0){
+                HistorySnapshotBuffer *buffer = &recorder->snapshots[record->snapshot];
+                write_snapshot(recorder, buffer);
+                atomic_store_explicit(&buffer->filled, 0, memory_order_release);
+            }
+            tail++;
+            atomic_store_explicit(&recorder->tail, tail, memory_order_release);
+        }
+    }
+    finish_history(recorder);
+    return NULL;
+}
+
+/**
+ * @brief Creates a history file and starts the thread writing it.
+ * @param path The history file, replaced if it exists.
+ * @param word The target word, of at most JOB_MAX_WORD characters.
+ * @param snapshot_interval The number of generations between two snapshots of the population, 0 for no snapshot.
+ * @return The recorder, or NULL on failure.
+*/
+HistoryRecorder *create_history_recorder(const char *path, const char *word, int snapshot_interval){
+    size_t word_length = strlen(word);
+    if (word_length > JOB_MAX_WORD)
+        return NULL;
+    HistoryRecorder *recorder = calloc(1, sizeof(HistoryRecorder));
+    if (recorder == NULL)
+        return NULL;
+    size_t offsets[HISTORY_COLUMN_COUNT];
+    recorder->block = malloc(column_offsets(offsets));
+    recorder->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (recorder->block == NULL || recorder->fd == -1){
+        if (recorder->fd != -1)
+            close(recorder->fd);
+        free(recorder->block);
+        free(recorder);
+        return NULL;
+    }
+    HistoryHeader *header = &recorder->header;
+    memcpy(header->magic, HISTORY_MAGIC, sizeof(header->magic));
+    header->version = HISTORY_VERSION;
+    header->byte_order = HISTORY_BYTE_ORDER;
+    header->header_size = sizeof(HistoryHeader);
+    header->column_count = HISTORY_COLUMN_COUNT;
+    header->block_records = HISTORY_BLOCK;
+    header->word_length = word_length;
+    memcpy(header->word, word, word_length + 1);
+    // The header is written again with the tables once the recorder is freed
+    append(recorder, header, sizeof(HistoryHeader));
+    atomic_init(&recorder->head, 0);
+    atomic_init(&recorder->tail, 0);
+    atomic_init(&recorder->closed, 0);
+    atomic_init(&recorder->snapshots[0].filled, 0);
+    atomic_init(&recorder->snapshots[1].filled, 0);
+    recorder->snapshot_interval = snapshot_interval;
+    recorder->start_time = now_seconds();
+    if (recorder->failed || pthread_create(&recorder->thread, NULL, history_thread, recorder) != 0){
+        close(recorder->fd);
+        free(recorder->block);
+        free(recorder);
+        return NULL;
+    }
+    return recorder;
+}
+
+/**
+ * @brief Copies the genomes of a population in a free snapshot buffer.
+ * @param recorder The recorder.
+ * @param p The population.
+ * @return The index of the snapshot buffer, or -1 if both are being written or the allocation failed.
+*/
+static int copy_snapshot(HistoryRecorder *recorder, Population p){
+    for (int b = 0; b < 2; b++){
+        HistorySnapshotBuffer *buffer = &recorder->snapshots[b];
+        if (atomic_load_explicit(&buffer->filled, memory_order_acquire))
+            continue;
+        size_t genomes_size = 0;
+        for (size_t i = 0; i < p.size; i++)
+            genomes_size += p.individuals[i].size + 1;
+        if (genomes_size > buffer->capacity){
+            Gene *genomes = realloc(buffer->genomes, genomes_size);
+            if (genomes == NULL)
+                return -1;
+            buffer->genomes = genomes;
+            buffer->capacity = genomes_size;
+        }
+        Gene *genome = buffer->genomes;
+        for (size_t i = 0; i < p.size; i++){
+            memcpy(genome, p.individuals[i].genome, p.individuals[i].size);
+            genome[p.individuals[i].size] = '\0';
+            genome += p.individuals[i].size + 1;
+        }
+        buffer->generation = p.generation;
+        buffer->size = p.size;
+        buffer->genomes_size = genomes_size;
+        atomic_store_explicit(&buffer->filled, 1, memory_order_relaxed);
+        return b;
+    }
+    return -1;
+}
+
+/**
+ * @brief Queues the statistics of a generation, and a snapshot of the population every snapshot_interval generations.
+ * Called by the evolution loop after each generation. It does not lock nor wait: when the writer thread is
+ * behind, the record or the snapshot is dropped and counted in the header of the file.
+ * @param recorder The recorder.
+ * @param p The population returned by the generation.
+ * @param stats The statistics of the generation.
+ * @return 0 if the record was queued, -1 if it was dropped.
+*/
+int record_generation(HistoryRecorder *recorder, Population p, const GenerationStats *stats){
+    size_t head = atomic_load_explicit(&recorder->head, memory_order_relaxed);
+    if (head - recorder->cached_tail == HISTORY_RING){
+        recorder->cached_tail = atomic_load_explicit(&recorder->tail, memory_order_acquire);
+        if (head - recorder->cached_tail == HISTORY_RING){
+            recorder->dropped_records++;
+            return -1;
+        }
+    }
+    HistoryRecord *record = &recorder->ring[head & (HISTORY_RING - 1)];
+    record->generation = p.generation;
+    record->exact_match = stats->exact_match;
+    record->evaluations = stats->evaluations;
+    record->best_score = stats->best_score;
+    record->mean_score = stats->mean_score;
+    record->variance_score = stats->variance_score;
+    record->reporting_score = stats->reporting_score;
+    record->duplicate_ratio = stats->duplicate_ratio;
+    record->entropy = stats->entropy;
+    record->consensus_distance = stats->consensus_distance;
+    record->time = now_seconds() - recorder->start_time;
+    record->snapshot = -1;
+    if (recorder->snapshot_interval > 0 && p.generation % recorder->snapshot_interval == 0){
+        record->snapshot = copy_snapshot(recorder, p);
+        if (record->snapshot == -1)
+            recorder->dropped_snapshots++;
+    }
+    // Publishes the record and its snapshot to the writer thread
+    atomic_store_explicit(&recorder->head, head + 1, memory_order_release);
+    return 0;
+}
+
+/**
+ * @brief Drains the queued records, completes the history file and frees the recorder.
+ * @param recorder The recorder, or NULL.
+ * @return 0 if the whole history was written, -1 if a write failed.
+*/
+int free_history_recorder(HistoryRecorder *recorder){
+    if (recorder == NULL)
+        return 0;
+    atomic_store_explicit(&recorder->closed, 1, memory_order_release);
+    pthread_join(recorder->thread, NULL);
+    int result = recorder->failed ? -1 : 0;
+    if (close(recorder->fd) != 0)
+        result = -1;
+    free(recorder->snapshots[0].genomes);
+    free(recorder->snapshots[1].genomes);
+    free(recorder->block);
+    free(recorder->block_offsets);
+    free(recorder->snapshot_entries);
+    free(recorder->coded);
+    free(recorder);
+    return result;
+}
+
+/**
+ * @brief Maps a complete history file in memory and checks its header and tables.
+ * @param path The history file.
+ * @return The reader, or NULL if the file cannot be mapped or is not a complete history file of this version.
+*/
+HistoryReader *open_history(const char *path){
+    int fd = open(path, O_RDONLY);
+    if (fd == -1)
+        return NULL;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t) st.st_size < sizeof(HistoryHeader)){
+        close(fd);
+        return NULL;
+    }
+    size_t size = st.st_size;
+    void *base = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED)
+        return NULL;
+    HistoryReader *reader = calloc(1, sizeof(HistoryReader));
+    if (reader == NULL){
+        munmap(base, size);
+        return NULL;
+    }
+    reader->base = base;
+    reader->size = size;
+    const HistoryHeader *header = base;
+    reader->header = header;
+    size_t block_size = column_offsets(reader->column_offsets);
+    int valid = memcmp(header->magic, HISTORY_MAGIC, sizeof(header->magic)) == 0
+             && header->version == HISTORY_VERSION
+             && header->byte_order == HISTORY_BYTE_ORDER
+             && header->header_size == sizeof(HistoryHeader)
+             && header->column_count == HISTORY_COLUMN_COUNT
+             && header->block_records == HISTORY_BLOCK
+             && header->complete == 1
+             && header->word_length <= JOB_MAX_WORD
+             && header->block_count <= size / sizeof(uint64_t)
+             && header->snapshot_count <= size / sizeof(HistorySnapshot)
+             && header->record_count <= header->block_count * HISTORY_BLOCK
+             && header->blocks_offset % sizeof(uint64_t) == 0
+             && header->blocks_offset <= size && header->block_count * sizeof(uint64_t) <= size - header->blocks_offset
+             && header->snapshots_offset % sizeof(uint64_t) == 0
+             && header->snapshots_offset <= size && header->snapshot_count * sizeof(HistorySnapshot) <= size - header->snapshots_offset;
+    if (valid){
+        reader->block_offsets = (const uint64_t *) (reader->base + header->blocks_offset);
+        reader->snapshots = (const HistorySnapshot *) (reader->base + header->snapshots_offset);
+        for (size_t b = 0; valid && b < header->block_count; b++)
+            valid = reader->block_offsets[b] % sizeof(uint64_t) == 0
+                 && reader->block_offsets[b] <= size && block_size <= size - reader->block_offsets[b];
+        for (size_t s = 0; valid && s < header->snapshot_count; s++)
+            valid = reader->snapshots[s].offset <= size && reader->snapshots[s].coded_size <= size - reader->snapshots[s].offset;
+    }
+    if (!valid){
+        close_history(reader);
+        return NULL;
+    }
+    return reader;
+}
+
+/**
+ * @brief Reads a value of a history file, in constant time.
+ * @param reader The reader.
+ * @param column The column.
+ * @param index The index of the record, below header->record_count.
+ * @return The value.
+*/
+double history_value(const HistoryReader *reader, HistoryColumn column, size_t index){
+    const char *values = reader->base + reader->block_offsets[index / HISTORY_BLOCK] + reader->column_offsets[column];
+    size_t i = index % HISTORY_BLOCK;
+    switch (history_columns[column].type){
+        case HISTORY_INT32: return ((const int32_t *) values)[i];
+        case HISTORY_UINT64: return ((const uint64_t *) values)[i];
+        case HISTORY_FLOAT: return ((const float *) values)[i];
+        case HISTORY_DOUBLE: return ((const double *) values)[i];
+    }
+    return 0.0;
+}
+
+/**
+ * @brief Decodes the genomes of a snapshot of a history file.
+ * @param reader The reader.
+ * @param index The index of the snapshot, below header->snapshot_count.
+ * @return The genomes with their terminators, one after the other, to be freed, or NULL if the snapshot is corrupted.
+*/
+Gene *read_history_snapshot(const HistoryReader *reader, size_t index){
+    const HistorySnapshot *snapshot = &reader->snapshots[index];
+    Gene *genomes = malloc(snapshot->genomes_size);
+    if (genomes == NULL)
+        return NULL;
+    const uint8_t *in = (const uint8_t *) reader->base + snapshot->offset;
+    const uint8_t *end = in + snapshot->coded_size;
+    if (!snapshot->delta_coded){
+        // The genomes are stored as they are, each with its terminator
+        size_t terminators = 0;
+        for (const uint8_t *gene = in; gene < end; gene++)
+            terminators += *gene == '\0';
+        if (snapshot->coded_size != snapshot->genomes_size || terminators != snapshot->size
+            || (snapshot->size > 0 && end[-1] != '\0')){
+            free(genomes);
+            return NULL;
+        }
+        memcpy(genomes, in, snapshot->genomes_size);
+        return genomes;
+    }
+    Gene *out = genomes;
+    Gene *out_end = genomes + snapshot->genomes_size;
+    const Gene *previous = "";
+    uint64_t previous_size = 0;
+    for (uint64_t i = 0; i < snapshot->size; i++){
+        uint64_t prefix, suffix, middle;
+        if (get_varint(&in, end, &prefix) != 0 || get_varint(&in, end, &suffix) != 0 || get_varint(&in, end, &middle) != 0
+            || prefix > previous_size || suffix > previous_size - prefix || middle >= (uint64_t) (out_end - out)
+            || prefix + suffix >= (uint64_t) (out_end - out) - middle){
+            free(genomes);
+            return NULL;
+        }
+        memcpy(out, previous, prefix);
+        const Gene *previous_genes = previous + prefix;
+        uint64_t previous_middle = previous_size - prefix - suffix;
+        uint64_t position = 0;
+        while (position < middle){
+            uint64_t equal, different;
+            if (get_varint(&in, end, &equal) != 0 || get_varint(&in, end, &different) != 0 || equal + different == 0
+                || equal > middle - position || different > middle - position - equal
+                || position + equal > previous_middle || different > (uint64_t) (end - in)){
+                free(genomes);
+                return NULL;
+            }
+            memcpy(out + prefix + position, previous_genes + position, equal);
+            memcpy(out + prefix + position + equal, in, different);
+            in += different;
+            position += equal + different;
+        }
+        memcpy(out + prefix + middle, previous + previous_size - suffix, suffix);
+        previous = out;
+        previous_size = prefix + middle + suffix;
+        out[previous_size] = '\0';
+        out += previous_size + 1;
+    }
+    if (out != out_end){
+        free(genomes);
+        return NULL;
+    }
+    return genomes;
+}
+
+/**
+ * @brief Unmaps a history file.
+ * @param reader The reader, or NULL.
+*/
+void close_history(HistoryReader *reader){
+    if (reader == NULL)
+        return;
+    munmap((void *) reader->base, reader->size);
+    free(reader);
+}
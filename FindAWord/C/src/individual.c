@@ -8,13 +8,13 @@
 */
 Individual create_individual(int min_size_individual, int max_size_individual){
     Individual c;
-    int rand_int = rand() % (max_size_individual - min_size_individual +1) + min_size_individual;
-    c.genome = malloc(sizeof(Gene) * (rand_int+1));
+    int rand_int = random_int() % (max_size_individual - min_size_individual +1) + min_size_individual;
+    c.genome = allocate_genome(sizeof(Gene) * (rand_int+1));
     int i = 0;
     for (; i < rand_int; i++)
         c.genome[i] = create_gene();
     c.genome[i] = '\0';
-    c.size = rand_int+1;
+    c.size = rand_int;
     c.min_size = min_size_individual;
     c.max_size = max_size_individual;
     return c;
@@ -28,7 +28,37 @@ Individual create_individual(int min_size_individual, int max_size_individual){
 */
 void free_individual(Individual individual){
     if (individual.genome != NULL){
-        free(individual.genome);
+        release_genome(individual.genome);
     }
     individual.size = 0;
+}
+
+/**
+ * @brief Allocates a genome in the genome arena of the thread, or with scratch_alloc without arena or when it is full.
+ * @param size The size of the genome in bytes, with its terminator.
+ * @return The genome, or NULL if the allocation failed.
+*/
+Gene *allocate_genome(size_t size){
+    PROFILE_ADD(allocations, 1);
+    PROFILE_ADD(allocated_bytes, size);
+    GenomeArena *arena = current_genome_arena();
+    if (arena != NULL){
+        Gene *genome = arena_allocate(arena, size);
+        if (genome != NULL)
+            return genome;
+    }
+    return scratch_alloc(size);
+}
+
+/**
+ * @brief Releases a genome allocated by allocate_genome.
+ * A genome of the arena of the thread is released with its space, the others are freed with scratch_free.
+ * The arena the genome was allocated in must be the one of the thread, see scratch_free for the workspaces.
+ * @param genome The genome.
+*/
+void release_genome(Gene *genome){
+    GenomeArena *arena = current_genome_arena();
+    if (arena != NULL && in_genome_arena(arena, genome))
+        return;
+    scratch_free(genome);
 }
\ No newline at end of file
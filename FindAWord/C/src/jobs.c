@@ -0,0 +1,511 @@
+#include <jobs.h>
+
+// Operators which can be chosen by name, the names are the ones of the functions
+const NamedFitnessFunction fitness_functions[FITNESS_FUNCTION_COUNT] = {
+    {"modified_hamming_distance_fitness", modified_hamming_distance_fitness},
+    {"levenstein_distance_fitness", levenstein_distance_fitness},
+    {"smith_waterman", smith_waterman},
+    {"jaccard_similarity_fitness", jaccard_similarity_fitness},
+    {"cosine_similarity_fitness", cosine_similarity_fitness},
+    {"pearson_correlation_fitness", pearson_correlation_fitness},
+    {"nlcs_fitness", nlcs_fitness},
+    {"ngram_overlap_fitness", ngram_overlap_fitness},
+    {"manhattan_distance_fitness", manhattan_distance_fitness},
+};
+const NamedSelectionFunction selection_functions[SELECTION_FUNCTION_COUNT] = {
+    {"truncation_selection", truncation_selection},
+    {"roulette_wheel_selection", roulette_wheel_selection},
+    {"tournament_selection", tournament_selection},
+    {"rank_based_selection", rank_based_selection},
+};
+const NamedPairingFunction pairing_functions[PAIRING_FUNCTION_COUNT] = {
+    {"random_pairing_parents", random_pairing_parents},
+    {"consecutive_pairing_parents", consecutive_pairing_parents},
+    {"non_sequential_pairing_parents", non_sequential_pairing_parents},
+    {"assortative_pairing_parents", assortative_pairing_parents},
+    {"disassortative_pairing_parents", disassortative_pairing_parents},
+};
+const NamedCrossoverFunction crossover_functions[CROSSOVER_FUNCTION_COUNT] = {
+    {"uniform_crossover", uniform_crossover},
+    {"multipoint_crossover", multipoint_crossover},
+    {"probalistic_crossover", probalistic_crossover},
+};
+const NamedMutationFunction mutation_functions[MUTATION_FUNCTION_COUNT] = {
+    {"random_mutate", random_mutate},
+    {"subsequence_inversion_mutate", subsequence_inversion_mutate},
+    {"swap_mutate", swap_mutate},
+    {"insertion_mutate", insertion_mutate},
+    {"deletion_mutate", deletion_mutate},
+};
+
+// Engines which can be chosen by name, in the order of JobEngine
+const char *engine_names[ENGINE_COUNT] = {"generation", "packed", "umda", "pbil"};
+
+// Looks the function named value up in table, sets field and evaluates to 1 when found
+#define LOOKUP_OPERATOR(table, value, field) ({\
+    int matched = 0;\
+    for (size_t k = 0; k < sizeof(table) / sizeof(table[0]) && !matched; k++)\
+        if (strcmp(table[k].name, value) == 0){\
+            field = table[k].function;\
+            matched = 1;\
+        }\
+    matched;\
+})
+
+/**
+ * @brief Returns the default parameters of a job: fixed-length individuals, modified Hamming distance,
+ * truncation selection, random pairing, uniform crossover and random mutation, which has a generation variant.
+ * @return The default job configuration.
+*/
+JobConfig default_job_config(){
+    JobConfig config;
+    config.population_size = 1024;
+    config.max_generations = 100000;
+    config.fixed_length = 1;
+    config.random_operators = 0;
+    config.seed = 0;
+    config.engine = ENGINE_GENERATION;
+    config.diversity = 0;
+    config.fitness_function = modified_hamming_distance_fitness;
+    config.selection_function = truncation_selection;
+    config.pairing_function = random_pairing_parents;
+    config.crossover_function = uniform_crossover;
+    config.mutation_function = random_mutate;
+    return config;
+}
+
+/**
+ * @brief Sets an operator of a job configuration from its function name.
+ * @param config The job configuration.
+ * @param kind The operator : "fitness", "selection", "pairing", "crossover" or "mutation".
+ * @param name The name of the function.
+ * @return 0 on success, -1 if the kind or the name is unknown.
+*/
+int set_job_operator(JobConfig *config, const char *kind, const char *name){
+    int found = 0;
+    if (strcmp(kind, "fitness") == 0)
+        found = LOOKUP_OPERATOR(fitness_functions, name, config->fitness_function);
+    else if (strcmp(kind, "selection") == 0)
+        found = LOOKUP_OPERATOR(selection_functions, name, config->selection_function);
+    else if (strcmp(kind, "pairing") == 0)
+        found = LOOKUP_OPERATOR(pairing_functions, name, config->pairing_function);
+    else if (strcmp(kind, "crossover") == 0)
+        found = LOOKUP_OPERATOR(crossover_functions, name, config->crossover_function);
+    else if (strcmp(kind, "mutation") == 0)
+        found = LOOKUP_OPERATOR(mutation_functions, name, config->mutation_function);
+    return found ? 0 : -1;
+}
+
+/**
+ * @brief Sets the engine of a job configuration from its name, see engine_names.
+ * @param config The job configuration.
+ * @param name The name of the engine : "generation" or "packed".
+ * @return 0 on success, -1 if the name is unknown.
+*/
+int set_job_engine(JobConfig *config, const char *name){
+    for (int i = 0; i < ENGINE_COUNT; i++)
+        if (strcmp(engine_names[i], name) == 0){
+            config->engine = (JobEngine) i;
+            return 0;
+        }
+    return -1;
+}
+
+/**
+ * @brief Makes sure the resources of a worker can hold a population of the given size.
+ * The resources only grow, so a worker solving jobs of the same size allocates them once.
+ * @param worker The worker, zeroed before its first use.
+ * @param population_size The number of individuals.
+ * @return 0 on success, -1 if the allocation failed.
+*/
+int prepare_worker(Worker *worker, size_t population_size){
+    if (worker->stop == NULL){
+        worker->stop = create_stop_signal(-1.0f);
+        if (worker->stop == NULL)
+            return -1;
+    }
+    if (worker->arena == NULL || worker->workspace == NULL || worker->capacity < population_size){
+        free_genome_arena(worker->arena);
+        free_workspace(worker->workspace);
+        // The space is reserved for the longest word, only the pages written are used
+        worker->arena = create_genome_arena(population_size * (2 * JOB_MAX_WORD + 1), NULL);
+        worker->workspace = create_workspace(population_size, 2 * JOB_MAX_WORD);
+        worker->capacity = worker->arena != NULL && worker->workspace != NULL ? population_size : 0;
+        if (worker->capacity == 0)
+            return -1;
+    }
+    if (worker->score_cache == NULL && (worker->score_cache = create_score_cache()) == NULL)
+        return -1;
+    if (worker->ranking.capacity == 0)
+        worker->ranking = create_ranking(population_size);
+    return reserve_ranking(&worker->ranking, population_size);
+}
+
+/**
+ * @brief Frees the resources of a worker.
+ * @param worker The worker.
+*/
+void free_worker(Worker *worker){
+    free_genome_arena(worker->arena);
+    free_workspace(worker->workspace);
+    free_ranking(worker->ranking);
+    free_score_cache(worker->score_cache);
+    free_stop_signal(worker->stop);
+    memset(worker, 0, sizeof(Worker));
+}
+
+/**
+ * @brief Evolves a packed population until it finds a word, see packed_make_generation.
+ * The operators of the configuration are not used, a packed genome can not be given to them. The two packed
+ * populations are allocated for the job: the arena and the workspace of the worker hold unpacked genomes.
+ * The stop signal is checked between two generations.
+ * @param config The parameters of the search.
+ * @param word The target word.
+ * @param min_size The minimum size of the individuals.
+ * @param max_size The maximum size of the individuals.
+ * @param stop A stop signal to cancel the search, or NULL.
+ * @param start The start time of the job.
+ * @return The result of the search.
+*/
+static JobResult solve_packed(const JobConfig *config, const char *word, int min_size, int max_size, StopSignal *stop, double start){
+    JobResult result = {0};
+    // A gene outside of [MINCHAR, MAXCHAR] can not be packed
+    for (const char *c = word; *c != '\0'; c++)
+        if ((unsigned char) *c < MINCHAR || (unsigned char) *c > MAXCHAR){
+            result.failed = 1;
+            result.wall_time = now_seconds() - start;
+            return result;
+        }
+    if (max_size > PACKED_MAX_LENGTH)
+        max_size = PACKED_MAX_LENGTH;
+    PackedPopulation p = create_packed_population(config->population_size, min_size, max_size);
+    PackedPopulation next = create_packed_population(config->population_size, min_size, max_size);
+    GenerationStats stats = {0};
+    result.failed = p.words == NULL || next.words == NULL;
+    while (!result.failed && result.generations < config->max_generations){
+        if (stop != NULL && stop_requested(stop)){
+            result.cancelled = 1;
+            break;
+        }
+        packed_make_generation(&p, &next, word, 0.0f, &stats);
+        result.generations++;
+        result.evaluations += stats.evaluations;
+        if (stats.exact_match){
+            result.solved = 1;
+            break;
+        }
+    }
+    free_packed_population(p);
+    free_packed_population(next);
+    result.wall_time = now_seconds() - start;
+    return result;
+}
+
+/**
+ * @brief Evolves a population until it finds a word, on the calling thread.
+ * The population is created in the arena and the workspace of the worker and uses its ranking, and the generation variant
+ * of the operators when there is one. With random_operators, the operators are drawn each generation as in
+ * the single word mode of main.c. With ENGINE_UMDA and ENGINE_PBIL, the generations are eda_generation with a model
+ * learnt for the job and the fitness function of the configuration. With ENGINE_PACKED, the search runs on packed
+ * populations instead, see solve_packed.
+ * @param worker The worker whose resources are used.
+ * @param config The parameters of the search.
+ * @param word The target word, of at most JOB_MAX_WORD characters.
+ * @param seed The seed of the random generator of the thread.
+ * @param stop A stop signal to cancel the search from another thread, or NULL to use the signal of the worker.
+ * @return The result of the search.
+*/
+JobResult solve_word(Worker *worker, const JobConfig *config, const char *word, uint64_t seed, StopSignal *stop){
+    JobResult result = {0};
+    double start = now_seconds();
+    int length = strlen(word);
+    int min_size = config->fixed_length ? length : 1;
+    int max_size = config->fixed_length ? length : 2 * length;
+    if (length != 0 && length <= JOB_MAX_WORD && config->engine == ENGINE_PACKED){
+        seed_random(seed);
+        return solve_packed(config, word, min_size, max_size, stop, start);
+    }
+    if (length == 0 || length > JOB_MAX_WORD || prepare_worker(worker, config->population_size) != 0){
+        result.failed = 1;
+        result.wall_time = now_seconds() - start;
+        return result;
+    }
+    if (stop == NULL){
+        reset_stop_signal(worker->stop);
+        stop = worker->stop;
+    }
+    seed_random(seed);
+
+    reset_genome_arena(worker->arena);
+    GenomeArena *previous_arena = set_genome_arena(worker->arena);
+    Workspace *previous_workspace = set_workspace(worker->workspace);
+    Population p = create_population(config->population_size, min_size, max_size);
+    set_genome_arena(previous_arena);
+    set_workspace(previous_workspace);
+    p.arena = worker->arena;
+    p.workspace = worker->workspace;
+    p.stop = stop;
+    // The diversity model is sized for the individuals of the job, and counts the first population
+    if (config->diversity && (p.diversity = create_diversity(max_size)) != NULL)
+        count_diversity(p.diversity, p.individuals, p.size);
+    // The children are scored as they are bred when the fitness function does not change from one generation to the next
+    worker->score_cache->valid = 0;
+    p.score_cache = config->random_operators ? NULL : worker->score_cache;
+    EdaModel *model = NULL;
+    if (config->engine == ENGINE_UMDA || config->engine == ENGINE_PBIL){
+        model = create_eda_model(config->engine == ENGINE_UMDA ? EDA_UMDA : EDA_PBIL, min_size, max_size,\
+                                 JOB_EDA_LEARNING_RATE, JOB_EDA_SELECTION_RATE);
+        if (model == NULL){
+            free_diversity(p.diversity);
+            free_population(p);
+            result.failed = 1;
+            result.wall_time = now_seconds() - start;
+            return result;
+        }
+    }
+
+    // The operators of the current generation, drawn again each generation with random_operators
+    JobConfig operators = *config;
+    GenerationFunction generation_function = find_generation_variant(operators.fitness_function, operators.selection_function,\
+                                             operators.pairing_function, operators.crossover_function, operators.mutation_function);
+    GenerationStats stats = {0};
+    Ranking *ranking = &worker->ranking;
+    while (result.generations < config->max_generations){
+        if (model == NULL && config->random_operators){
+            operators.fitness_function = fitness_functions[random_int() % FITNESS_FUNCTION_COUNT].function;
+            operators.selection_function = selection_functions[random_int() % SELECTION_FUNCTION_COUNT].function;
+            operators.mutation_function = mutation_functions[random_int() % MUTATION_FUNCTION_COUNT].function;
+            operators.pairing_function = pairing_functions[random_int() % PAIRING_FUNCTION_COUNT].function;
+            operators.crossover_function = crossover_functions[random_int() % CROSSOVER_FUNCTION_COUNT].function;
+            generation_function = find_generation_variant(operators.fitness_function, operators.selection_function,\
+                                  operators.pairing_function, operators.crossover_function, operators.mutation_function);
+        }
+        if (model != NULL)
+            p = eda_generation(p, word, model, operators.fitness_function, NULL, ranking, &stats);
+        else if (generation_function != NULL)
+            p = generation_function(p, word, ranking, &stats);
+        else
+            p = make_generation(p, word, operators.fitness_function, NULL, operators.selection_function, NULL,\
+                                operators.pairing_function, ranking, operators.crossover_function, NULL,\
+                                operators.mutation_function, NULL, ranking, &stats);
+        result.generations++;
+        result.evaluations += stats.evaluations;
+        if (stats.stopped || stats.exact_match)
+            break;
+    }
+    result.solved = stats.exact_match;
+    result.cancelled = stats.stopped && !stats.exact_match;
+    // The model describes the last population, bred or stopped in its fitness phase
+    if (p.diversity != NULL){
+        result.entropy = diversity_entropy(p.diversity, NULL);
+        result.consensus_distance = diversity_consensus_distance(p.diversity);
+        free_diversity(p.diversity);
+    }
+    free_eda_model(model);
+    free_population(p);
+    result.wall_time = now_seconds() - start;
+    return result;
+}
+
+/**
+ * @brief Body of a worker thread: solves the jobs of the queue until the runner is closed and the queue empty.
+ * @param datas The worker of the thread.
+ * @return NULL.
+*/
+static void *worker_thread(void *datas){
+    Worker *worker = datas;
+    JobRunner *runner = worker->runner;
+    pthread_mutex_lock(&runner->lock);
+    for (;;){
+        while (runner->head == NULL && !runner->closed)
+            pthread_cond_wait(&runner->available, &runner->lock);
+        Job *job = runner->head;
+        if (job == NULL)
+            break;
+        runner->head = job->next;
+        if (runner->head == NULL)
+            runner->tail = NULL;
+        pthread_mutex_unlock(&runner->lock);
+
+        // The seed depends on the job only, so a job gives the same result on any worker
+        JobResult result = solve_word(worker, &job->config, job->word, job->config.seed + job->index, job->stop);
+        if (job->callback != NULL)
+            job->callback(job, result, job->callback_datas);
+        free(job->word);
+        free(job);
+
+        pthread_mutex_lock(&runner->lock);
+        runner->finished++;
+        runner->solved += result.solved;
+    }
+    pthread_mutex_unlock(&runner->lock);
+    free_worker(worker);
+    return NULL;
+}
+
+/**
+ * @brief Creates a job runner and starts its worker threads.
+ * @param worker_count The number of worker threads, usually the number of cores.
+ * @return The job runner, or NULL on failure.
+*/
+JobRunner *create_job_runner(int worker_count){
+    JobRunner *runner = calloc(1, sizeof(JobRunner));
+    if (runner == NULL)
+        return NULL;
+    runner->threads = calloc(worker_count, sizeof(pthread_t));
+    runner->workers = calloc(worker_count, sizeof(Worker));
+    if (runner->threads == NULL || runner->workers == NULL){
+        free(runner->threads);
+        free(runner->workers);
+        free(runner);
+        return NULL;
+    }
+    pthread_mutex_init(&runner->lock, NULL);
+    pthread_cond_init(&runner->available, NULL);
+    for (int i = 0; i < worker_count; i++){
+        runner->workers[i].runner = runner;
+        if (pthread_create(&runner->threads[i], NULL, worker_thread, &runner->workers[i]) != 0)
+            break;
+        runner->worker_count++;
+    }
+    if (runner->worker_count == 0){
+        free_job_runner(runner);
+        return NULL;
+    }
+    return runner;
+}
+
+/**
+ * @brief Queues a job.
+ * @param runner The job runner.
+ * @param word The target word, copied.
+ * @param config The parameters of the search, copied.
+ * @param stop Optional stop signal to cancel the job, NULL to use the signal of the worker.
+ * @param callback Function called by the worker thread with the result, or NULL.
+ * @param callback_datas Optional data to be passed to the callback.
+ * @return 0 on success, -1 on failure.
+*/
+int submit_job(JobRunner *runner, const char *word, const JobConfig *config, StopSignal *stop, JobCallback callback, void *callback_datas){
+    Job *job = malloc(sizeof(Job));
+    if (job == NULL)
+        return -1;
+    job->word = strdup(word);
+    if (job->word == NULL){
+        free(job);
+        return -1;
+    }
+    job->config = *config;
+    job->stop = stop;
+    job->callback = callback;
+    job->callback_datas = callback_datas;
+    job->next = NULL;
+
+    pthread_mutex_lock(&runner->lock);
+    job->index = runner->submitted++;
+    if (runner->tail != NULL)
+        runner->tail->next = job;
+    else
+        runner->head = job;
+    runner->tail = job;
+    pthread_cond_signal(&runner->available);
+    pthread_mutex_unlock(&runner->lock);
+    return 0;
+}
+
+/**
+ * @brief Waits for the queued jobs to finish and stops the worker threads. The counters of the runner stay readable.
+ * @param runner The job runner.
+*/
+void close_job_runner(JobRunner *runner){
+    if (runner->joined)
+        return;
+    pthread_mutex_lock(&runner->lock);
+    runner->closed = 1;
+    pthread_cond_broadcast(&runner->available);
+    pthread_mutex_unlock(&runner->lock);
+    for (int i = 0; i < runner->worker_count; i++)
+        pthread_join(runner->threads[i], NULL);
+    runner->joined = 1;
+}
+
+/**
+ * @brief Closes the runner if needed and frees it.
+ * @param runner The job runner.
+*/
+void free_job_runner(JobRunner *runner){
+    close_job_runner(runner);
+    pthread_mutex_destroy(&runner->lock);
+    pthread_cond_destroy(&runner->available);
+    free(runner->threads);
+    free(runner->workers);
+    free(runner);
+}
+
+/**
+ * @brief Output of run_jobs, shared by the worker threads.
+*/
+typedef struct job_output {
+    FILE *file;             /**< The output file. */
+    pthread_mutex_t lock;   /**< Lock of the output file. */
+} JobOutput;
+
+/**
+ * @brief Writes the result of a job as a line of the output, as soon as it is finished.
+ * The line is index, word, solved, generations, evaluations and wall time, followed by the entropy and the
+ * consensus distance of the last population for a job with diversity, separated by tabulations.
+ * @param job The finished job.
+ * @param result The result of the job.
+ * @param optional_datas The JobOutput.
+*/
+static void write_job_result(const Job *job, JobResult result, void *optional_datas){
+    JobOutput *output = optional_datas;
+    pthread_mutex_lock(&output->lock);
+    fprintf(output->file, "%zu\t%s\t%d\t%d\t%zu\t%.6f", job->index, job->word, result.solved, result.generations,\
+            result.evaluations, result.wall_time);
+    if (job->config.diversity)
+        fprintf(output->file, "\t%.6f\t%.6f", result.entropy, result.consensus_distance);
+    fprintf(output->file, "\n");
+    fflush(output->file);
+    pthread_mutex_unlock(&output->lock);
+}
+
+/**
+ * @brief Solves the words of an input file, one per line, on a pool of worker threads.
+ * The words are queued as they are read, so the input can be a pipe, and the results are written to the
+ * output as the jobs finish, in the order they finish.
+ * @param config The parameters of every job.
+ * @param worker_count The number of worker threads.
+ * @param input The input file.
+ * @param output The output file.
+ * @param solved The number of words found, or NULL.
+ * @return The number of jobs run.
+*/
+size_t run_jobs(const JobConfig *config, int worker_count, FILE *input, FILE *output, size_t *solved){
+    JobOutput job_output;
+    job_output.file = output;
+    pthread_mutex_init(&job_output.lock, NULL);
+    JobRunner *runner = create_job_runner(worker_count);
+    if (runner == NULL){
+        pthread_mutex_destroy(&job_output.lock);
+        return 0;
+    }
+
+    char *line = NULL;
+    size_t line_size = 0;
+    ssize_t read;
+    while ((read = getline(&line, &line_size, input)) != -1){
+        while (read > 0 && (line[read - 1] == '\n' || line[read - 1] == '\r'))
+            line[--read] = '\0';
+        if (read != 0)
+            submit_job(runner, line, config, NULL, write_job_result, &job_output);
+    }
+    free(line);
+
+    close_job_runner(runner);
+    size_t submitted = runner->submitted;
+    if (solved != NULL)
+        *solved = runner->solved;
+    free_job_runner(runner);
+    pthread_mutex_destroy(&job_output.lock);
+    return submitted;
+}
@@ -9,8 +9,159 @@
 #include <crossover.h>
 #include <mutation.h>
 #include <population.h>
+#include <jobs.h>
+#include <server.h>
+#include <checkpoint.h>
+#include <history.h>
+#include <pipeline.h>
+
+/**
+ * @brief Solves the words of a file, one per line, on a pool of worker threads and writes a result per line.
+ * @param input_path The input file, "-" for the standard input.
+ * @param output_path The output file, "-" for the standard output.
+ * @param config The parameters of every job.
+ * @param worker_count The number of worker threads.
+ * @return 0 on success, 1 if a file could not be opened.
+*/
+static int batch_main(const char *input_path, const char *output_path, const JobConfig *config, int worker_count){
+    FILE *input = strcmp(input_path, "-") == 0 ? stdin : fopen(input_path, "r");
+    if (input == NULL){
+        perror(input_path);
+        return 1;
+    }
+    FILE *output = strcmp(output_path, "-") == 0 ? stdout : fopen(output_path, "w");
+    if (output == NULL){
+        perror(output_path);
+        if (input != stdin)
+            fclose(input);
+        return 1;
+    }
+    size_t solved = 0;
+    double start = now_seconds();
+    size_t jobs = run_jobs(config, worker_count, input, output, &solved);
+    double elapsed = now_seconds() - start;
+    fprintf(stderr, "%zu words, %zu solved in %.3f s with %d threads: %.1f words/s\n", jobs, solved, elapsed, worker_count,\
+            elapsed > 0 ? jobs / elapsed : 0.0);
+    if (input != stdin)
+        fclose(input);
+    if (output != stdout)
+        fclose(output);
+    return 0;
+}
+
+/**
+ * @brief Searches a word with another engine than make_generation, see solve_word, and writes the result on
+ * the standard error.
+ * @param word The target word.
+ * @param config The parameters of the search, with its engine and population size.
+ * @return 0 on success, 1 if the word was not found.
+*/
+static int engine_main(const char *word, const JobConfig *config){
+    Worker worker = {0};
+    JobResult result = solve_word(&worker, config, word, config->seed, NULL);
+    free_worker(&worker);
+    fprintf(stderr, "%s engine, %zu individuals: %s after %d generations, %zu evaluations in %.3f s\n",\
+            engine_names[config->engine], config->population_size, result.solved ? "solved" : "not solved",\
+            result.generations, result.evaluations, result.wall_time);
+    return result.solved ? 0 : 1;
+}
+
+/**
+ * @brief Searches a word with a pipeline of several threads, with the operators of a job configuration.
+ * @param p The first generation, left to the caller.
+ * @param word The target word.
+ * @param config The parameters of the search, whose selection function must be tournament_selection.
+ * @param thread_count The number of threads of the pipeline.
+ * @param checkpoint_writer The writer of the checkpoints, or NULL.
+ * @param history The recorder of the generations, or NULL.
+ * @return 0 on success, 1 if the pipeline could not be created.
+*/
+static int pipeline_main(Population p, const char *word, const JobConfig *config, int thread_count,\
+                         CheckpointWriter *checkpoint_writer, HistoryRecorder *history){
+    Pipeline *pipeline = create_pipeline(p, word, thread_count, config->seed, config->fitness_function, NULL, config->selection_function,\
+                                         config->pairing_function, NULL, config->crossover_function, NULL,\
+                                         config->mutation_function, NULL);
+    if (pipeline == NULL){
+        fprintf(stderr, "Could not create a pipeline of %d threads\n", thread_count);
+        return 1;
+    }
+    GenerationStats stats = {0};
+    stats.reporting_function = modified_hamming_distance_fitness;
+    Population generation = pipeline_population(pipeline);
+    while (generation.generation < config->max_generations){
+        generation = pipeline_generation(pipeline, &stats);
+        if (history != NULL)
+            record_generation(history, generation, &stats);
+        if (stats.exact_match)
+            break;
+        if (checkpoint_writer != NULL)
+            checkpoint_population(checkpoint_writer, generation, word, config);
+    }
+    free_pipeline(pipeline);
+    return 0;
+}
+
+int main(int argc, char **argv){
+    JobConfig config = default_job_config();
+    config.seed = time(NULL);
+#ifdef GA_PROFILE
+    // Each thread writes its profile on the standard error every GA_PROFILE_INTERVAL generations
+    const char *interval = getenv("GA_PROFILE_INTERVAL");
+    set_profile_output(stderr, interval != NULL ? strtoull(interval, NULL, 10) : 1000);
+#endif
+    const char *input_path = NULL;
+    const char *output_path = "-";
+    const char *socket_path = NULL;
+    const char *checkpoint_path = NULL;
+    const char *restore_path = NULL;
+    const char *arena_path = NULL;
+    int checkpoint_interval = 1000;
+    const char *history_path = NULL;
+    int snapshot_interval = 0;
+    int pipeline_threads = 0;
+    int generations_set = 0;
+    long worker_count = sysconf(_SC_NPROCESSORS_ONLN);
+    int option;
+    while ((option = getopt(argc, argv, "i:o:d:j:p:g:s:c:n:r:A:H:S:t:e:D")) != -1){
+        switch (option){
+            case 'i': input_path = optarg; break;
+            case 'o': output_path = optarg; break;
+            case 'd': socket_path = optarg; break;
+            case 'j': worker_count = atol(optarg); break;
+            case 'p': config.population_size = strtoull(optarg, NULL, 10); break;
+            case 'g': config.max_generations = atoi(optarg); generations_set = 1; break;
+            case 's': config.seed = strtoull(optarg, NULL, 10); break;
+            case 'c': checkpoint_path = optarg; break;
+            case 'n': checkpoint_interval = atoi(optarg); break;
+            case 'r': restore_path = optarg; break;
+            case 'A': arena_path = optarg; break;
+            case 'H': history_path = optarg; break;
+            case 'S': snapshot_interval = atoi(optarg); break;
+            case 't': pipeline_threads = atoi(optarg); break;
+            case 'D': config.diversity = 1; break;
+            case 'e':
+                if (set_job_engine(&config, optarg) == 0)
+                    break;
+                // fall through
+            default:
+                fprintf(stderr, "Usage: %s [-i words|-] [-o results|-] [-d socket] [-j threads] [-p population] [-g generations] [-s seed]"\
+                                " [-c checkpoint] [-n generations per checkpoint] [-r checkpoint to resume] [-A genome file] [-H history] [-S generations per snapshot]"\
+                                " [-t pipeline threads, with tournament selection] [-e generation|packed|umda|pbil] [-D]\n", argv[0]);
+                return 1;
+        }
+    }
+    if (worker_count <= 0)
+        worker_count = 1;
+    if (socket_path != NULL){
+        if (run_server(socket_path, worker_count, &config) != 0){
+            perror(socket_path);
+            return 1;
+        }
+        return 0;
+    }
+    if (input_path != NULL)
+        return batch_main(input_path, output_path, &config, worker_count);
 
-int main(){
     FitnessFunction ff[9];
     ff[0] = modified_hamming_distance_fitness;
     ff[1] = levenstein_distance_fitness;
@@ -26,10 +177,12 @@ int main(){
     sf[1] = roulette_wheel_selection;
     sf[2] = tournament_selection;
     sf[3] = rank_based_selection;
-    PairingFunction pf[3];
+    PairingFunction pf[5];
     pf[0] = random_pairing_parents;
     pf[1] = consecutive_pairing_parents;
     pf[2] = non_sequential_pairing_parents;
+    pf[3] = assortative_pairing_parents;
+    pf[4] = disassortative_pairing_parents;
     CrossoverFunction cf[3];
     cf[0] = uniform_crossover;
     cf[1] = multipoint_crossover;
@@ -41,44 +194,148 @@ int main(){
     mf[3] = insertion_mutate;
     mf[4] = deletion_mutate;
     const char * word = "Je vais bien, tu vas bien !";
+    if (config.engine != ENGINE_GENERATION)
+        return engine_main(word, &config);
 
-    int max_generations = 200000;
-
-    int population_size = 1024;
+    int population_size = config.population_size;
     int min_individual_size = 2;
     int max_individual_size = 50;
-    Population p = create_population(population_size, min_individual_size, max_individual_size);
+    // The pipeline keeps its operators, which do not change the length of the individuals, as the batch mode
+    if (pipeline_threads > 0 && config.fixed_length)
+        min_individual_size = max_individual_size = strlen(word);
+    // The search is resumed from a checkpoint, whose genomes are used in place in the mapped file
+    CheckpointHeader header;
+    Population p;
+    if (restore_path != NULL){
+        p = restore_checkpoint(restore_path, population_size * (max_individual_size + 1), &header);
+        if (p.size == 0 || strcmp(header.word, word) != 0){
+            fprintf(stderr, "%s: not a checkpoint of the search of \"%s\"\n", restore_path, word);
+            free_population(p);
+            free_genome_arena(p.arena);
+            return 1;
+        }
+        // The search goes on with the seed, the length mode and the operators of the checkpoint, and with
+        // its number of generations unless -g is given
+        int max_generations = config.max_generations;
+        if (checkpoint_job_config(&header, &config) != 0){
+            fprintf(stderr, "%s: unknown operator in the checkpoint\n", restore_path);
+            free_population(p);
+            free_genome_arena(p.arena);
+            return 1;
+        }
+        if (generations_set)
+            config.max_generations = max_generations;
+        population_size = p.size;
+    }
+    else {
+        // The genomes are written in a genome arena mapped on a file, for populations larger than the memory
+        GenomeArena *arena = NULL;
+        if (arena_path != NULL && (arena = create_genome_arena((size_t) population_size * (max_individual_size + 1), arena_path)) == NULL){
+            perror(arena_path);
+            return 1;
+        }
+        GenomeArena *previous_arena = set_genome_arena(arena);
+        p = create_population(population_size, min_individual_size, max_individual_size);
+        set_genome_arena(previous_arena);
+        p.arena = arena;
+    }
+    // The checkpoints are written by a background thread every checkpoint_interval generations
+    CheckpointWriter *checkpoint_writer = NULL;
+    if (checkpoint_path != NULL && (checkpoint_writer = create_checkpoint_writer(checkpoint_path, checkpoint_interval)) == NULL){
+        perror(checkpoint_path);
+        return 1;
+    }
+    // The statistics of the generations are written by a background thread, with a snapshot every snapshot_interval generations
+    HistoryRecorder *history = NULL;
+    if (history_path != NULL && (history = create_history_recorder(history_path, word, snapshot_interval)) == NULL){
+        perror(history_path);
+        return 1;
+    }
+    // The entropy and the consensus distance of the generations are recorded in the history
+    if (config.diversity && (p.diversity = create_diversity(max_individual_size)) != NULL)
+        count_diversity(p.diversity, p.individuals, p.size);
+    config.population_size = population_size;
+    config.random_operators = 1;
+    // The search runs on a pipeline with the fixed operators of the configuration instead of drawing them
+    if (pipeline_threads > 0){
+        config.random_operators = 0;
+        // The pipeline only runs tournaments, -t selects them in place of the selection of the batch mode
+        config.selection_function = tournament_selection;
+        seed_random(config.seed);
+        if (restore_path != NULL)
+            random_state = header.random_state;
+        int status = pipeline_main(p, word, &config, pipeline_threads, checkpoint_writer, history);
+        free_checkpoint_writer(checkpoint_writer);
+        if (free_history_recorder(history) != 0)
+            perror(history_path);
+        free_diversity(p.diversity);
+        free_population(p);
+        free_genome_arena(p.arena);
+        return status;
+    }
+    // The buffers of the generations are reused from one generation to the next
+    p.workspace = create_workspace(population_size, max_individual_size);
+    // Duplicates take the score of their first copy instead of being evaluated again
+    p.dedup = create_dedup_table(DEDUP_SHARE);
+    // The generation stops as soon as the word is evaluated
+    p.stop = create_stop_signal(-1.0f);
+    // The children are scored as they are bred with the fitness function of the next generation, drawn ahead
+    p.score_cache = create_score_cache();
+    Ranking ranking = create_ranking(population_size);
+    GenerationStats stats = {0};
+    stats.reporting_function = modified_hamming_distance_fitness;
 
-    float mutation_rate = 1/strlen(word);
-    float selection_rate = 0.8f;    float mutation_rate = 1/strlen(word);
     float selection_rate = 0.8f;
-    int rand_fitness, rand_mutation, rand_selection, rand_pairing, rand_crossover;
-    srand(time(NULL));
+    int rand_fitness, next_fitness, rand_mutation, rand_selection, rand_pairing, rand_crossover;
+    GenerationFunction generation_function;
+    seed_random(config.seed);
+    if (restore_path != NULL)
+        random_state = header.random_state;
     int i = 0;
-    for (i = 0; i < max_generations; i++){
-        rand_fitness = rand()%9;
-        rand_selection = rand()%4;
-        rand_mutation = rand()%5;
-        rand_pairing = rand()%3;
-        rand_crossover = rand()%3;
-        p = make_generation(p, word, ff[rand_fitness], NULL, sf[rand_selection],&selection_rate, pf[rand_pairing], NULL, cf[rand_crossover], NULL, mf[rand_mutation],NULL);
-        float * fitness_scores = malloc(sizeof(float)* p.size);
-
-        for(int j = 0; j < p.size; j++)
-            fitness_scores[j] = modified_hamming_distance_fitness(p.individuals[j].genome, word, NULL);
-
-        int * selected_indices;
-        selected_indices = truncation_selection(p, fitness_scores, selection_rate, NULL);
-//        printf("%s\n",p.individuals[selected_indices[0]].genome);
-        if (fitness_scores[selected_indices[0]] == 0){
-//            printf("Number of generation : %d\n", p.generation);
-            free(selected_indices);
-            free(fitness_scores);
+    // The fitness function drawn ahead by the search which wrote the checkpoint is in its header
+    rand_fitness = -1;
+    if (restore_path != NULL)
+        for (int k = 0; k < 9 && rand_fitness == -1; k++)
+            if (ff[k] == config.fitness_function)
+                rand_fitness = k;
+    if (rand_fitness == -1)
+        rand_fitness = random_int()%9;
+    for (i = p.generation; i < config.max_generations; i++){
+        rand_selection = random_int()%4;
+        rand_mutation = random_int()%5;
+        rand_pairing = random_int()%5;
+        rand_crossover = random_int()%3;
+        next_fitness = random_int()%9;
+        if (p.score_cache != NULL)
+            p.score_cache->next_fitness_function = ff[next_fitness];
+        // Use the specialized generation when there is one for these operators
+        generation_function = find_generation_variant(ff[rand_fitness], sf[rand_selection], pf[rand_pairing], cf[rand_crossover], mf[rand_mutation]);
+        if (generation_function != NULL)
+            p = generation_function(p, word, &ranking, &stats);
+        else
+            p = make_generation(p, word, ff[rand_fitness], NULL, sf[rand_selection],&selection_rate, pf[rand_pairing], &ranking, cf[rand_crossover], NULL, mf[rand_mutation],NULL, &ranking, &stats);
+        rand_fitness = next_fitness;
+        if (history != NULL)
+            record_generation(history, p, &stats);
+        if (stats.stopped || stats.exact_match)
             break;
-        }
-        free(selected_indices);
-        free(fitness_scores);
+        // The checkpoint records the fitness function of the next generation, already drawn
+        config.fitness_function = ff[rand_fitness];
+        if (checkpoint_writer != NULL)
+            checkpoint_population(checkpoint_writer, p, word, &config);
     }
+    free_checkpoint_writer(checkpoint_writer);
+    if (free_history_recorder(history) != 0)
+        perror(history_path);
+#ifdef GA_PROFILE
+    write_profile(stderr, &generation_profile);
+#endif
+    free_ranking(ranking);
+    free_dedup_table(p.dedup);
+    free_diversity(p.diversity);
+    free_stop_signal(p.stop);
+    free_score_cache(p.score_cache);
     free_population(p);
-//    printf("%s : %d generations\n", p.individuals[0].genome, p.generation);
+    free_workspace(p.workspace);
+    free_genome_arena(p.arena);
 }
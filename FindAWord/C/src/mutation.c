@@ -26,14 +26,14 @@ Individual random_mutate(Individual c, void * optional_datas){
     if (optional_datas != NULL){
         mutation_rate = *(float *) optional_datas;
     }else{
-        mutation_rate = 1/c.size;
+        mutation_rate = 1.0f/c.size;
     }
     // Calculate the number of mutations based on mutation rate    
     int number_of_mutations = (int) (mutation_rate * individual_size);
 
     for (int i = 0; i < number_of_mutations; i++) {
         // Select a random gene to be mutated
-        int gene_to_modify = rand() % individual_size;
+        int gene_to_modify = random_int() % individual_size;
         // Replace the selected gene with a randomly chosen character
         c.genome[gene_to_modify] = create_gene();
     }
@@ -53,11 +53,11 @@ Individual subsequence_inversion_mutate(Individual c, void * optional_datas){
     int individual_size = c.size;
     int i, j;
     if (individual_size % 2 != 0) {
-        i = individual_size != 1 ? rand() % (individual_size - 1) : 1;
-        j = individual_size -i -1 != 0 ? rand() % (individual_size - i - 1) + i + 1: 0;
+        i = individual_size != 1 ? random_int() % (individual_size - 1) : 1;
+        j = individual_size -i -1 != 0 ? random_int() % (individual_size - i - 1) + i + 1: 0;
     } else {
-        i = individual_size != 0 ? rand() % individual_size : 1;
-        j = individual_size -i != 0 ? rand() % (individual_size - i) + i: 0;
+        i = individual_size != 0 ? random_int() % individual_size : 1;
+        j = individual_size -i != 0 ? random_int() % (individual_size - i) + i: 0;
     }
 
     char temp;
@@ -91,8 +91,8 @@ Individual swap_mutate(Individual c, void * optional_datas){
         // Select two distinct indices randomly
         int i, j;
         do {
-            i = rand() % individual_size;
-            j = rand() % individual_size;
+            i = random_int() % individual_size;
+            j = random_int() % individual_size;
         } while (i == j);
 
         // Swap the values at the selected indices and return the mutated individual
@@ -121,12 +121,12 @@ Individual insertion_mutate(Individual c, void * optional_datas){
     int individual_size = c.size;
     if (individual_size + 1 < c.max_size){
         /* Select random index to insert gene */
-        int index = rand() % (individual_size + 1);
+        int index = random_int() % (individual_size + 1);
         /* Choose a random gene to insert */
         Gene gene = create_gene();
         /* Create a new string with the inserted gene */
         Individual new_individual;
-        new_individual.genome = calloc(c.size + 2, sizeof(Gene));
+        new_individual.genome = scratch_calloc(c.size + 2, sizeof(Gene));
         strncpy(new_individual.genome, c.genome, index);
         new_individual.genome[index] = gene;
         strcpy(&new_individual.genome[index+1], &c.genome[index]);
@@ -154,10 +154,10 @@ Individual deletion_mutate(Individual c, void * optional_datas){
     int individual_size = c.size;
     if (individual_size -1 >= min_individual_size){
         /* Select random index to delete gene */
-        int index = rand() % individual_size;
+        int index = random_int() % individual_size;
         /* Create a new string with the deleted gene */
         Individual new_individual;
-        new_individual.genome = (char*) malloc((c.size) * sizeof(Gene));
+        new_individual.genome = scratch_alloc((c.size) * sizeof(Gene));
         memcpy(new_individual.genome, c.genome, index * sizeof(Gene));
         memcpy(&new_individual.genome[index], &c.genome[index+1], (c.size - index - 1) * sizeof(Gene));
         /* Free memory allocated for the old individual and return the new individual */
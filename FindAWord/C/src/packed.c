@@ -0,0 +1,429 @@
+#include <packed.h>
+
+// Number of different genes, a packed gene is in [0, PACKED_GENES[
+#define PACKED_GENES (MAXCHAR - MINCHAR + 1)
+// Bit 0 of every 7 bits lane of a word
+#define LANES_BIT0 0x102040810204081ULL
+// Low 6 bits of every lane
+#define LANES_LOW6 (LANES_BIT0 * 0x3FULL)
+// High bit of every lane
+#define LANES_HIGH6 (LANES_BIT0 * 0x40ULL)
+// All the bits of every lane
+#define LANES_ALL (LANES_BIT0 * PACKED_GENE_MASK)
+// Low 7 bits of every byte, and MINCHAR in every byte
+#define BYTES_LOW7 0x7F7F7F7F7F7F7F7FULL
+#define BYTES_MINCHAR (0x0101010101010101ULL * MINCHAR)
+
+/**
+ * @brief Returns the number of words of a packed genome of the given length.
+ * @param length The length of the genome.
+ * @return The number of words.
+*/
+static inline int packed_words(int length){
+    return (length + PACKED_GENES_PER_WORD - 1) / PACKED_GENES_PER_WORD;
+}
+
+/**
+ * @brief Returns the mask of the lanes of the first genes of a word.
+ * @param genes The number of genes, at most PACKED_GENES_PER_WORD.
+ * @return The mask of the lanes of the genes.
+*/
+static inline uint64_t lanes_mask(int genes){
+    return genes >= PACKED_GENES_PER_WORD ? LANES_ALL : (1ULL << (genes * PACKED_GENE_BITS)) - 1;
+}
+
+/**
+ * @brief Returns a random packed gene.
+ * @return A packed gene, the packed value of create_gene().
+*/
+static inline uint64_t random_packed_gene(){
+    return (uint64_t) (random_int() % PACKED_GENES);
+}
+
+/**
+ * @brief Returns the genome of an individual of a packed population.
+ * @param p The packed population.
+ * @param index The index of the individual.
+ * @return The first word of the genome.
+*/
+static inline uint64_t *packed_genome(const PackedPopulation *p, size_t index){
+    return p->words + index * p->words_per_individual;
+}
+
+/**
+ * @brief Fills a packed genome with random genes.
+ * @param genome The genome, words_per_individual words.
+ * @param length The length of the genome.
+ * @param words_per_individual The number of words of the genome.
+*/
+static void random_packed_genome(uint64_t *genome, int length, int words_per_individual){
+    for (int w = 0; w < words_per_individual; w++){
+        int genes = length - w * PACKED_GENES_PER_WORD;
+        uint64_t word = 0;
+        for (int k = 0; k < PACKED_GENES_PER_WORD && k < genes; k++)
+            word |= random_packed_gene() << (k * PACKED_GENE_BITS);
+        genome[w] = word;
+    }
+}
+
+/**
+ * @brief Creates a packed population of random individuals.
+ * @param size The number of individuals in the population.
+ * @param min_size_individual The minimum size of each individual.
+ * @param max_size_individual The maximum size of each individual, at most PACKED_MAX_LENGTH.
+ * @return The packed population. Its words are NULL if the allocation failed or the sizes are not valid.
+*/
+PackedPopulation create_packed_population(size_t size, int min_size_individual, int max_size_individual){
+    PackedPopulation p;
+    memset(&p, 0, sizeof(PackedPopulation));
+    if (size == 0 || max_size_individual > PACKED_MAX_LENGTH || min_size_individual > max_size_individual)
+        return p;
+    p.words_per_individual = packed_words(max_size_individual);
+    p.words = malloc(size * p.words_per_individual * sizeof(uint64_t));
+    p.lengths = malloc(size * sizeof(uint8_t));
+    p.distances = malloc(size * sizeof(uint8_t));
+    if (p.words == NULL || p.lengths == NULL || p.distances == NULL){
+        free_packed_population(p);
+        memset(&p, 0, sizeof(PackedPopulation));
+        return p;
+    }
+    p.size = size;
+    p.min_individual_size = min_size_individual;
+    p.max_individual_size = max_size_individual;
+    for (size_t i = 0; i < size; i++){
+        p.lengths[i] = (uint8_t) (random_int() % (max_size_individual - min_size_individual + 1) + min_size_individual);
+        random_packed_genome(packed_genome(&p, i), p.lengths[i], p.words_per_individual);
+    }
+    return p;
+}
+
+/**
+ * @brief Frees the memory used by a packed population.
+ * @param p The packed population to free.
+*/
+void free_packed_population(PackedPopulation p){
+    free(p.words);
+    free(p.lengths);
+    free(p.distances);
+}
+
+/**
+ * @brief Packs a population.
+ * @param p The population to pack. It is left unchanged.
+ * @return The packed population, with the same individuals. Its words are NULL if the allocation failed.
+*/
+PackedPopulation pack_population(Population p){
+    PackedPopulation packed = create_packed_population(p.size, p.min_individual_size, p.max_individual_size);
+    if (packed.words == NULL)
+        return packed;
+    packed.generation = p.generation;
+    for (size_t i = 0; i < packed.size; i++){
+        packed.lengths[i] = (uint8_t) p.individuals[i].size;
+        pack_genes(p.individuals[i].genome, p.individuals[i].size, packed_genome(&packed, i));
+    }
+    return packed;
+}
+
+/**
+ * @brief Unpacks an individual of a packed population, to use it with the functions of the other modules.
+ * @param p The packed population.
+ * @param index The index of the individual.
+ * @return The individual, to free with free_individual. Its genome is NULL if the allocation failed.
+*/
+Individual unpack_individual(const PackedPopulation *p, size_t index){
+    Individual c;
+    c.size = p->lengths[index];
+    c.min_size = p->min_individual_size;
+    c.max_size = p->max_individual_size;
+    c.genome = allocate_genome(sizeof(Gene) * (c.size + 1));
+    if (c.genome != NULL){
+        unpack_genes(packed_genome(p, index), c.size, c.genome);
+        c.genome[c.size] = '\0';
+    }
+    return c;
+}
+
+/**
+ * @brief Packs genes, 9 genes per word.
+ * With BMI2 the first 8 genes of a word are packed with one pext. The genes must be between MINCHAR
+ * and MAXCHAR. The unused lanes of the last word are set to 0.
+ * @param genes The genes to pack.
+ * @param length The number of genes.
+ * @param words The packed genes, (length + 8) / 9 words.
+*/
+void pack_genes(const Gene *genes, int length, uint64_t *words){
+    int i = 0;
+#if defined(__BMI2__)
+    for (; i + PACKED_GENES_PER_WORD <= length; i += PACKED_GENES_PER_WORD){
+        uint64_t bytes;
+        memcpy(&bytes, genes + i, sizeof(uint64_t));
+        // Every byte is at least MINCHAR, so the subtraction does not borrow across bytes
+        bytes = _pext_u64(bytes - BYTES_MINCHAR, BYTES_LOW7);
+        words[i / PACKED_GENES_PER_WORD] = bytes | ((uint64_t) ((genes[i + 8] - MINCHAR) & PACKED_GENE_MASK) << 56);
+    }
+#endif
+    for (; i < length; i += PACKED_GENES_PER_WORD){
+        uint64_t word = 0;
+        for (int k = 0; k < PACKED_GENES_PER_WORD && i + k < length; k++)
+            word |= (uint64_t) ((genes[i + k] - MINCHAR) & PACKED_GENE_MASK) << (k * PACKED_GENE_BITS);
+        words[i / PACKED_GENES_PER_WORD] = word;
+    }
+}
+
+/**
+ * @brief Unpacks genes, to use a packed genome with the fitness functions working on characters.
+ * With BMI2 the first 8 genes of a word are unpacked with one pdep. No terminator is written.
+ * @param words The packed genes.
+ * @param length The number of genes.
+ * @param genes The unpacked genes, length characters.
+*/
+void unpack_genes(const uint64_t *words, int length, Gene *genes){
+    int i = 0;
+#if defined(__BMI2__)
+    for (; i + PACKED_GENES_PER_WORD <= length; i += PACKED_GENES_PER_WORD){
+        uint64_t word = words[i / PACKED_GENES_PER_WORD];
+        // A packed gene is below 96, adding MINCHAR does not carry across bytes
+        uint64_t bytes = _pdep_u64(word, BYTES_LOW7) + BYTES_MINCHAR;
+        memcpy(genes + i, &bytes, sizeof(uint64_t));
+        genes[i + 8] = (Gene) (((word >> 56) & PACKED_GENE_MASK) + MINCHAR);
+    }
+#endif
+    for (; i < length; i += PACKED_GENES_PER_WORD){
+        uint64_t word = words[i / PACKED_GENES_PER_WORD];
+        for (int k = 0; k < PACKED_GENES_PER_WORD && i + k < length; k++)
+            genes[i + k] = (Gene) (((word >> (k * PACKED_GENE_BITS)) & PACKED_GENE_MASK) + MINCHAR);
+    }
+}
+
+/**
+ * @brief Computes the modified Hamming distance between two packed genomes.
+ * The genes of a word are compared at once: a lane of a ^ b is not zero if its low 6 bits plus 0x3F
+ * or its high bit set the high bit of the lane, and the high bits are counted with a popcount.
+ * The result is modified_hamming_distance of the unpacked genomes.
+ * @param individual The packed genome of the individual.
+ * @param individual_length The length of the individual.
+ * @param word The packed target word.
+ * @param word_length The length of the word.
+ * @return The number of different genes plus the difference of length.
+*/
+int packed_hamming_distance(const uint64_t *individual, int individual_length, const uint64_t *word, int word_length){
+    int min_length = individual_length < word_length ? individual_length : word_length;
+    int distance = abs(individual_length - word_length);
+    int full_words = min_length / PACKED_GENES_PER_WORD;
+    int w = 0;
+    for (; w < full_words; w++){
+        uint64_t x = individual[w] ^ word[w];
+        distance += __builtin_popcountll((((x & LANES_LOW6) + LANES_LOW6) | x) & LANES_HIGH6);
+    }
+    int remaining = min_length - full_words * PACKED_GENES_PER_WORD;
+    if (remaining != 0){
+        uint64_t x = (individual[w] ^ word[w]) & lanes_mask(remaining);
+        distance += __builtin_popcountll((((x & LANES_LOW6) + LANES_LOW6) | x) & LANES_HIGH6);
+    }
+    return distance;
+}
+
+/**
+ * @brief Performs uniform crossover between two packed genomes.
+ * As uniform_crossover, each shared gene comes from either parent with a 50% chance, and the child takes
+ * the length of either parent. The shared genes of a word are selected at once with a random lane mask.
+ * @param p1 The packed genome of the first parent.
+ * @param p1_length The length of the first parent.
+ * @param p2 The packed genome of the second parent.
+ * @param p2_length The length of the second parent.
+ * @param child The packed genome of the child, large enough for the longest parent.
+ * @return The length of the child.
+*/
+int packed_uniform_crossover(const uint64_t *p1, int p1_length, const uint64_t *p2, int p2_length, uint64_t *child){
+    int min_length = p1_length < p2_length ? p1_length : p2_length;
+    int child_length = random_int() % 2 ? p1_length : p2_length;
+    const uint64_t *longest = p1_length > p2_length ? p1 : p2;
+
+    int child_words = packed_words(child_length);
+    for (int w = 0; w < child_words; w++){
+        int shared = min_length - w * PACKED_GENES_PER_WORD;
+        shared = shared < 0 ? 0 : shared;
+        uint64_t bits = (uint64_t) random_int();
+#if defined(__BMI2__)
+        uint64_t select = _pdep_u64(bits, LANES_BIT0) * PACKED_GENE_MASK;
+#else
+        uint64_t select = 0;
+        for (int k = 0; k < PACKED_GENES_PER_WORD; k++)
+            select |= ((bits >> k) & 1) * (PACKED_GENE_MASK << (k * PACKED_GENE_BITS));
+#endif
+        uint64_t shared_mask = lanes_mask(shared);
+        uint64_t word = ((p1[w] & select) | (p2[w] & ~select)) & shared_mask;
+        // The genes after the shorter parent come from the longest parent or are random, with a 50% chance
+        int genes = child_length - w * PACKED_GENES_PER_WORD;
+        for (int k = shared; k < PACKED_GENES_PER_WORD && k < genes; k++){
+            uint64_t gene = random_int() % 2 ? (longest[w] >> (k * PACKED_GENE_BITS)) & PACKED_GENE_MASK : random_packed_gene();
+            word |= gene << (k * PACKED_GENE_BITS);
+        }
+        child[w] = word;
+    }
+    return child_length;
+}
+
+/**
+ * @brief Performs random mutation on a packed genome, as random_mutate.
+ * @param genome The packed genome.
+ * @param length The length of the genome.
+ * @param mutation_rate The mutation rate, 0 or less for 1 / length.
+*/
+void packed_random_mutate(uint64_t *genome, int length, float mutation_rate){
+    if (length == 0)
+        return;
+    if (mutation_rate <= 0.0f)
+        mutation_rate = 1.0f / length;
+    int number_of_mutations = (int) (mutation_rate * length);
+    for (int i = 0; i < number_of_mutations; i++){
+        int gene_to_modify = random_int() % length;
+        int shift = (gene_to_modify % PACKED_GENES_PER_WORD) * PACKED_GENE_BITS;
+        uint64_t *word = genome + gene_to_modify / PACKED_GENES_PER_WORD;
+        *word = (*word & ~(PACKED_GENE_MASK << shift)) | (random_packed_gene() << shift);
+    }
+}
+
+/**
+ * @brief Selects a parent with a binary tournament on the distances.
+ * @param p The evaluated packed population.
+ * @return The index of the parent.
+*/
+static inline size_t packed_tournament(const PackedPopulation *p){
+    size_t a = (size_t) random_int() % p->size;
+    size_t b = (size_t) random_int() % p->size;
+    return p->distances[a] <= p->distances[b] ? a : b;
+}
+
+/**
+ * @brief Creates a new generation of a packed population.
+ * The operators are fixed, since a packed genome can not be given to the function pointers of the other
+ * modules: modified Hamming distance, 40% of elites kept in rank order, 20% of children of binary tournament
+ * parents with uniform crossover and random mutation, and random individuals. The ranking is a counting
+ * sort on the distances, which fit in 8 bits, so the only memory used per individual besides the genomes
+ * is one byte of distance.
+ * The new generation is written in next, then the genomes of p and next are swapped: p holds the new
+ * generation and next is reused by the following call. Both must have the same size and sizes.
+ * The scores of the statistics are the distances of the evaluated population, and the best individual is
+ * the individual 0 of the new generation.
+ * @param p The packed population to generate the new generation from.
+ * @param next A packed population of the same size, used as buffer.
+ * @param word The target word, with characters between MINCHAR and MAXCHAR.
+ * @param mutation_rate The mutation rate, 0 or less for 1 / length.
+ * @param stats The statistics of the generation, or NULL. Its reporting function is set by the caller.
+*/
+void packed_make_generation(PackedPopulation *p, PackedPopulation *next, const char *word, float mutation_rate, GenerationStats *stats){
+    GenerationStats temporary_stats = {0};
+    if (stats == NULL)
+        stats = &temporary_stats;
+    reset_generation_stats(stats);
+
+    int word_length = strlen(word);
+    if (p->size == 0 || p->size != next->size || p->words_per_individual != next->words_per_individual)
+        return;
+    uint64_t *packed_word = calloc(packed_words(word_length) + 1, sizeof(uint64_t));
+    if (packed_word == NULL)
+        return;
+    pack_genes(word, word_length, packed_word);
+    int generation = p->generation;
+    GA_PROBE2(generation_start, generation, p->size);
+    PHASE_START(start);
+    PROFILE_START(ticks);
+
+    /* Distances and their histogram */
+    size_t histogram[PACKED_MAX_LENGTH + 1] = {0};
+    for (size_t i = 0; i < p->size; i++){
+        int distance = packed_hamming_distance(packed_genome(p, i), p->lengths[i], packed_word, word_length);
+        distance = distance > PACKED_MAX_LENGTH ? PACKED_MAX_LENGTH : distance;
+        p->distances[i] = (uint8_t) distance;
+        histogram[distance]++;
+    }
+    stats->evaluations = (int) p->size;
+    PROFILE_LAP(PROFILE_FITNESS, ticks);
+    PHASE_END(stats, PHASE_FITNESS, start);
+
+    double sum = 0.0, sum_squares = 0.0;
+    int best_distance = -1;
+    for (int d = 0; d <= PACKED_MAX_LENGTH; d++){
+        if (histogram[d] != 0 && best_distance == -1)
+            best_distance = d;
+        sum += (double) d * histogram[d];
+        sum_squares += (double) d * d * histogram[d];
+    }
+    double mean = sum / p->size;
+    stats->best_score = (float) best_distance;
+    stats->mean_score = (float) mean;
+    stats->variance_score = (float) (sum_squares / p->size - mean * mean);
+    stats->exact_match = best_distance == 0;
+
+    /* Counting sort of the elites: offsets of each distance up to the last one kept */
+    size_t elite_size = (size_t) (0.4f * p->size);
+    size_t offsets[PACKED_MAX_LENGTH + 1];
+    size_t kept = 0;
+    int threshold = 0;
+    for (; threshold <= PACKED_MAX_LENGTH && kept < elite_size; threshold++){
+        offsets[threshold] = kept;
+        kept += histogram[threshold];
+    }
+    PROFILE_LAP(PROFILE_RANKING, ticks);
+    PHASE_END(stats, PHASE_RANKING, start);
+
+    size_t last_quota = kept > elite_size ? histogram[threshold - 1] - (kept - elite_size) : 0;
+    for (size_t i = 0; i < p->size && elite_size != 0; i++){
+        int distance = p->distances[i];
+        if (distance >= threshold)
+            continue;
+        if (distance == threshold - 1 && kept > elite_size){
+            if (last_quota == 0)
+                continue;
+            last_quota--;
+        }
+        size_t position = offsets[distance]++;
+        memcpy(packed_genome(next, position), packed_genome(p, i), p->words_per_individual * sizeof(uint64_t));
+        next->lengths[position] = p->lengths[i];
+    }
+    PROFILE_LAP(PROFILE_ELITISM, ticks);
+    PHASE_END(stats, PHASE_ELITISM, start);
+
+    /* Children of binary tournament parents */
+    size_t number_of_child = (size_t) (0.4f * p->size) >> 1;
+    if (elite_size + number_of_child > p->size)
+        number_of_child = p->size - elite_size;
+    for (size_t i = elite_size; i < elite_size + number_of_child; i++){
+        size_t p1 = packed_tournament(p);
+        size_t p2 = packed_tournament(p);
+        uint64_t *child = packed_genome(next, i);
+        int child_length = packed_uniform_crossover(packed_genome(p, p1), p->lengths[p1], packed_genome(p, p2), p->lengths[p2], child);
+        packed_random_mutate(child, child_length, mutation_rate);
+        next->lengths[i] = (uint8_t) child_length;
+    }
+    PROFILE_LAP(PROFILE_CROSSOVER, ticks);
+    PHASE_END(stats, PHASE_BREEDING, start);
+
+    /* Fill pop */
+    for (size_t i = elite_size + number_of_child; i < p->size; i++){
+        next->lengths[i] = (uint8_t) (random_int() % (p->max_individual_size - p->min_individual_size + 1) + p->min_individual_size);
+        random_packed_genome(packed_genome(next, i), next->lengths[i], p->words_per_individual);
+    }
+
+    uint64_t *words = p->words;
+    uint8_t *lengths = p->lengths;
+    p->words = next->words;
+    p->lengths = next->lengths;
+    next->words = words;
+    next->lengths = lengths;
+    p->generation++;
+    if (elite_size != 0){
+        stats->best_index = 0;
+        if (stats->reporting_function != NULL){
+            Individual best = unpack_individual(p, 0);
+            if (best.genome != NULL)
+                stats->reporting_score = stats->reporting_function(best.genome, word, stats->reporting_optional_datas);
+            free_individual(best);
+        }
+    }
+    PROFILE_LAP(PROFILE_REFILL, ticks);
+    PHASE_END(stats, PHASE_REFILL, start);
+    free(packed_word);
+    GA_PROBE3(generation_end, generation, stats->evaluations, stats->exact_match);
+}
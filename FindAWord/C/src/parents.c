@@ -1,38 +1,41 @@
 #include <parents.h>
 
+/**
+ * @brief Shuffles an array of indices in place with the Fisher-Yates algorithm.
+ * Complexity : O(n), one random draw per element.
+ * @param indices The indices to shuffle.
+ * @param size The number of indices.
+*/
+void shuffle_indices(size_t *indices, size_t size){
+    for (size_t i = size; i > 1; i--){
+        size_t j = random_index(i);
+        size_t temp = indices[i - 1];
+        indices[i - 1] = indices[j];
+        indices[j] = temp;
+    }
+}
+
 /**
  * @brief Randomly pairs selected individuals.
- * Given a list of selected individuals, this function creates random pairs of individuals by 
- * randomly selecting two distinct indicesfrom the list of selected indices. 
- * The selected indices are marked as -1 to prevent them from being selected again in the next iteration.
- * @param selected_indices List of indices of selected individuals.
+ * Given a list of selected individuals, this function shuffles the list once with the Fisher-Yates algorithm
+ * and pairs the consecutive individuals of the shuffled list.
+ * @param selected_indices List of indices of selected individuals. It is shuffled in place.
  * @param selected_size Number of selected individuals.
  * @param optional_datas Unused parameter.
- * @return List of random pairs of individuals.
+ * @return List of random pairs of individuals, as population indices.
 */
-Parents * random_pairing_parents(int *selected_indices, int selected_size, void *optional_datas){
-    int nb = 0, i;
-    int parents_size = selected_size>>1;
-    if (parents_size == 0 || selected_indices == NULL || selected_size == 0)
+Parents * random_pairing_parents(size_t *selected_indices, size_t selected_size, void *optional_datas){
+    size_t parents_size = selected_size>>1;
+    if (parents_size == 0 || selected_indices == NULL)
+        return NULL;
+    Parents *parents = scratch_alloc(sizeof(Parents)*parents_size);
+    if (parents == NULL)
         return NULL;
-    Parents *parents = malloc(sizeof(Parents)*parents_size);
-
-    // Iterate through the selected indices and create random pairs.
-    while (nb < selected_size - 1) {
-        // Randomly select two distinct indices from the list of selected indices.
-        int p[2];
-        for (i = 0; i < 2; i++) {
-            int index;
-            do {
-                index = rand() % selected_size;
-            } while (selected_indices[index] == -1);
-            p[i] = index;
-            selected_indices[index] = -1;
 
-        }
-        parents[nb >>1].p1 = p[0];
-        parents[nb >>1].p2 = p[1];
-        nb += 2;
+    shuffle_indices(selected_indices, selected_size);
+    for (size_t i = 0; i < parents_size; i++){
+        parents[i].p1 = selected_indices[2*i];
+        parents[i].p2 = selected_indices[2*i+1];
     }
 
     // Return the list of pairs.
@@ -47,15 +50,15 @@ Parents * random_pairing_parents(int *selected_indices, int selected_size, void
  * @param selected_size The size of the selected_indices array.
  * @param optional_datas Optional data to be passed to the function. This parameter is not used in this function.
  * @return A pointer to an array of Parents structs, containing the pairs of parent indices.
- * @note The returned pointer must be freed by the caller.
+ * @note The returned pointer must be freed by the caller with scratch_free.
 */
-Parents* consecutive_pairing_parents(int *selected_indices, int selected_size, void *optional_datas) {
-    int parents_size = selected_size>>1;
-    Parents *parents = malloc(sizeof(Parents)*parents_size);
-    int nb = 0;
+Parents* consecutive_pairing_parents(size_t *selected_indices, size_t selected_size, void *optional_datas) {
+    size_t parents_size = selected_size>>1;
+    Parents *parents = scratch_alloc(sizeof(Parents)*parents_size);
+    size_t nb = 0;
 
     // Iterate through the selected indices and create pairs of consecutive indices.
-    for (int i = 0; i < selected_size-1; i+=2) {
+    for (size_t i = 0; i + 1 < selected_size; i+=2) {
         parents[nb].p1 = selected_indices[i];
         parents[nb].p2 = selected_indices[i+1];
         nb++;
@@ -74,13 +77,13 @@ Parents* consecutive_pairing_parents(int *selected_indices, int selected_size, v
  * @param optional_datas optional parameters that may be needed for the pairing
  * @return an array of paired parents
 */
-Parents* non_sequential_pairing_parents(int *selected_indices, int selected_size, void *optional_datas) {
-    int parents_size = selected_size>>1;
-    Parents *parents = malloc(sizeof(Parents)*parents_size);
-    int i, j, pair_index = 0;
+Parents* non_sequential_pairing_parents(size_t *selected_indices, size_t selected_size, void *optional_datas) {
+    size_t parents_size = selected_size>>1;
+    Parents *parents = scratch_alloc(sizeof(Parents)*parents_size);
+    size_t i, pair_index = 0;
     
     // Loop over the selected indices, except the last two
-    for (i = 0; i < selected_size-3; i += 2) {
+    for (i = 0; i + 3 < selected_size; i += 2) {
         // Pair each index with the second next index
         parents[pair_index].p1 = selected_indices[i];
         parents[pair_index].p2 = selected_indices[i+2];
@@ -93,4 +96,76 @@ Parents* non_sequential_pairing_parents(int *selected_indices, int selected_size
 
     // Return the parents
     return parents;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Sorts the selected indices from the best to the worst individual.
+ * The ranks are a permutation of the population, so the selected individuals are counted by rank and
+ * read back in the order of the ranking, with no comparison. Without ranking the selected indices are
+ * kept in their order.
+ * Complexity : O(n + selected_size) where n is the population size
+ * @param selected_indices An array of selected indices, sorted in place.
+ * @param selected_size The size of the array of selected indices.
+ * @param ranking The ranking of the population the indices refer to, or NULL.
+ * @return 0 on success, -1 on failure.
+*/
+static int sort_by_rank(size_t *selected_indices, size_t selected_size, Ranking *ranking){
+    if (ranking == NULL || ranking->ranks == NULL)
+        return 0;
+    // An individual can be selected several times
+    size_t *counts = scratch_calloc(ranking->size, sizeof(size_t));
+    if (counts == NULL)
+        return -1;
+    for (size_t i = 0; i < selected_size; i++)
+        counts[ranking->ranks[selected_indices[i]]]++;
+    size_t sorted = 0;
+    for (size_t rank = 0; rank < ranking->size && sorted < selected_size; rank++)
+        for (size_t c = 0; c < counts[rank]; c++)
+            selected_indices[sorted++] = ranking->order[rank];
+    scratch_free(counts);
+    return 0;
+}
+
+/**
+ * @brief Pairs parents of similar fitness (assortative mating).
+ * The selected individuals are sorted by rank and each individual is paired with the next one.
+ * @param selected_indices an array of selected indices, sorted in place
+ * @param selected_size the size of the array of selected indices
+ * @param optional_datas a pointer to the Ranking of the population computed by make_generation.
+ * If NULL, the selected indices are assumed to be already sorted from the best to the worst.
+ * @return an array of paired parents
+*/
+Parents* assortative_pairing_parents(size_t *selected_indices, size_t selected_size, void *optional_datas){
+    size_t parents_size = selected_size>>1;
+    if (parents_size == 0 || selected_indices == NULL)
+        return NULL;
+    if (sort_by_rank(selected_indices, selected_size, (Ranking *) optional_datas) != 0)
+        return NULL;
+    return consecutive_pairing_parents(selected_indices, selected_size, NULL);
+}
+
+/**
+ * @brief Pairs parents of opposite fitness (disassortative mating).
+ * The selected individuals are sorted by rank and the best one is paired with the worst one,
+ * the second best with the second worst, and so on.
+ * @param selected_indices an array of selected indices, sorted in place
+ * @param selected_size the size of the array of selected indices
+ * @param optional_datas a pointer to the Ranking of the population computed by make_generation.
+ * If NULL, the selected indices are assumed to be already sorted from the best to the worst.
+ * @return an array of paired parents
+*/
+Parents* disassortative_pairing_parents(size_t *selected_indices, size_t selected_size, void *optional_datas){
+    size_t parents_size = selected_size>>1;
+    if (parents_size == 0 || selected_indices == NULL)
+        return NULL;
+    if (sort_by_rank(selected_indices, selected_size, (Ranking *) optional_datas) != 0)
+        return NULL;
+    Parents *parents = scratch_alloc(sizeof(Parents)*parents_size);
+    if (parents == NULL)
+        return NULL;
+    for (size_t i = 0; i < parents_size; i++){
+        parents[i].p1 = selected_indices[i];
+        parents[i].p2 = selected_indices[selected_size - 1 - i];
+    }
+    return parents;
+}
@@ -0,0 +1,593 @@
+#include <pipeline.h>
+
+/**
+ * @brief Builds the ranking key of an individual: the lower the key, the better the individual.
+ * The score is mapped on an unsigned integer of the same order, and the index breaks the ties, so the keys
+ * of a generation are all different and their order does not depend on the thread which compares them.
+ * An exact match is ranked before every score, as make_generation moves it to the first rank.
+ * @param score The score of the individual.
+ * @param index The index of the individual in its generation.
+ * @param exact 1 if the individual is the word.
+ * @return The key.
+*/
+static inline uint64_t pipeline_key(float score, size_t index, int exact){
+    uint32_t bits;
+    memcpy(&bits, &score, sizeof(bits));
+    bits = (bits & 0x80000000u) ? ~bits : bits | 0x80000000u;
+    if (exact)
+        bits = 0;
+    return ((uint64_t) bits << 32) | index;
+}
+
+/**
+ * @brief Returns the index of the individual of a ranking key.
+ * @param key The key.
+ * @return The index.
+*/
+static inline size_t key_index(uint64_t key){
+    return (size_t) (key & 0xffffffffu);
+}
+
+/**
+ * @brief Derives the state of the random generator of a block from the seed of a pipeline, with the finalizer of splitmix64.
+ * @param seed The seed of the pipeline.
+ * @param generation The generation of the block.
+ * @param index The index of the block.
+ * @return The state, never 0.
+*/
+static uint64_t derive_state(uint64_t seed, uint64_t generation, uint64_t index){
+    uint64_t x = seed ^ (generation * 0x9E3779B97F4A7C15ULL) ^ (index * 0xD1B54A32D192ED03ULL);
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return x != 0 ? x : 1;
+}
+
+/**
+ * @brief Compares two ranking keys for qsort.
+*/
+static int compare_keys(const void *a, const void *b){
+    uint64_t x = *(const uint64_t *) a, y = *(const uint64_t *) b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Adds an individual to the top-k heap of a thread, which keeps the capacity lowest keys.
+ * @param thread The thread.
+ * @param capacity The capacity of the heap.
+ * @param key The key of the individual.
+*/
+static void push_best(PipelineThread *thread, size_t capacity, uint64_t key){
+    uint64_t *heap = thread->best;
+    size_t i;
+    if (thread->best_count < capacity){
+        i = thread->best_count++;
+        while (i > 0 && heap[(i - 1) / 2] < key){
+            heap[i] = heap[(i - 1) / 2];
+            i = (i - 1) / 2;
+        }
+        heap[i] = key;
+        return;
+    }
+    if (key >= heap[0])
+        return;
+    // The worst key is replaced and the new one sinks to its place
+    i = 0;
+    while (1){
+        size_t child = 2 * i + 1;
+        if (child >= capacity)
+            break;
+        if (child + 1 < capacity && heap[child + 1] > heap[child])
+            child++;
+        if (heap[child] <= key)
+            break;
+        heap[i] = heap[child];
+        i = child;
+    }
+    heap[i] = key;
+}
+
+/**
+ * @brief Restores the order of a min-heap of threads by the next key of their sorted best individuals.
+ * @param pipeline The pipeline.
+ * @param heads The heap of the indices of the threads.
+ * @param count The number of threads of the heap.
+ * @param positions The position of the next key of each thread.
+ * @param i The position of the thread whose key grew.
+*/
+static void sift_head(const Pipeline *pipeline, int *heads, int count, const size_t *positions, int i){
+    while (1){
+        int smallest = i;
+        for (int child = 2 * i + 1; child <= 2 * i + 2 && child < count; child++)
+            if (pipeline->threads[heads[child]].best[positions[heads[child]]] < pipeline->threads[heads[smallest]].best[positions[heads[smallest]]])
+                smallest = child;
+        if (smallest == i)
+            return;
+        int head = heads[i];
+        heads[i] = heads[smallest];
+        heads[smallest] = head;
+        i = smallest;
+    }
+}
+
+/**
+ * @brief Breeds, scores and publishes a block of the generation being bred.
+ * The slots of the block below elite_size take the elites of the current generation with their scores, the
+ * next ones the children of the pairs of winners, crossed over and mutated, and the last ones new random
+ * individuals. In the first generation the individuals are already in place and are only scored. The rank
+ * of the winner of a tournament does not depend on the scores, so each block also draws the ranks of its
+ * share of the tournaments of the generation. A child longer than the stride of the genomes, whose operators
+ * did not keep the bounds of its parents as the ones of crossover.c and mutation.c do, is truncated to
+ * max_individual_size genes. With a stop signal, a winner bred in the block is claimed.
+ * @param pipeline The pipeline.
+ * @param thread The thread breeding the block.
+ * @param block The index of the block.
+*/
+static void breed_block(Pipeline *pipeline, PipelineThread *thread, size_t block){
+    int target = pipeline->initial ? pipeline->current : 1 - pipeline->current;
+    const Population *parents = &pipeline->populations[pipeline->current];
+    Population *next = &pipeline->populations[target];
+    float *scores = pipeline->scores[target];
+    uint64_t *keys = pipeline->keys[target];
+    size_t first = block * PIPELINE_BLOCK;
+    size_t last = first + PIPELINE_BLOCK < pipeline->size ? first + PIPELINE_BLOCK : pipeline->size;
+    random_state = derive_state(pipeline->seed, next->generation, block);
+
+    for (size_t i = first; i < last; i++){
+        Individual *slot = &next->individuals[i];
+        if (!pipeline->initial && i < pipeline->elite_size){
+            size_t elite = pipeline->order[i];
+            slot->size = parents->individuals[elite].size;
+            memcpy(slot->genome, parents->individuals[elite].genome, sizeof(Gene) * (slot->size + 1));
+            scores[i] = pipeline->scores[pipeline->current][elite];
+            keys[i] = (pipeline->keys[pipeline->current][elite] & ~(uint64_t) 0xffffffffu) | i;
+        }
+        else {
+            if (!pipeline->initial && i - pipeline->elite_size < pipeline->parents_size){
+                const Parents *pair = &pipeline->parents[i - pipeline->elite_size];
+                Individual offspring = pipeline->crossover_function(parents->individuals[pair->p1], parents->individuals[pair->p2],\
+                                                                    pipeline->crossover_optional_datas);
+                GA_PROBE3(crossover, parents->individuals[pair->p1].size, parents->individuals[pair->p2].size, offspring.size);
+                int offspring_size = offspring.size;
+                offspring = pipeline->mutation_function(offspring, pipeline->mutation_optional_datas);
+                GA_PROBE2(mutation, offspring_size, offspring.size);
+                slot->size = offspring.size < next->max_individual_size ? offspring.size : next->max_individual_size;
+                memcpy(slot->genome, offspring.genome, sizeof(Gene) * slot->size);
+                slot->genome[slot->size] = '\0';
+                free_individual(offspring);
+            }
+            else if (!pipeline->initial){
+                // A new random individual, as create_individual, written in its slot
+                slot->size = random_int() % (next->max_individual_size - next->min_individual_size + 1) + next->min_individual_size;
+                for (int g = 0; g < slot->size; g++)
+                    slot->genome[g] = create_gene();
+                slot->genome[slot->size] = '\0';
+            }
+            scores[i] = pipeline->fitness_function(slot->genome, pipeline->word, pipeline->fitness_optional_datas);
+            thread->evaluations++;
+            // The float fitness functions may not return exactly 0 on a match
+            int exact = scores[i] <= EPSILON && strcmp(slot->genome, pipeline->word) == 0;
+            keys[i] = pipeline_key(scores[i], i, exact);
+            if (pipeline->stop != NULL && !pipeline->initial && is_winner(pipeline->stop, slot->genome, scores[i], pipeline->word)\
+                && claim_stop(pipeline->stop, slot->genome, scores[i]))
+                thread->claimed = 1;
+        }
+        if (thread->diversity != NULL)
+            add_to_diversity(thread->diversity, *slot);
+        thread->sum += scores[i];
+        thread->sum_squares += (double) scores[i] * scores[i];
+        push_best(thread, pipeline->ranked_size, keys[i]);
+    }
+
+    // Rank of the winner of a tournament, the largest r such that (1 - r / size)^t >= 1 - u
+    double n = pipeline->size;
+    for (size_t t = block * pipeline->selected_size / pipeline->block_count; t < (block + 1) * pipeline->selected_size / pipeline->block_count; t++){
+        double u = (double) random_int() / ((double) RAND_MAX + 1);
+        pipeline->winner_ranks[t] = (size_t) (n * (1.0 - pow(1.0 - u, 1.0 / pipeline->tournament_size)));
+    }
+}
+
+/**
+ * @brief Work of a thread in a generation: breeds blocks until there is none left or a stop is requested,
+ * and sorts the best individuals of its blocks. The first generation is scored whatever the stop signal.
+ * @param thread The thread.
+*/
+static void run_thread_generation(PipelineThread *thread){
+    Pipeline *pipeline = thread->pipeline;
+    Workspace *previous_workspace = set_workspace(thread->workspace);
+    size_t allocations = scratch_allocations();
+    thread->best_count = 0;
+    thread->sum = 0.0;
+    thread->sum_squares = 0.0;
+    thread->evaluations = 0;
+    thread->claimed = 0;
+    if (thread->diversity != NULL)
+        reset_diversity(thread->diversity);
+
+    size_t block;
+    while ((pipeline->initial || pipeline->stop == NULL || !stop_requested(pipeline->stop))\
+           && (block = atomic_fetch_add(&pipeline->next_block, 1)) < pipeline->block_count)
+        breed_block(pipeline, thread, block);
+    qsort(thread->best, thread->best_count, sizeof(uint64_t), compare_keys);
+
+    thread->allocations = scratch_allocations() - allocations;
+    set_workspace(previous_workspace);
+}
+
+/**
+ * @brief Loop of a started thread of a pipeline: waits for a generation, works on it, and reports it is done.
+ * @param argument The PipelineThread.
+ * @return NULL.
+*/
+static void *pipeline_thread(void *argument){
+    PipelineThread *thread = argument;
+    Pipeline *pipeline = thread->pipeline;
+    size_t round = 0;
+    while (1){
+        pthread_mutex_lock(&pipeline->lock);
+        while (!pipeline->closed && pipeline->round == round)
+            pthread_cond_wait(&pipeline->released, &pipeline->lock);
+        if (pipeline->closed){
+            pthread_mutex_unlock(&pipeline->lock);
+            return NULL;
+        }
+        round = pipeline->round;
+        pthread_mutex_unlock(&pipeline->lock);
+
+        run_thread_generation(thread);
+
+        pthread_mutex_lock(&pipeline->lock);
+        if (--pipeline->pending == 0)
+            pthread_cond_signal(&pipeline->finished);
+        pthread_mutex_unlock(&pipeline->lock);
+    }
+}
+
+/**
+ * @brief Runs the parallel pass of a generation on every thread, the calling thread included.
+ * The random generator of the calling thread is left untouched.
+ * @param pipeline The pipeline.
+ * @return 1 if every block was bred and the new generation is the current one, 0 if a stop dropped it.
+*/
+static int run_generation(Pipeline *pipeline){
+    uint64_t state = random_state;
+    atomic_store(&pipeline->next_block, 0);
+
+    pthread_mutex_lock(&pipeline->lock);
+    pipeline->round++;
+    pipeline->pending = pipeline->running;
+    pthread_cond_broadcast(&pipeline->released);
+    pthread_mutex_unlock(&pipeline->lock);
+    run_thread_generation(&pipeline->threads[0]);
+    pthread_mutex_lock(&pipeline->lock);
+    while (pipeline->pending > 0)
+        pthread_cond_wait(&pipeline->finished, &pipeline->lock);
+    pthread_mutex_unlock(&pipeline->lock);
+    random_state = state;
+
+    if (atomic_load(&pipeline->next_block) < pipeline->block_count)
+        return 0;
+    if (!pipeline->initial)
+        pipeline->current = 1 - pipeline->current;
+    return 1;
+}
+
+/**
+ * @brief Merges the selection of the threads once a generation is published: the ranked individuals of the
+ * generation, best first, and the winners of its tournaments.
+ * @param pipeline The pipeline.
+*/
+static void select_generation(Pipeline *pipeline){
+    // The sorted heaps of the threads are merged through a heap of their next keys, the best first
+    size_t positions[pipeline->thread_count];
+    int heads[pipeline->thread_count];
+    int count = 0;
+    for (int t = 0; t < pipeline->thread_count; t++){
+        positions[t] = 0;
+        if (pipeline->threads[t].best_count > 0)
+            heads[count++] = t;
+    }
+    for (int i = count / 2 - 1; i >= 0; i--)
+        sift_head(pipeline, heads, count, positions, i);
+    for (size_t r = 0; r < pipeline->ranked_size && count > 0; r++){
+        int t = heads[0];
+        pipeline->order[r] = key_index(pipeline->threads[t].best[positions[t]++]);
+        if (positions[t] == pipeline->threads[t].best_count)
+            heads[0] = heads[--count];
+        sift_head(pipeline, heads, count, positions, 0);
+    }
+    for (size_t t = 0; t < pipeline->selected_size; t++){
+        size_t rank = pipeline->winner_ranks[t] < pipeline->ranked_size ? pipeline->winner_ranks[t] : pipeline->ranked_size - 1;
+        pipeline->winners[t] = pipeline->order[rank];
+    }
+}
+
+/**
+ * @brief Merges the diversity models of the threads into the model of the pipeline once a generation is published.
+ * @param pipeline The pipeline.
+*/
+static void merge_thread_diversity(Pipeline *pipeline){
+    if (pipeline->diversity == NULL)
+        return;
+    reset_diversity(pipeline->diversity);
+    for (int t = 0; t < pipeline->thread_count; t++)
+        merge_diversity(pipeline->diversity, pipeline->threads[t].diversity);
+}
+
+/**
+ * @brief Frees a pipeline: stops its threads and frees its generations. The populations returned by
+ * pipeline_generation and pipeline_population must no longer be used.
+ * @param pipeline The pipeline, may be NULL.
+*/
+void free_pipeline(Pipeline *pipeline){
+    if (pipeline == NULL)
+        return;
+    pthread_mutex_lock(&pipeline->lock);
+    pipeline->closed = 1;
+    pthread_cond_broadcast(&pipeline->released);
+    pthread_mutex_unlock(&pipeline->lock);
+    for (int t = 1; t <= pipeline->running; t++)
+        pthread_join(pipeline->threads[t].thread, NULL);
+    pthread_mutex_destroy(&pipeline->lock);
+    pthread_cond_destroy(&pipeline->released);
+    pthread_cond_destroy(&pipeline->finished);
+
+    if (pipeline->threads != NULL)
+        for (int t = 0; t < pipeline->thread_count; t++){
+            free_workspace(pipeline->threads[t].workspace);
+            free(pipeline->threads[t].best);
+            free_diversity(pipeline->threads[t].diversity);
+        }
+    free(pipeline->threads);
+    for (int k = 0; k < 2; k++){
+        free(pipeline->populations[k].individuals);
+        free(pipeline->genomes[k]);
+        free(pipeline->scores[k]);
+        free(pipeline->keys[k]);
+    }
+    free(pipeline->order);
+    free(pipeline->winner_ranks);
+    free(pipeline->winners);
+    free(pipeline);
+}
+
+/**
+ * @brief Creates a pipeline from a population, and scores it on the threads of the pipeline.
+ * The genomes of the population are copied, the population is left to the caller.
+ * @param p The first generation, of at least 5 individuals. Its diversity model, if any, is kept up to date
+ * with the current generation of the pipeline and must outlive it, as its stop signal, if any.
+ * @param word The target word, which must outlive the pipeline.
+ * @param thread_count The number of threads, the thread calling pipeline_generation included.
+ * @param seed The seed of the random generators of the blocks.
+ * @param fitness_function The fitness function, called from every thread.
+ * @param fitness_optional_datas Optional data to be passed to the fitness function.
+ * @param selection_function The selection function, tournament_selection: the pipeline draws the winners of
+ * its tournaments from their rank, see Pipeline, and does not run other selection functions.
+ * @param pairing_function The pairing function of the winners of the tournaments, called from the calling thread.
+ * The winners are given in the order of their tournaments, the pairings by rank see them as sorted.
+ * @param pairing_optional_datas Optional data to be passed to the pairing function.
+ * @param crossover_function The crossover function, called from every thread.
+ * @param crossover_optional_datas Optional data to be passed to the crossover function.
+ * @param mutation_function The mutation function, called from every thread.
+ * The crossover and mutation functions should keep the children within the max_size of their parents, see breed_block.
+ * @param mutation_optional_datas Optional data to be passed to the mutation function.
+ * @return The pipeline, or NULL on failure or with another selection function than tournament_selection.
+*/
+Pipeline *create_pipeline(Population p, const char *word, int thread_count, uint64_t seed,\
+                          FitnessFunction fitness_function, void *fitness_optional_datas, SelectionFunction selection_function,\
+                          PairingFunction pairing_function, void *pairing_optional_datas,\
+                          CrossoverFunction crossover_function, void *crossover_optional_datas,\
+                          MutationFunction mutation_function, void *mutation_optional_datas){
+    if (selection_function != tournament_selection)
+        return NULL;
+    if (word == NULL || thread_count < 1 || p.size < 5 || p.size > UINT32_MAX || p.max_individual_size < p.min_individual_size)
+        return NULL;
+    Pipeline *pipeline = calloc(1, sizeof(Pipeline));
+    if (pipeline == NULL)
+        return NULL;
+    pthread_mutex_init(&pipeline->lock, NULL);
+    pthread_cond_init(&pipeline->released, NULL);
+    pthread_cond_init(&pipeline->finished, NULL);
+    pipeline->size = p.size;
+    pipeline->stride = (size_t) p.max_individual_size + 1;
+    pipeline->block_count = (p.size + PIPELINE_BLOCK - 1) / PIPELINE_BLOCK;
+    pipeline->elite_size = (size_t) (PIPELINE_ELITISM_RATE * p.size);
+    pipeline->selected_size = (size_t) (PIPELINE_SELECTION_RATE * p.size);
+    pipeline->tournament_size = p.size >> 2 > 2 ? p.size >> 2 : 2;
+    // A draw of random_int() is at least 1 / (RAND_MAX + 1) from 1, which bounds the rank of a winner
+    size_t reach = (size_t) (p.size * (1.0 - pow((double) RAND_MAX + 1, -1.0 / pipeline->tournament_size))) + 1;
+    pipeline->ranked_size = reach > pipeline->elite_size ? reach : pipeline->elite_size;
+    if (pipeline->ranked_size > p.size)
+        pipeline->ranked_size = p.size;
+    pipeline->word = word;
+    pipeline->seed = seed;
+    pipeline->fitness_function = fitness_function;
+    pipeline->fitness_optional_datas = fitness_optional_datas;
+    pipeline->pairing_function = pairing_function;
+    pipeline->pairing_optional_datas = pairing_optional_datas;
+    pipeline->crossover_function = crossover_function;
+    pipeline->crossover_optional_datas = crossover_optional_datas;
+    pipeline->mutation_function = mutation_function;
+    pipeline->mutation_optional_datas = mutation_optional_datas;
+    pipeline->diversity = p.diversity;
+    pipeline->stop = p.stop;
+
+    int failed = 0;
+    for (int k = 0; k < 2; k++){
+        Population *population = &pipeline->populations[k];
+        *population = (Population) {0};
+        population->size = p.size;
+        population->min_individual_size = p.min_individual_size;
+        population->max_individual_size = p.max_individual_size;
+        population->generation = p.generation;
+        population->diversity = p.diversity;
+        population->individuals = malloc(sizeof(Individual) * p.size);
+        pipeline->genomes[k] = malloc(sizeof(Gene) * pipeline->stride * p.size);
+        pipeline->scores[k] = malloc(sizeof(float) * p.size);
+        pipeline->keys[k] = malloc(sizeof(uint64_t) * p.size);
+        if (population->individuals == NULL || pipeline->genomes[k] == NULL || pipeline->scores[k] == NULL || pipeline->keys[k] == NULL){
+            failed = 1;
+            continue;
+        }
+        for (size_t i = 0; i < p.size; i++){
+            population->individuals[i].genome = pipeline->genomes[k] + i * pipeline->stride;
+            population->individuals[i].size = 0;
+            population->individuals[i].genome[0] = '\0';
+            population->individuals[i].min_size = p.min_individual_size;
+            population->individuals[i].max_size = p.max_individual_size;
+        }
+    }
+    pipeline->order = malloc(sizeof(size_t) * pipeline->ranked_size);
+    pipeline->winner_ranks = malloc(sizeof(size_t) * pipeline->selected_size);
+    pipeline->winners = malloc(sizeof(size_t) * pipeline->selected_size);
+    pipeline->threads = calloc(thread_count, sizeof(PipelineThread));
+    if (failed || pipeline->order == NULL || pipeline->winner_ranks == NULL || pipeline->winners == NULL || pipeline->threads == NULL){
+        free_pipeline(pipeline);
+        return NULL;
+    }
+    pipeline->thread_count = thread_count;
+    for (int t = 0; t < thread_count; t++){
+        PipelineThread *thread = &pipeline->threads[t];
+        thread->pipeline = pipeline;
+        thread->index = t;
+        // The thread 0 also holds the pairs of parents of a generation
+        thread->workspace = create_workspace(t == 0 ? p.size : PIPELINE_BLOCK, p.max_individual_size);
+        thread->best = malloc(sizeof(uint64_t) * pipeline->ranked_size);
+        if (p.diversity != NULL)
+            thread->diversity = create_diversity(p.diversity->max_size);
+        if (thread->workspace == NULL || thread->best == NULL || (p.diversity != NULL && thread->diversity == NULL)){
+            free_pipeline(pipeline);
+            return NULL;
+        }
+    }
+
+    // The first generation is copied in place and scored as the next ones
+    Population *first = &pipeline->populations[0];
+    for (size_t i = 0; i < p.size; i++){
+        int size = p.individuals[i].size < p.max_individual_size ? p.individuals[i].size : p.max_individual_size;
+        memcpy(first->individuals[i].genome, p.individuals[i].genome, sizeof(Gene) * size);
+        first->individuals[i].genome[size] = '\0';
+        first->individuals[i].size = size;
+    }
+
+    for (int t = 1; t < thread_count; t++){
+        if (pthread_create(&pipeline->threads[t].thread, NULL, pipeline_thread, &pipeline->threads[t]) != 0){
+            free_pipeline(pipeline);
+            return NULL;
+        }
+        pipeline->running = t;
+    }
+    pipeline->initial = 1;
+    run_generation(pipeline);
+    select_generation(pipeline);
+    merge_thread_diversity(pipeline);
+    pipeline->initial = 0;
+    return pipeline;
+}
+
+/**
+ * @brief Breeds the next generation of a pipeline from its current generation, scores it and selects its
+ * elites and its parents, in one parallel pass, see Pipeline.
+ * The winners of the tournaments of the current generation are paired in the calling thread, with its random
+ * generator, then the threads breed, score and publish the blocks of the new generation.
+ * @param pipeline The pipeline.
+ * @param stats The statistics of the new generation, or NULL. The pairing time is counted in PHASE_PAIRING,
+ * the parallel pass in PHASE_BREEDING, and the merge of the selections of the threads in PHASE_SELECTION.
+ * @return The new generation, owned by the pipeline and valid until its next generation. Its best individual
+ * is at stats->best_index. If a stop was requested during the pass, stats->stopped is set and the current
+ * generation is returned as it was, with the evaluations of the dropped blocks; a winner bred by the pipeline
+ * is then in the stop signal, its score in stats->best_score and stats->best_index is -1.
+*/
+Population pipeline_generation(Pipeline *pipeline, GenerationStats *stats){
+    GenerationStats temporary_stats = {0};
+    if (stats == NULL)
+        stats = &temporary_stats;
+    reset_generation_stats(stats);
+    int generation = pipeline->populations[pipeline->current].generation;
+    GA_PROBE2(generation_start, generation, pipeline->size);
+    PHASE_START(start);
+    PROFILE_START(ticks);
+    Workspace *previous_workspace = set_workspace(pipeline->threads[0].workspace);
+    size_t allocations = scratch_allocations();
+
+    pipeline->parents = pipeline->pairing_function(pipeline->winners, pipeline->selected_size, pipeline->pairing_optional_datas);
+    pipeline->parents_size = pipeline->parents != NULL ? pipeline->selected_size >> 1 : 0;
+    PROFILE_LAP(PROFILE_PAIRING, ticks);
+    PHASE_END(stats, PHASE_PAIRING, start);
+
+    pipeline->populations[1 - pipeline->current].generation = generation + 1;
+    int bred = run_generation(pipeline);
+    PROFILE_LAP(PROFILE_PIPELINE, ticks);
+    PHASE_END(stats, PHASE_BREEDING, start);
+    if (pipeline->parents != NULL)
+        scratch_free(pipeline->parents);
+    pipeline->parents = NULL;
+    if (bred)
+        select_generation(pipeline);
+
+    Population p = pipeline->populations[pipeline->current];
+    double sum = 0.0, sum_squares = 0.0;
+    for (int t = 0; t < pipeline->thread_count; t++){
+        if (pipeline->threads[t].claimed){
+            stats->best_score = pipeline->stop->winner_score;
+            stats->exact_match = strcmp(pipeline->stop->winner, pipeline->word) == 0;
+        }
+        sum += pipeline->threads[t].sum;
+        sum_squares += pipeline->threads[t].sum_squares;
+        stats->evaluations += pipeline->threads[t].evaluations;
+        if (t != 0){
+            stats->allocations += pipeline->threads[t].allocations;
+            end_workspace_generation(pipeline->threads[t].workspace, pipeline->threads[t].allocations);
+        }
+    }
+    if (!bred){
+        // The selection and the diversity model still describe the current generation
+        stats->stopped = 1;
+        stats->best_index = -1;
+        if (pipeline->diversity != NULL){
+            stats->entropy = diversity_entropy(pipeline->diversity, NULL);
+            stats->consensus_distance = diversity_consensus_distance(pipeline->diversity);
+        }
+        size_t own_allocations = scratch_allocations() - allocations;
+        stats->allocations += own_allocations;
+        end_workspace_generation(pipeline->threads[0].workspace, own_allocations);
+        set_workspace(previous_workspace);
+        GA_PROBE3(generation_end, generation, stats->evaluations, stats->exact_match);
+        return p;
+    }
+    size_t best = pipeline->order[0];
+    double mean = sum / p.size;
+    double variance = sum_squares / p.size - mean * mean;
+    stats->best_index = best;
+    stats->best_score = pipeline->scores[pipeline->current][best];
+    stats->mean_score = (float) mean;
+    stats->variance_score = (float) (variance > 0.0 ? variance : 0.0);
+    stats->exact_match = (pipeline->keys[pipeline->current][best] >> 32) == 0;
+    if (stats->exact_match)
+        GA_PROBE3(exact_match, p.generation, best, p.individuals[best].genome);
+    if (stats->reporting_function != NULL)
+        stats->reporting_score = stats->reporting_function(p.individuals[best].genome, pipeline->word, stats->reporting_optional_datas);
+    merge_thread_diversity(pipeline);
+    if (pipeline->diversity != NULL){
+        stats->entropy = diversity_entropy(pipeline->diversity, NULL);
+        stats->consensus_distance = diversity_consensus_distance(pipeline->diversity);
+    }
+    PROFILE_LAP(PROFILE_SELECTION, ticks);
+    PHASE_END(stats, PHASE_SELECTION, start);
+
+    size_t own_allocations = scratch_allocations() - allocations;
+    stats->allocations += own_allocations;
+    end_workspace_generation(pipeline->threads[0].workspace, own_allocations);
+    set_workspace(previous_workspace);
+    GA_PROBE3(generation_end, generation, stats->evaluations, stats->exact_match);
+    return p;
+}
+
+/**
+ * @brief Returns the current generation of a pipeline, scored.
+ * @param pipeline The pipeline.
+ * @return The generation, owned by the pipeline and valid until its next generation.
+*/
+Population pipeline_population(const Pipeline *pipeline){
+    return pipeline->populations[pipeline->current];
+}
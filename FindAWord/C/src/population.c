@@ -1,4 +1,8 @@
 #include <population.h>
+#include <columnar.h>
+
+// Forces the inlining of the generation steps, so the operators of a generation variant are known at compile time
+#define ALWAYS_INLINE inline __attribute__((always_inline))
 
 /**
  * @brief Creates a new population of individuals with the given size and range of sizes for each individual.
@@ -7,12 +11,12 @@
  * @param max_size_individual The maximum size of each individual.
  * @return Population A new population of individuals with the given size and range of sizes for each individual.
 */
-Population create_population(int size, int min_size_individual, int max_size_individual){
+Population create_population(size_t size, int min_size_individual, int max_size_individual){
     Population population;
     if (size != 0){
-        population.individuals = malloc(size*sizeof(Individual));
+        population.individuals = scratch_alloc(size*sizeof(Individual));
         if (population.individuals != NULL){
-            for(int i = 0; i < size; i++)
+            for(size_t i = 0; i < size; i++)
                 population.individuals[i] = create_individual(min_size_individual, max_size_individual);
         }
     }
@@ -20,142 +24,846 @@ Population create_population(int size, int min_size_individual, int max_size_ind
         population.max_individual_size = max_size_individual;
         population.size = size;
         population.generation = 0;
+        population.dedup = NULL;
+        population.diversity = NULL;
+        population.arena = NULL;
+        population.stop = NULL;
+        population.workspace = NULL;
+        population.score_cache = NULL;
     return population;
 }
 
 /**
  * @brief Frees the memory used by a population.
  * This function frees the memory used by a population and its individuals.
+ * The dedup table, the diversity model, the genome arena and the workspace are not freed, they are owned by
+ * the caller and outlive the generations.
  * @param p The population to free.
 */
 void free_population(Population p){
     if (p.size != 0 && p.individuals != NULL){
-        for (int i = 0; i < p.size; i++){
+        // The genomes of the arena are released with their space, not freed
+        GenomeArena *previous_arena = p.arena != NULL ? set_genome_arena(p.arena) : NULL;
+        Workspace *previous_workspace = p.workspace != NULL ? set_workspace(p.workspace) : NULL;
+        for (size_t i = 0; i < p.size; i++){
             free_individual(p.individuals[i]);
         }
-        free(p.individuals);
+        scratch_free(p.individuals);
+        if (p.arena != NULL)
+            set_genome_arena(previous_arena);
+        if (p.workspace != NULL)
+            set_workspace(previous_workspace);
         p.size = 0;
     }
 }
 
+
 /**
- * @brief Creates a new generation of individuals from a given population.
- * @param p The population to generate the new generation from.
- * @param word The target word to evolve towards.
- * @param fitness_function The fitness function to use to evaluate individuals.
+ * @brief Resets the results of generation statistics, keeping the reporting function set by the caller.
+ * @param stats The generation statistics to reset.
+*/
+void reset_generation_stats(GenerationStats *stats){
+    FitnessFunction reporting_function = stats->reporting_function;
+    void *reporting_optional_datas = stats->reporting_optional_datas;
+    memset(stats, 0, sizeof(GenerationStats));
+    stats->reporting_function = reporting_function;
+    stats->reporting_optional_datas = reporting_optional_datas;
+    stats->best_index = -1;
+    stats->reporting_score = -1.0f;
+}
+
+/**
+ * @brief Streams the genomes of a population stored in a genome arena through the fitness phase.
+ * Called for each individual, it asks the kernel to read the next chunk of GENOME_CHUNK genomes at the
+ * beginning of a chunk, so the disk reads overlap the evaluation of the current chunk.
+ * @param p The population being evaluated.
+ * @param i The index of the individual about to be evaluated.
+*/
+static inline void stream_genomes(Population p, size_t i){
+    if (p.arena == NULL || i % GENOME_CHUNK != 0 || i + GENOME_CHUNK >= p.size)
+        return;
+    size_t last = i + 2 * GENOME_CHUNK < p.size ? i + 2 * GENOME_CHUNK - 1 : p.size - 1;
+    prefetch_genomes(p.arena, p.individuals[i + GENOME_CHUNK].genome, p.individuals[last].genome + p.individuals[last].size);
+}
+
+/**
+ * @brief Ends the fitness phase of a population which has a stop signal, when a stop is requested.
+ * The winner found by this population, if any, is claimed. The generation stops when the claim succeeds, or
+ * when a stop was requested by another population sharing the signal or by the caller.
+ * @param p The population being evaluated.
+ * @param word The target word.
+ * @param winner_index The index of a winner of the population, or -1.
+ * @param winner_score The score of the winner.
+ * @param evaluations The number of individuals evaluated before the stop.
+ * @param stats The generation statistics.
+ * @return 1 if the generation stops and the population is returned as evaluated, 0 otherwise.
+*/
+static int stop_generation(Population p, const char *word, int64_t winner_index, float winner_score, size_t evaluations,\
+                           GenerationStats *stats){
+    if (winner_index != -1 && claim_stop(p.stop, p.individuals[winner_index].genome, winner_score)){
+        stats->best_index = winner_index;
+        stats->best_score = winner_score;
+        stats->exact_match = strcmp(p.individuals[winner_index].genome, word) == 0;
+        if (stats->exact_match)
+            GA_PROBE3(exact_match, p.generation, winner_index, p.individuals[winner_index].genome);
+    }
+    if (!stop_requested(p.stop))
+        return 0;
+    stats->stopped = 1;
+    stats->evaluations = evaluations;
+    // The population is returned as it was bred, which its diversity model still describes
+    if (p.diversity != NULL){
+        stats->entropy = diversity_entropy(p.diversity, NULL);
+        stats->consensus_distance = diversity_consensus_distance(p.diversity);
+    }
+    return 1;
+}
+
+/**
+ * @brief Finds the duplicates of a population which has a dedup table.
+ * In DEDUP_DROP mode the duplicates are replaced by random individuals, so every individual is evaluated. With
+ * a genome arena, the genomes of the duplicates are released in it and their replacements allocated in it.
+ * @param p The population to evaluate.
+ * @param stats The generation statistics, whose duplicate ratio is set.
+ * @return The index of the first copy of each individual, -1 for a first copy, or NULL if no score can be shared.
+*/
+static const int64_t *dedup_generation(Population p, GenerationStats *stats){
+    if (p.dedup == NULL)
+        return NULL;
+    PHASE_START(start);
+    PROFILE_START(ticks);
+    GenomeArena *previous_arena = p.arena != NULL ? set_genome_arena(p.arena) : NULL;
+    int status = dedup_individuals(p.dedup, p.individuals, p.size);
+    if (p.arena != NULL)
+        set_genome_arena(previous_arena);
+    if (status != 0)
+        return NULL;
+    size_t duplicates = p.dedup->duplicates;
+    if (duplicates > 0 && p.dedup->mode == DEDUP_DROP && p.diversity != NULL)
+        count_diversity(p.diversity, p.individuals, p.size);
+    PROFILE_LAP(PROFILE_DEDUP, ticks);
+    PHASE_END(stats, PHASE_DEDUP, start);
+    if (duplicates == 0)
+        return NULL;
+    stats->duplicate_ratio = (float) duplicates / p.size;
+    return p.dedup->mode == DEDUP_SHARE ? p.dedup->first : NULL;
+}
+
+/**
+ * @brief Takes the scores computed while the population was bred, when they were computed with the fitness
+ * function, optional data and word of this generation. The scores are only used once.
+ * @param p The population to evaluate, after the search of its duplicates.
+ * @param word The target word.
+ * @param fitness_function The fitness function of the generation.
+ * @param fitness_optional_datas The optional data of the fitness function.
+ * @return The score of each individual, or NULL if the population must be evaluated.
+*/
+static const float *cached_scores(Population p, const char *word, FitnessFunction fitness_function, void *fitness_optional_datas){
+    ScoreCache *cache = p.score_cache;
+    if (cache == NULL || !cache->valid)
+        return NULL;
+    cache->valid = 0;
+    if (cache->generation != p.generation || cache->size != p.size || cache->fitness_function != fitness_function\
+        || cache->fitness_optional_datas != fitness_optional_datas || cache->word != word)
+        return NULL;
+    // The duplicates replaced by random individuals were not scored
+    if (p.dedup != NULL && p.dedup->mode == DEDUP_DROP && p.dedup->duplicates > 0)
+        return NULL;
+    return cache->scores;
+}
+
+/**
+ * @brief Checks whether a population is scored through its column-major layout, see score_fixed_length.
+ * @param p The population to score.
+ * @param word The target word.
+ * @param fitness_function The fitness function of the generation.
+ * @return 1 if the population is scored many individuals at once, 0 otherwise.
+*/
+static int has_columnar_fitness(Population p, const char *word, FitnessFunction fitness_function){
+    if (fitness_function != modified_hamming_distance_fitness && fitness_function != manhattan_distance_fitness)
+        return 0;
+    return is_fixed_length(p, word);
+}
+
+/**
+ * @brief Scores a fixed-length population through its column-major layout.
+ * The modified Hamming and Manhattan fitness functions of a population whose individuals all have the length
+ * of the word are computed for many individuals at once, see columnar.h. The scores are the same as the
+ * ones of the fitness functions. With a workspace, the column-major copy is kept in it for the next generations.
+ * @param p The population to score.
+ * @param word The target word.
+ * @param fitness_function The fitness function of the generation.
+ * @param scores The score of each individual.
+ * @return 0 if the population was scored, -1 if the fitness function must be called for each individual.
+*/
+static int score_fixed_length(Population p, const char *word, FitnessFunction fitness_function, float *scores){
+    if (!has_columnar_fitness(p, word, fitness_function))
+        return -1;
+    ColumnPopulation temporary_columns = {0};
+    ColumnPopulation *columns = &temporary_columns;
+    if (p.workspace != NULL){
+        if (p.workspace->columns == NULL)
+            p.workspace->columns = calloc(1, sizeof(ColumnPopulation));
+        if (p.workspace->columns != NULL)
+            columns = p.workspace->columns;
+    }
+    if (reserve_column_population(columns, p.size, p.max_individual_size) != 0)
+        return -1;
+    rows_to_columns(p, columns);
+    if (fitness_function == modified_hamming_distance_fitness)
+        columnar_hamming_fitness(columns, word, scores);
+    else
+        columnar_manhattan_fitness(columns, word, scores);
+    if (columns == &temporary_columns)
+        free_column_population(temporary_columns);
+    return 0;
+}
+
+/**
+ * @brief Builds the next generation from the elites and the individuals selected for mating.
+ * The elites come first, then the children produced by the pairing, crossover and mutation
+ * functions, and the population is filled with new random individuals. Each child is written in its slot of
+ * the new generation as soon as it is mutated, without an intermediate array. The diversity model of the
+ * population, if any, is rebuilt as the individuals are written. The elites take the genomes of the population
+ * over, without copy. With a genome arena, the new generation is written in the other space of the arena, in the
+ * order of its individuals, elites included. With a score cache and a
+ * fitness function, every individual of the new generation is scored as it is written, see ScoreCache. A
+ * fixed-length population with a columnar fitness function is scored once it is written instead, through its
+ * column-major layout, see score_fixed_length, the elites excluded when they keep their scores.
+ * @param p The population to generate the new generation from. Its individuals are freed.
+ * @param word The target word.
+ * @param fitness_function The fitness function the new generation is scored with, or NULL not to score it.
  * @param fitness_optional_datas Optional data to be passed to the fitness function.
- * @param selection_function The selection function to use to select parents for reproduction.
- * @param selection_optional_datas Optional data to be passed to the selection function.
+ * @param scores The scores of the individuals of the population with this fitness function, which the elites
+ * keep, or NULL if the population was ranked with another fitness function: the elites are then scored again.
+ * @param elite_indices The indices of the individuals kept as they are, best first.
+ * @param elite_size The number of elites.
+ * @param selected_indices The indices of the individuals selected for mating.
+ * @param selected_size The number of individuals selected for mating.
  * @param pairing_function The pairing function to use to select pairs of parents for crossover.
  * @param pairing_optional_datas Optional data to be passed to the pairing function.
  * @param crossover_function The crossover function to use to produce children from pairs of parents.
  * @param crossover_optional_datas Optional data to be passed to the crossover function.
  * @param mutation_function The mutation function to use to mutate children.
  * @param mutation_optional_datas Optional data to be passed to the mutation function.
+ * @param stats The generation statistics whose phase times are updated.
  * @return The new generation of individuals.
 */
-Population make_generation(Population p, const char * word, FitnessFunction fitness_function, void *fitness_optional_datas, \
-                            SelectionFunction selection_function, void *selection_optional_datas,\
+static ALWAYS_INLINE Population breed_generation(Population p, const char *word, FitnessFunction fitness_function,\
+                            void *fitness_optional_datas, const float *scores, size_t *elite_indices, size_t elite_size,\
+                            size_t *selected_indices, size_t selected_size,\
                             PairingFunction pairing_function, void * pairing_optional_datas,\
                             CrossoverFunction crossover_function, void * crossover_optional_datas,\
-                            MutationFunction mutation_function, void * mutation_optional_datas){
-    Individual *children = NULL;
-    int * selected_indices;
-    int population_size = p.size;
-    float selection_rate = 0.4f;
-    float elitism_selection_rate = 0.4f;
-
-    if (population_size == 0)
-        return p;
+                            MutationFunction mutation_function, void * mutation_optional_datas,\
+                            GenerationStats *stats){
+    size_t population_size = p.size;
+    PHASE_START(start);
+    PROFILE_START(ticks);
 
     /* Allocate memory for new individuals*/
-    Individual * new_individuals = malloc(sizeof(Individual)*population_size);
-
-    /* Get fitness _scores for all individuals population*/
-    float * fitness_scores = malloc(sizeof(float)* population_size);
-    // If issues when allocating fitness_scores return p
-    if (fitness_scores == NULL) 
+    Individual * new_individuals = scratch_alloc(sizeof(Individual)*population_size);
+    if (new_individuals == NULL)
         return p;
+    PROFILE_ADD(allocations, 1);
+    PROFILE_ADD(allocated_bytes, sizeof(Individual)*population_size);
+    if (p.diversity != NULL)
+        reset_diversity(p.diversity);
+    // The scores of the new generation, written with its individuals
+    float *next_scores = NULL;
+    if (p.score_cache != NULL && fitness_function != NULL && reserve_score_cache(p.score_cache, population_size) == 0)
+        next_scores = p.score_cache->next_scores;
+    // The columnar scores of the whole new generation are faster than the scores of the children one by one
+    int columnar = next_scores != NULL && has_columnar_fitness(p, word, fitness_function);
+    float *row_scores = columnar ? NULL : next_scores;
+    size_t evaluations = 0;
+    GenomeArena *previous_arena = NULL;
+    if (p.arena != NULL){
+        previous_arena = set_genome_arena(p.arena);
+        flip_genome_arena(p.arena);
+    }
 
-    for(int i = 0; i < population_size; i++)
-        fitness_scores[i] = fitness_function(p.individuals[i].genome, word, fitness_optional_datas);
-
-    // Get selected indices with truncation selection for elistism selection
-    selected_indices = truncation_selection(p, fitness_scores, elitism_selection_rate, selection_optional_datas);
-    int selected_size = (int) (elitism_selection_rate * population_size);
-
-    if (selected_size != 0 && selected_indices != NULL){
-        for(int i = 0; i < selected_size; i++){
-            new_individuals[i].genome = malloc(sizeof(Gene) * (p.individuals[selected_indices[i]].size+1));
-            new_individuals[i].size = p.individuals[selected_indices[i]].size;
+    if (elite_size != 0 && elite_indices != NULL){
+        for(size_t i = 0; i < elite_size; i++){
+            if (p.arena != NULL){
+                // The space of the population is given back at the next flip, the elites are copied in the new one
+                new_individuals[i].genome = allocate_genome(sizeof(Gene) * (p.individuals[elite_indices[i]].size+1));
+                memcpy(new_individuals[i].genome, p.individuals[elite_indices[i]].genome, sizeof(Gene) * p.individuals[elite_indices[i]].size);
+                PROFILE_ADD(copied_bytes, sizeof(Gene) * p.individuals[elite_indices[i]].size);
+            }
+            else
+                // The genome is shared with the population until the parents are bred, then it belongs to the new generation
+                new_individuals[i].genome = p.individuals[elite_indices[i]].genome;
+            new_individuals[i].size = p.individuals[elite_indices[i]].size;
             new_individuals[i].max_size = p.max_individual_size;
             new_individuals[i].min_size = p.min_individual_size;
-            memcpy(new_individuals[i].genome, p.individuals[selected_indices[i]].genome, sizeof(Gene) * p.individuals[selected_indices[i]].size);
             new_individuals[i].genome[new_individuals[i].size] = '\0';
+            if (next_scores != NULL && scores != NULL)
+                next_scores[i] = scores[elite_indices[i]];
+            else if (row_scores != NULL){
+                row_scores[i] = fitness_function(new_individuals[i].genome, word, fitness_optional_datas);
+                evaluations++;
+            }
+            if (p.diversity != NULL)
+                add_to_diversity(p.diversity, new_individuals[i]);
         }
     }
-    if(selected_indices != NULL)
-        free(selected_indices);
-
-    int new_population_size = selected_size;
-
-    /* Get Selection */
-    selected_size = (int) (selection_rate * population_size);
-    selected_indices = selection_function(p, fitness_scores, selection_rate, selection_optional_datas);
-
-    /* We can free fitness_scores*/
-    if (fitness_scores != NULL){
-        free(fitness_scores);
+    else{
+        elite_size = 0;
     }
+    PROFILE_LAP(PROFILE_ELITISM, ticks);
+    PHASE_END(stats, PHASE_ELITISM, start);
+
+    size_t new_population_size = elite_size;
 
     if (selected_indices != NULL && selected_size != 0){
         /* Get Parents */
         Parents *parents;
         parents = pairing_function(selected_indices, selected_size, pairing_optional_datas);
-        /* We can free selected_indices */
-        if (selected_indices != NULL){
-            free(selected_indices);
-        }
+        PROFILE_LAP(PROFILE_PAIRING, ticks);
+        PHASE_END(stats, PHASE_PAIRING, start);
         if (parents != NULL){
-            int parents_size = selected_size >> 1;
-            int number_of_child = parents_size;
+            size_t parents_size = selected_size >> 1;
+            size_t number_of_child = parents_size;
 
-            Individual *children = malloc(sizeof(Individual)*number_of_child);
+            PROFILE_ADD(allocations, 1);
+            PROFILE_ADD(allocated_bytes, sizeof(Parents)*parents_size);
 
-            for(int i = 0; i < number_of_child; i++){
-                children[i] = crossover_function(p.individuals[parents[i].p1],p.individuals[parents[i].p2], crossover_optional_datas);
-                children[i] = mutation_function(children[i], mutation_optional_datas);
-            }
-            // Add children in new individuals
-            for(int i = new_population_size; i < new_population_size + number_of_child; i++){
-                new_individuals[i].genome = malloc(sizeof(Gene) * (children[i-new_population_size].size+1));
-                new_individuals[i].size = children[i-new_population_size].size;
-                new_individuals[i].max_size = p.max_individual_size;
-                new_individuals[i].min_size = p.min_individual_size;
-                memcpy(new_individuals[i].genome, children[i-new_population_size].genome, sizeof(Gene) * (children[i-new_population_size].size+1));
-                new_individuals[i].genome[new_individuals[i].size] = '\0';
-            }
-            new_population_size += number_of_child;
-            // All children are copied we can free children
-            if (children != NULL){
-                for (int i = 0; i < number_of_child ; i++){
-                    free_individual(children[i]);
+            // Each child is mutated, written in its slot and scored while its genome is still in the cache
+            for(size_t i = 0; i < number_of_child; i++){
+                Individual child = crossover_function(p.individuals[parents[i].p1],p.individuals[parents[i].p2], crossover_optional_datas);
+                PROFILE_LAP(PROFILE_CROSSOVER, ticks);
+                GA_PROBE3(crossover, p.individuals[parents[i].p1].size, p.individuals[parents[i].p2].size, child.size);
+                int child_size = child.size;
+                // The crossover functions allocate the genome of the child
+                PROFILE_ADD(allocations, 1);
+                PROFILE_ADD(allocated_bytes, sizeof(Gene) * (child.size + 1));
+                child = mutation_function(child, mutation_optional_datas);
+                PROFILE_LAP(PROFILE_MUTATION, ticks);
+                GA_PROBE2(mutation, child_size, child.size);
+                Individual *slot = &new_individuals[new_population_size + i];
+                if (p.arena != NULL){
+                    // The genomes of a generation follow each other in the arena
+                    slot->genome = allocate_genome(sizeof(Gene) * (child.size+1));
+                    memcpy(slot->genome, child.genome, sizeof(Gene) * child.size);
+                    PROFILE_ADD(copied_bytes, sizeof(Gene) * (child.size+1));
+                    free_individual(child);
+                }
+                else
+                    slot->genome = child.genome;
+                slot->size = child.size;
+                slot->max_size = p.max_individual_size;
+                slot->min_size = p.min_individual_size;
+                slot->genome[slot->size] = '\0';
+                PROFILE_LAP(PROFILE_COPY, ticks);
+                if (row_scores != NULL){
+                    row_scores[new_population_size + i] = fitness_function(slot->genome, word, fitness_optional_datas);
+                    evaluations++;
+                    PROFILE_LAP(PROFILE_FITNESS, ticks);
                 }
-                free(children);
+                if (p.diversity != NULL)
+                    add_to_diversity(p.diversity, *slot);
             }
+            new_population_size += number_of_child;
             if (parents != NULL && parents_size != 0){
-                free(parents);
+                scratch_free(parents);
             }
+            PROFILE_LAP(PROFILE_COPY, ticks);
+            PHASE_END(stats, PHASE_BREEDING, start);
         }
     }
     // Fill pop
-    for (int i = new_population_size; i < p.size; i++){
+    for (size_t i = new_population_size; i < p.size; i++){
         new_individuals[i] = create_individual(p.min_individual_size, p.max_individual_size);
+        if (row_scores != NULL){
+            row_scores[i] = fitness_function(new_individuals[i].genome, word, fitness_optional_datas);
+            evaluations++;
+        }
+        if (p.diversity != NULL)
+            add_to_diversity(p.diversity, new_individuals[i]);
     }
     new_population_size = p.size;
+    if (columnar){
+        Population scored = p;
+        size_t first = scores != NULL ? elite_size : 0;
+        scored.individuals = new_individuals + first;
+        scored.size = population_size - first;
+        if (score_fixed_length(scored, word, fitness_function, next_scores + first) == 0){
+            evaluations += scored.size;
+            PROFILE_LAP(PROFILE_FITNESS, ticks);
+        }
+        else
+            next_scores = NULL;
+    }
+    // The genomes moved to the elites are not freed with the population
+    if (p.arena == NULL)
+        for (size_t i = 0; i < elite_size; i++)
+            p.individuals[elite_indices[i]].genome = NULL;
     free_population(p);
+    if (p.arena != NULL)
+        set_genome_arena(previous_arena);
     p.individuals = new_individuals;
     p.size = new_population_size;
     p.generation++;
+    if (next_scores != NULL){
+        ScoreCache *cache = p.score_cache;
+        cache->next_scores = cache->scores;
+        cache->scores = next_scores;
+        cache->valid = 1;
+        cache->generation = p.generation;
+        cache->size = p.size;
+        cache->fitness_function = fitness_function;
+        cache->fitness_optional_datas = fitness_optional_datas;
+        cache->word = word;
+    }
+    stats->evaluations += evaluations;
+    PROFILE_LAP(PROFILE_REFILL, ticks);
+    PHASE_END(stats, PHASE_REFILL, start);
+    return p;
+}
+
+/**
+ * @brief Ranks the evaluated population and fills the score statistics of the generation.
+ * An exact match is moved to the first rank, it has the best possible score so the order stays sorted.
+ * @param p The evaluated population.
+ * @param word The target word.
+ * @param ranking The ranking whose scores are filled.
+ * @param distances The integer distances of the individuals to rank with a radix sort, or NULL to sort the scores.
+ * @param exact_index The index of an individual equal to the word, or -1.
+ * @param stats The generation statistics.
+ * @return 0 on success, -1 on failure.
+*/
+static int rank_generation(Population p, const char *word, Ranking *ranking, const int *distances, int64_t exact_index,\
+                            GenerationStats *stats){
+    size_t population_size = p.size;
+    PHASE_START(start);
+    PROFILE_START(ticks);
+
+    int ranked = distances != NULL ? rank_distances(ranking, distances, population_size) : rank_scores(ranking, population_size);
+    if (ranked != 0)
+        return -1;
+
+    if (exact_index != -1 && ranking->order[0] != (size_t) exact_index){
+        size_t exact_rank = ranking->ranks[exact_index];
+        ranking->order[exact_rank] = ranking->order[0];
+        ranking->ranks[ranking->order[0]] = exact_rank;
+        ranking->order[0] = exact_index;
+        ranking->ranks[exact_index] = 0;
+        ranking->best_index = exact_index;
+        ranking->best_score = ranking->scores[exact_index];
+    }
+    if (exact_index != -1)
+        GA_PROBE3(exact_match, p.generation, exact_index, p.individuals[exact_index].genome);
+
+    double variance = 0.0;
+    for (size_t i = 0; i < population_size; i++){
+        double deviation = ranking->scores[i] - ranking->mean_score;
+        variance += deviation * deviation;
+    }
+    stats->best_score = ranking->best_score;
+    stats->mean_score = ranking->mean_score;
+    stats->variance_score = (float) (variance / population_size);
+    stats->exact_match = exact_index != -1;
+    if (stats->reporting_function != NULL)
+        stats->reporting_score = stats->reporting_function(p.individuals[ranking->best_index].genome, word, stats->reporting_optional_datas);
+    PROFILE_LAP(PROFILE_RANKING, ticks);
+    PHASE_END(stats, PHASE_RANKING, start);
+    return 0;
+}
+
+/**
+ * @brief Selects the elites and the parents from a ranked population, and builds the next generation.
+ * @param p The population to generate the new generation from.
+ * @param word The target word.
+ * @param fitness_function The fitness function the new generation is scored with in its score cache, or NULL not to score it.
+ * @param fitness_optional_datas Optional data to be passed to the fitness function.
+ * @param elite_scores The scores the elites keep in the score cache, the ones of the ranking when the population
+ * was ranked with fitness_function, or NULL to score them again.
+ * @param ranking The ranking of the population.
+ * @param selection_function The selection function to use to select parents for reproduction.
+ * @param selection_optional_datas Optional data to be passed to the selection function.
+ * @param pairing_function The pairing function to use to select pairs of parents for crossover.
+ * @param pairing_optional_datas Optional data to be passed to the pairing function.
+ * @param crossover_function The crossover function to use to produce children from pairs of parents.
+ * @param crossover_optional_datas Optional data to be passed to the crossover function.
+ * @param mutation_function The mutation function to use to mutate children.
+ * @param mutation_optional_datas Optional data to be passed to the mutation function.
+ * @param stats The generation statistics.
+ * @return The new generation of individuals.
+*/
+static ALWAYS_INLINE Population select_and_breed(Population p, const char *word, FitnessFunction fitness_function,\
+                            void *fitness_optional_datas, const float *elite_scores, Ranking *ranking,\
+                            SelectionFunction selection_function, void *selection_optional_datas,\
+                            PairingFunction pairing_function, void * pairing_optional_datas,\
+                            CrossoverFunction crossover_function, void * crossover_optional_datas,\
+                            MutationFunction mutation_function, void * mutation_optional_datas,\
+                            GenerationStats *stats){
+    size_t * elite_indices;
+    size_t * selected_indices;
+    size_t population_size = p.size;
+    float selection_rate = 0.4f;
+    float elitism_selection_rate = 0.4f;
+    PHASE_START(start);
+    PROFILE_START(ticks);
+
+    // Get selected indices with truncation selection for elistism selection
+    elite_indices = truncation_selection(p, ranking, elitism_selection_rate, selection_optional_datas);
+    size_t elite_size = (size_t) (elitism_selection_rate * population_size);
+    PROFILE_LAP(PROFILE_ELITE_SELECTION, ticks);
+
+    /* Get Selection */
+    size_t selected_size = (size_t) (selection_rate * population_size);
+    selected_indices = selection_function(p, ranking, selection_rate, selection_optional_datas);
+    PROFILE_LAP(PROFILE_SELECTION, ticks);
+    PHASE_END(stats, PHASE_SELECTION, start);
+    // The selection functions allocate the arrays of indices
+    PROFILE_ADD(allocations, 2);
+    PROFILE_ADD(allocated_bytes, sizeof(size_t) * (elite_size + selected_size));
+
+    p = breed_generation(p, word, fitness_function, fitness_optional_datas, elite_scores,\
+                         elite_indices, elite_size, selected_indices, selected_size,\
+                         pairing_function, pairing_optional_datas,\
+                         crossover_function, crossover_optional_datas,\
+                         mutation_function, mutation_optional_datas, stats);
+
+    // The best individual is the first elite of the new generation
+    stats->best_index = elite_indices != NULL ? 0 : -1;
+    if (p.diversity != NULL){
+        stats->entropy = diversity_entropy(p.diversity, NULL);
+        stats->consensus_distance = diversity_consensus_distance(p.diversity);
+    }
+
+    if (elite_indices != NULL)
+        scratch_free(elite_indices);
+    if (selected_indices != NULL)
+        scratch_free(selected_indices);
     return p;
 }
+
+/**
+ * @brief Ends a generation: counts the allocations it made, checks them against the strict mode of the workspace
+ * of the population and gives the thread its previous workspace back.
+ * @param p The population, evaluated or new.
+ * @param previous_workspace The workspace of the thread before the generation.
+ * @param allocations The allocation count of the thread at the start of the generation, see scratch_allocations.
+ * @param stats The generation statistics, whose allocations are set.
+*/
+static void end_generation(Population p, Workspace *previous_workspace, size_t allocations, GenerationStats *stats){
+    stats->allocations = scratch_allocations() - allocations;
+    if (p.workspace == NULL)
+        return;
+    end_workspace_generation(p.workspace, stats->allocations);
+    set_workspace(previous_workspace);
+}
+
+/**
+ * @brief Body of make_generation, inlined in make_generation and in every generation variant.
+ * When the function pointers and the optional data are compile time constants, as in the generation
+ * variants, the compiler turns the indirect calls into direct calls and can inline the operators.
+ * The parameters are the ones of make_generation.
+ * @return The new generation of individuals.
+*/
+static ALWAYS_INLINE Population generation_template(Population p, const char * word, FitnessFunction fitness_function, void *fitness_optional_datas, \
+                            SelectionFunction selection_function, void *selection_optional_datas,\
+                            PairingFunction pairing_function, void * pairing_optional_datas,\
+                            CrossoverFunction crossover_function, void * crossover_optional_datas,\
+                            MutationFunction mutation_function, void * mutation_optional_datas,\
+                            Ranking *ranking, GenerationStats *stats){
+    size_t population_size = p.size;
+    int64_t exact_index = -1;
+    Ranking temporary_ranking;
+    GenerationStats temporary_stats = {0};
+
+    if (stats == NULL)
+        stats = &temporary_stats;
+    reset_generation_stats(stats);
+
+    if (population_size == 0)
+        return p;
+    int generation = p.generation;
+    GA_PROBE2(generation_start, generation, population_size);
+    // The buffers of the generation are allocated in the workspace of the population
+    Workspace *previous_workspace = p.workspace != NULL ? set_workspace(p.workspace) : NULL;
+    size_t allocations = scratch_allocations();
+
+    if (ranking == NULL){
+        temporary_ranking = create_ranking(population_size);
+        ranking = &temporary_ranking;
+    }
+    // If issues when allocating the ranking return p
+    if (reserve_ranking(ranking, population_size) == 0){
+        const int64_t *first = dedup_generation(p, stats);
+        const float *cached = cached_scores(p, word, fitness_function, fitness_optional_datas);
+        PHASE_START(start);
+        PROFILE_START(ticks);
+        size_t evaluated = population_size;
+        int64_t winner_index = -1;
+        stats->evaluations = cached != NULL ? 0 : population_size;
+        /* Get fitness _scores for all individuals population*/
+        if (cached != NULL || score_fixed_length(p, word, fitness_function, ranking->scores) != 0){
+            for(size_t i = 0; i < population_size; i++){
+                stream_genomes(p, i);
+                if (p.stop != NULL && i % STOP_CHECK_INTERVAL == 0 && stop_requested(p.stop)){
+                    evaluated = i;
+                    break;
+                }
+                // The individual was scored when it was bred
+                if (cached != NULL)
+                    ranking->scores[i] = cached[i];
+                // A duplicate takes the score of its first copy, which comes before it
+                else if (first != NULL && first[i] != -1){
+                    ranking->scores[i] = ranking->scores[first[i]];
+                    stats->evaluations--;
+                }
+                else
+                    ranking->scores[i] = fitness_function(p.individuals[i].genome, word, fitness_optional_datas);
+                if (p.stop != NULL && is_winner(p.stop, p.individuals[i].genome, ranking->scores[i], word)){
+                    winner_index = i;
+                    evaluated = i + 1;
+                    break;
+                }
+            }
+        }
+        else if (p.stop != NULL){
+            // The columnar scores are all computed, the winners are looked for afterwards
+            for(size_t i = 0; i < population_size && winner_index == -1; i++)
+                if (is_winner(p.stop, p.individuals[i].genome, ranking->scores[i], word))
+                    winner_index = i;
+        }
+        if (p.stop != NULL && stop_generation(p, word, winner_index, winner_index != -1 ? ranking->scores[winner_index] : 0.0f,\
+                                              cached != NULL ? 0 : stats->evaluations - (population_size - evaluated), stats)){
+            PROFILE_LAP(PROFILE_FITNESS, ticks);
+            PHASE_END(stats, PHASE_FITNESS, start);
+            PROFILE_GENERATION(stats);
+            GA_PROBE3(generation_end, generation, stats->evaluations, stats->exact_match);
+            if (ranking == &temporary_ranking)
+                free_ranking(temporary_ranking);
+            end_generation(p, previous_workspace, allocations, stats);
+            return p;
+        }
+        for(size_t i = 0; i < population_size; i++){
+            // The float fitness functions may not return exactly 0 on a match
+            if (ranking->scores[i] <= EPSILON && strcmp(p.individuals[i].genome, word) == 0){
+                exact_index = i;
+                break;
+            }
+        }
+        PROFILE_LAP(PROFILE_FITNESS, ticks);
+        PHASE_END(stats, PHASE_FITNESS, start);
+
+        // The new generation is scored with the fitness function it will be evaluated with, when the caller gives it
+        FitnessFunction breeding_fitness = fitness_function;
+        if (p.score_cache != NULL && p.score_cache->next_fitness_function != NULL)
+            breeding_fitness = p.score_cache->next_fitness_function;
+        if (rank_generation(p, word, ranking, NULL, exact_index, stats) == 0)
+            p = select_and_breed(p, word, breeding_fitness, fitness_optional_datas, breeding_fitness == fitness_function ? ranking->scores : NULL,\
+                                 ranking, selection_function, selection_optional_datas,\
+                                 pairing_function, pairing_optional_datas,\
+                                 crossover_function, crossover_optional_datas,\
+                                 mutation_function, mutation_optional_datas, stats);
+        PROFILE_GENERATION(stats);
+        GA_PROBE3(generation_end, generation, stats->evaluations, stats->exact_match);
+    }
+
+    if (ranking == &temporary_ranking)
+        free_ranking(temporary_ranking);
+    end_generation(p, previous_workspace, allocations, stats);
+    return p;
+}
+
+/**
+ * @brief Creates a new generation of individuals from a given population.
+ * The population is evaluated once and ranked once. The ranking is shared by the elitism and the
+ * selection function, and is left to the caller: the elites are copied in rank order at the beginning
+ * of the new generation, so the individual ranking->order[i] of the evaluated population is the individual i
+ * of the returned one, for every i below the number of elites.
+ * The statistics describe the evaluated population, so the caller does not need to evaluate it again.
+ * When the population has a dedup table, its duplicates are replaced or share the score of their first copy.
+ * When it has a workspace, the buffers of the generation are allocated in it and stats->allocations counts the
+ * allocations which did not reuse one of its blocks.
+ * @param p The population to generate the new generation from.
+ * @param word The target word to evolve towards.
+ * @param fitness_function The fitness function to use to evaluate individuals.
+ * @param fitness_optional_datas Optional data to be passed to the fitness function.
+ * @param selection_function The selection function to use to select parents for reproduction.
+ * @param selection_optional_datas Optional data to be passed to the selection function.
+ * @param pairing_function The pairing function to use to select pairs of parents for crossover.
+ * @param pairing_optional_datas Optional data to be passed to the pairing function.
+ * @param crossover_function The crossover function to use to produce children from pairs of parents.
+ * @param crossover_optional_datas Optional data to be passed to the crossover function.
+ * @param mutation_function The mutation function to use to mutate children.
+ * @param mutation_optional_datas Optional data to be passed to the mutation function.
+ * @param ranking The ranking of the evaluated population, reused across generations. NULL to use a temporary one.
+ * @param stats The statistics of the generation, or NULL. Its reporting function is set by the caller.
+ * @return The new generation of individuals.
+*/
+Population make_generation(Population p, const char * word, FitnessFunction fitness_function, void *fitness_optional_datas, \
+                            SelectionFunction selection_function, void *selection_optional_datas,\
+                            PairingFunction pairing_function, void * pairing_optional_datas,\
+                            CrossoverFunction crossover_function, void * crossover_optional_datas,\
+                            MutationFunction mutation_function, void * mutation_optional_datas,\
+                            Ranking *ranking, GenerationStats *stats){
+    return generation_template(p, word, fitness_function, fitness_optional_datas,\
+                               selection_function, selection_optional_datas,\
+                               pairing_function, pairing_optional_datas,\
+                               crossover_function, crossover_optional_datas,\
+                               mutation_function, mutation_optional_datas,\
+                               ranking, stats);
+}
+
+
+/**
+ * @brief Creates a new generation of individuals from a given population, in integer score mode.
+ * The individuals are scored with a DistanceFunction and ranked with a radix sort instead of qsort.
+ * The scores of the ranking are the distances divided by the largest distance of the generation, see
+ * rank_distances, so any selection function can be used.
+ * @param p The population to generate the new generation from.
+ * @param word The target word to evolve towards.
+ * @param distance_function The distance function to use to evaluate individuals.
+ * @param distance_optional_datas Optional data to be passed to the distance function.
+ * @param selection_function The selection function to use to select parents for reproduction.
+ * @param selection_optional_datas Optional data to be passed to the selection function.
+ * @param pairing_function The pairing function to use to select pairs of parents for crossover.
+ * @param pairing_optional_datas Optional data to be passed to the pairing function.
+ * @param crossover_function The crossover function to use to produce children from pairs of parents.
+ * @param crossover_optional_datas Optional data to be passed to the crossover function.
+ * @param mutation_function The mutation function to use to mutate children.
+ * @param mutation_optional_datas Optional data to be passed to the mutation function.
+ * @param ranking The ranking of the evaluated population, reused across generations. NULL to use a temporary one.
+ * @param stats The statistics of the generation, or NULL. Its reporting function is set by the caller.
+ * @return The new generation of individuals.
+*/
+Population make_generation_int(Population p, const char * word, DistanceFunction distance_function, void *distance_optional_datas, \
+                            SelectionFunction selection_function, void *selection_optional_datas,\
+                            PairingFunction pairing_function, void * pairing_optional_datas,\
+                            CrossoverFunction crossover_function, void * crossover_optional_datas,\
+                            MutationFunction mutation_function, void * mutation_optional_datas,\
+                            Ranking *ranking, GenerationStats *stats){
+    size_t population_size = p.size;
+    int64_t exact_index = -1;
+    Ranking temporary_ranking;
+    GenerationStats temporary_stats = {0};
+
+    if (stats == NULL)
+        stats = &temporary_stats;
+    reset_generation_stats(stats);
+
+    if (population_size == 0)
+        return p;
+    int generation = p.generation;
+    GA_PROBE2(generation_start, generation, population_size);
+    Workspace *previous_workspace = p.workspace != NULL ? set_workspace(p.workspace) : NULL;
+    size_t allocations = scratch_allocations();
+
+    /* Get distances for all individuals population*/
+    int * distances = scratch_alloc(sizeof(int)* population_size);
+    if (distances == NULL){
+        end_generation(p, previous_workspace, allocations, stats);
+        return p;
+    }
+
+    if (ranking == NULL){
+        temporary_ranking = create_ranking(population_size);
+        ranking = &temporary_ranking;
+    }
+    if (reserve_ranking(ranking, population_size) == 0){
+        const int64_t *first = dedup_generation(p, stats);
+        PHASE_START(start);
+        PROFILE_START(ticks);
+        size_t evaluated = population_size;
+        int64_t winner_index = -1;
+        stats->evaluations = population_size;
+        for(size_t i = 0; i < population_size; i++){
+            stream_genomes(p, i);
+            if (p.stop != NULL && i % STOP_CHECK_INTERVAL == 0 && stop_requested(p.stop)){
+                evaluated = i;
+                break;
+            }
+            if (first != NULL && first[i] != -1){
+                distances[i] = distances[first[i]];
+                stats->evaluations--;
+            }
+            else
+                distances[i] = distance_function(p.individuals[i].genome, word, distance_optional_datas);
+            if (exact_index == -1 && distances[i] == 0 && strcmp(p.individuals[i].genome, word) == 0)
+                exact_index = i;
+            if (p.stop != NULL && is_winner(p.stop, p.individuals[i].genome, (float) distances[i], word)){
+                winner_index = i;
+                evaluated = i + 1;
+                break;
+            }
+        }
+        int stopped = p.stop != NULL && stop_generation(p, word, winner_index, winner_index != -1 ? (float) distances[winner_index] : 0.0f,\
+                                                        stats->evaluations - (population_size - evaluated), stats);
+        PROFILE_LAP(PROFILE_FITNESS, ticks);
+        PHASE_END(stats, PHASE_FITNESS, start);
+
+        if (!stopped && rank_generation(p, word, ranking, distances, exact_index, stats) == 0)
+            p = select_and_breed(p, word, NULL, NULL, NULL, ranking, selection_function, selection_optional_datas,\
+                                 pairing_function, pairing_optional_datas,\
+                                 crossover_function, crossover_optional_datas,\
+                                 mutation_function, mutation_optional_datas, stats);
+        PROFILE_GENERATION(stats);
+        GA_PROBE3(generation_end, generation, stats->evaluations, stats->exact_match);
+    }
+
+    scratch_free(distances);
+    if (ranking == &temporary_ranking)
+        free_ranking(temporary_ranking);
+    end_generation(p, previous_workspace, allocations, stats);
+    return p;
+}
+
+/**
+ * @brief Defines a generation variant: make_generation specialized for a set of operators and optional data.
+*/
+#define DEFINE_GENERATION_VARIANT(name, fitness, fitness_datas, selection, selection_datas, pairing, pairing_datas,\
+                                  crossover, crossover_datas, mutation, mutation_datas)\
+Population make_generation_##name(Population p, const char * word, Ranking *ranking, GenerationStats *stats){\
+    return generation_template(p, word, fitness, fitness_datas, selection, selection_datas, pairing, pairing_datas,\
+                               crossover, crossover_datas, mutation, mutation_datas, ranking, stats);\
+}
+
+GENERATION_VARIANTS(DEFINE_GENERATION_VARIANT)
+
+/**
+ * @brief Entry of the table of the generation variants.
+*/
+typedef struct generation_variant {
+    GenerationFunction generation_function; /**< The specialized generation function. */
+    FitnessFunction fitness_function;       /**< Its fitness function. */
+    SelectionFunction selection_function;   /**< Its selection function. */
+    PairingFunction pairing_function;       /**< Its pairing function. */
+    CrossoverFunction crossover_function;   /**< Its crossover function. */
+    MutationFunction mutation_function;     /**< Its mutation function. */
+} GenerationVariant;
+
+#define GENERATION_VARIANT_ENTRY(name, fitness, fitness_datas, selection, selection_datas, pairing, pairing_datas,\
+                                 crossover, crossover_datas, mutation, mutation_datas)\
+    {make_generation_##name, fitness, selection, pairing, crossover, mutation},
+
+static const GenerationVariant generation_variants[] = {
+    GENERATION_VARIANTS(GENERATION_VARIANT_ENTRY)
+};
+
+/**
+ * @brief Looks for the generation variant specialized for a set of operators.
+ * @param fitness_function The fitness function.
+ * @param selection_function The selection function.
+ * @param pairing_function The pairing function.
+ * @param crossover_function The crossover function.
+ * @param mutation_function The mutation function.
+ * @return The generation variant, or NULL if there is none and make_generation must be used.
+*/
+GenerationFunction find_generation_variant(FitnessFunction fitness_function, SelectionFunction selection_function,\
+                                           PairingFunction pairing_function, CrossoverFunction crossover_function,\
+                                           MutationFunction mutation_function){
+    int variants_size = sizeof(generation_variants) / sizeof(GenerationVariant);
+    for (int i = 0; i < variants_size; i++){
+        const GenerationVariant *variant = &generation_variants[i];
+        if (variant->fitness_function == fitness_function && variant->selection_function == selection_function &&\
+            variant->pairing_function == pairing_function && variant->crossover_function == crossover_function &&\
+            variant->mutation_function == mutation_function)
+            return variant->generation_function;
+    }
+    return NULL;
+}
@@ -0,0 +1,103 @@
+#include <profile.h>
+#ifdef GA_PROFILE
+
+// Counters of the generations run by the thread
+__thread Profile generation_profile;
+
+// Output of the profile lines, shared by the threads, and the number of generations between two lines
+static FILE *profile_output = NULL;
+static uint64_t profile_interval = 0;
+// Ticks per nanosecond, measured once by the first set_profile_output or profile_seconds
+static double ticks_per_ns = 1.0;
+static pthread_once_t ticks_measured = PTHREAD_ONCE_INIT;
+
+// Names of the phases in the profile lines
+static const char *phase_names[PROFILE_PHASE_COUNT] = {
+    "dedup", "fitness", "ranking", "elite_selection", "selection", "elitism",
+    "pairing", "crossover", "mutation", "copy", "refill", "pipeline"
+};
+
+/**
+ * @brief Measures the ticks of profile_ticks per nanosecond against the monotonic clock.
+ * @return The number of ticks per nanosecond.
+*/
+static double measure_ticks_per_ns(){
+    struct timespec start, now, pause = {0, 10000000};
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    uint64_t first = profile_ticks();
+    nanosleep(&pause, NULL);
+    uint64_t last = profile_ticks();
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    double elapsed = (now.tv_sec - start.tv_sec) * 1e9 + (now.tv_nsec - start.tv_nsec);
+    return elapsed > 0 ? (last - first) / elapsed : 1.0;
+}
+
+/**
+ * @brief Sets ticks_per_ns, see measure_ticks_per_ns.
+*/
+static void set_ticks_per_ns(){
+    ticks_per_ns = measure_ticks_per_ns();
+}
+
+/**
+ * @brief Converts ticks of profile_ticks to seconds.
+ * @param ticks The number of ticks.
+ * @return The number of seconds.
+*/
+double profile_seconds(uint64_t ticks){
+    pthread_once(&ticks_measured, set_ticks_per_ns);
+    return ticks / ticks_per_ns * 1e-9;
+}
+
+/**
+ * @brief Sets where the profile lines are written. Each thread writes its counters every interval generations.
+ * @param output The output file, or NULL to stop writing.
+ * @param interval The number of generations between two lines, 0 to write only with write_profile.
+*/
+void set_profile_output(FILE *output, uint64_t interval){
+    pthread_once(&ticks_measured, set_ticks_per_ns);
+    profile_output = output;
+    profile_interval = interval;
+}
+
+/**
+ * @brief Counts a generation of the thread, and writes the profile of the thread every interval generations.
+ * @param evaluations The number of fitness function calls of the generation.
+*/
+void end_profile_generation(size_t evaluations){
+    generation_profile.generations++;
+    generation_profile.evaluations += evaluations;
+    if (profile_output != NULL && profile_interval != 0 && generation_profile.generations % profile_interval == 0)
+        write_profile(profile_output, &generation_profile);
+}
+
+/**
+ * @brief Writes a profile as a JSON line : the counters, then the time in nanoseconds and the number
+ * of calls of each phase. The counters are the totals since the last reset_profile.
+ * @param output The output file.
+ * @param profile The profile.
+*/
+void write_profile(FILE *output, const Profile *profile){
+    flockfile(output);
+    fprintf(output, "{\"thread\": %lu, \"generations\": %lu, \"evaluations\": %lu, \"allocations\": %lu, "\
+            "\"allocated_bytes\": %lu, \"copied_bytes\": %lu, \"ns\": {", (unsigned long) pthread_self(),\
+            (unsigned long) profile->generations, (unsigned long) profile->evaluations, (unsigned long) profile->allocations,\
+            (unsigned long) profile->allocated_bytes, (unsigned long) profile->copied_bytes);
+    for (int i = 0; i < PROFILE_PHASE_COUNT; i++)
+        fprintf(output, "%s\"%s\": %.0f", i ? ", " : "", phase_names[i], profile->ticks[i] / ticks_per_ns);
+    fprintf(output, "}, \"calls\": {");
+    for (int i = 0; i < PROFILE_PHASE_COUNT; i++)
+        fprintf(output, "%s\"%s\": %lu", i ? ", " : "", phase_names[i], (unsigned long) profile->calls[i]);
+    fprintf(output, "}}\n");
+    fflush(output);
+    funlockfile(output);
+}
+
+/**
+ * @brief Resets the profile of the calling thread.
+*/
+void reset_profile(){
+    memset(&generation_profile, 0, sizeof(Profile));
+}
+
+#endif
@@ -0,0 +1,18 @@
+#include <random.h>
+
+// Any non zero state, the threads which are not seeded start from it
+__thread uint64_t random_state = 0x9E3779B97F4A7C15ULL;
+
+/**
+ * @brief Seeds the random generator of the current thread.
+ * The seed goes through a splitmix64 step, so close seeds (job indices) give unrelated sequences.
+ * @param seed The seed.
+*/
+void seed_random(uint64_t seed){
+    uint64_t z = seed + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z ^= z >> 31;
+    // The xorshift state must not be 0
+    random_state = z != 0 ? z : 0x9E3779B97F4A7C15ULL;
+}
@@ -0,0 +1,191 @@
+#include <ranking.h>
+
+/**
+ * @brief Compare function used by qsort to sort an array of IndividualScore by their score
+ * @param a Pointer to the first IndividualScore struct to be compared
+ * @param b Pointer to the second IndividualScore struct to be compared
+ * @return int Returns a negative value if a should be placed before b, zero if they are equivalent,
+ * and a positive value if b should be placed before a in the sorted array
+*/
+int score_cmp(const void* a, const void* b) {
+    const IndividualScore* score_a = (const IndividualScore*)a;
+    const IndividualScore* score_b = (const IndividualScore*)b;
+    return (score_a->score > score_b->score) - (score_a->score < score_b->score);
+}
+
+/**
+ * @brief Sorts the indices of an array of integer keys with a LSD radix sort, using caller provided buffers.
+ * @param keys The keys to sort, compared as unsigned integers.
+ * @param size The number of keys.
+ * @param order A buffer of size indices.
+ * @param buffer A second buffer of size indices used between the passes.
+ * @return The buffer (order or buffer) holding the sorted indices.
+*/
+static size_t* radix_sort(const int *keys, size_t size, size_t *order, size_t *buffer) {
+    unsigned int max_key = 0;
+    for (size_t i = 0; i < size; i++) {
+        order[i] = i;
+        if ((unsigned int) keys[i] > max_key)
+            max_key = (unsigned int) keys[i];
+    }
+
+    for (int shift = 0; shift < 32 && (shift == 0 || (max_key >> shift) != 0); shift += RADIX_BITS) {
+        size_t count[RADIX_BUCKETS + 1] = {0};
+        // Histogram of the current digit, shifted by one to get the prefix sums in place
+        for (size_t i = 0; i < size; i++)
+            count[(((unsigned int) keys[order[i]] >> shift) & RADIX_MASK) + 1]++;
+        for (int d = 0; d < RADIX_BUCKETS; d++)
+            count[d + 1] += count[d];
+        for (size_t i = 0; i < size; i++)
+            buffer[count[((unsigned int) keys[order[i]] >> shift) & RADIX_MASK]++] = order[i];
+
+        size_t *temp = order;
+        order = buffer;
+        buffer = temp;
+    }
+    return order;
+}
+
+/**
+ * @brief Sorts the indices of an array of integer keys by increasing key with a LSD radix sort.
+ * The sort is stable and only runs as many RADIX_BITS passes as the largest key needs, so keys bounded
+ * by a few hundred (the raw distances of the find-a-word problem) are sorted with a single counting pass.
+ * Complexity : O(n * passes)
+ * @param keys The keys to sort, compared as unsigned integers.
+ * @param size The number of keys.
+ * @return A newly allocated array of size indices ordered by increasing key, or NULL on failure.
+ * @note The returned pointer must be freed by the caller.
+*/
+size_t* radix_sort_indices(const int *keys, size_t size) {
+    if (size == 0 || keys == NULL)
+        return NULL;
+    size_t *order = malloc(sizeof(size_t) * size);
+    size_t *buffer = malloc(sizeof(size_t) * size);
+    if (order == NULL || buffer == NULL) {
+        free(order);
+        free(buffer);
+        return NULL;
+    }
+
+    size_t *sorted = radix_sort(keys, size, order, buffer);
+    free(sorted == order ? buffer : order);
+    return sorted;
+}
+
+/**
+ * @brief Creates an empty ranking able to hold capacity individuals.
+ * @param capacity The number of individuals the ranking buffers are sized for.
+ * @return The new ranking. Its buffers are NULL if the allocation failed.
+*/
+Ranking create_ranking(size_t capacity){
+    Ranking ranking;
+    memset(&ranking, 0, sizeof(Ranking));
+    reserve_ranking(&ranking, capacity);
+    return ranking;
+}
+
+/**
+ * @brief Makes sure the ranking buffers can hold size individuals.
+ * The buffers only grow, so a ranking reused across generations of the same population never reallocates.
+ * @param ranking The ranking to resize.
+ * @param size The number of individuals to rank.
+ * @return 0 on success, -1 if the allocation failed.
+*/
+int reserve_ranking(Ranking *ranking, size_t size){
+    if (size <= ranking->capacity)
+        return 0;
+    float *scores = realloc(ranking->scores, sizeof(float) * size);
+    if (scores != NULL)
+        ranking->scores = scores;
+    size_t *order = realloc(ranking->order, sizeof(size_t) * size);
+    if (order != NULL)
+        ranking->order = order;
+    size_t *ranks = realloc(ranking->ranks, sizeof(size_t) * size);
+    if (ranks != NULL)
+        ranking->ranks = ranks;
+    IndividualScore *entries = realloc(ranking->entries, sizeof(IndividualScore) * size);
+    if (entries != NULL)
+        ranking->entries = entries;
+    if (scores == NULL || order == NULL || ranks == NULL || entries == NULL)
+        return -1;
+    ranking->capacity = size;
+    return 0;
+}
+
+/**
+ * @brief Computes the ranks, the best individual and the mean score once the order is known.
+ * @param ranking The ranking whose scores and order are filled.
+ * @param size The number of ranked individuals.
+*/
+static void finish_ranking(Ranking *ranking, size_t size){
+    double sum = 0.0;
+    for (size_t i = 0; i < size; i++){
+        ranking->ranks[ranking->order[i]] = i;
+        sum += ranking->scores[i];
+    }
+    ranking->size = size;
+    ranking->best_index = ranking->order[0];
+    ranking->best_score = ranking->scores[ranking->best_index];
+    ranking->mean_score = (float) (sum / size);
+}
+
+/**
+ * @brief Ranks a population from the fitness scores already written in ranking->scores.
+ * Complexity : O(n log(n))
+ * @param ranking The ranking, whose first size scores are filled.
+ * @param size The number of individuals to rank.
+ * @return 0 on success, -1 on failure.
+*/
+int rank_scores(Ranking *ranking, size_t size){
+    if (size == 0 || size > ranking->capacity)
+        return -1;
+    for (size_t i = 0; i < size; i++){
+        ranking->entries[i].idx = i;
+        ranking->entries[i].score = ranking->scores[i];
+    }
+    qsort(ranking->entries, size, sizeof(IndividualScore), score_cmp);
+    for (size_t i = 0; i < size; i++)
+        ranking->order[i] = ranking->entries[i].idx;
+    finish_ranking(ranking, size);
+    return 0;
+}
+
+/**
+ * @brief Ranks a population from its integer distances with a radix sort.
+ * The scores of the ranking are the distances divided by the largest one, in [0, 1] as the scores of the
+ * fitness functions, so the selection functions which weight the individuals by their score, as
+ * roulette_wheel_selection, can be used on them. The order is the one of the distances.
+ * Complexity : O(n)
+ * @param ranking The ranking to fill.
+ * @param distances The non negative distance of each individual.
+ * @param size The number of individuals to rank.
+ * @return 0 on success, -1 on failure.
+*/
+int rank_distances(Ranking *ranking, const int *distances, size_t size){
+    if (size == 0 || size > ranking->capacity || distances == NULL)
+        return -1;
+    int max_distance = 0;
+    for (size_t i = 0; i < size; i++)
+        if (distances[i] > max_distance)
+            max_distance = distances[i];
+    float scale = max_distance > 0 ? 1.0f / max_distance : 0.0f;
+    for (size_t i = 0; i < size; i++)
+        ranking->scores[i] = distances[i] * scale;
+    // The ranks are used as the second radix buffer, they are rebuilt by finish_ranking
+    size_t *sorted = radix_sort(distances, size, ranking->order, ranking->ranks);
+    if (sorted != ranking->order)
+        memcpy(ranking->order, sorted, sizeof(size_t) * size);
+    finish_ranking(ranking, size);
+    return 0;
+}
+
+/**
+ * @brief Frees the buffers of a ranking.
+ * @param ranking The ranking to free.
+*/
+void free_ranking(Ranking ranking){
+    free(ranking.scores);
+    free(ranking.order);
+    free(ranking.ranks);
+    free(ranking.entries);
+}
@@ -0,0 +1,44 @@
+#include <score_cache.h>
+
+/**
+ * @brief Creates an empty score cache, its arrays are allocated by the first generation.
+ * @return The score cache, or NULL if the allocation failed.
+*/
+ScoreCache *create_score_cache(){
+    return calloc(1, sizeof(ScoreCache));
+}
+
+/**
+ * @brief Frees a score cache.
+ * @param cache The score cache, or NULL.
+*/
+void free_score_cache(ScoreCache *cache){
+    if (cache == NULL)
+        return;
+    free(cache->scores);
+    free(cache->next_scores);
+    free(cache);
+}
+
+/**
+ * @brief Makes sure a score cache can hold the scores of size individuals.
+ * Growing the arrays drops the cached scores.
+ * @param cache The score cache.
+ * @param size The number of individuals.
+ * @return 0 on success, -1 if the allocation failed.
+*/
+int reserve_score_cache(ScoreCache *cache, size_t size){
+    if (size <= cache->capacity)
+        return 0;
+    cache->valid = 0;
+    float *scores = realloc(cache->scores, sizeof(float) * size);
+    if (scores == NULL)
+        return -1;
+    cache->scores = scores;
+    float *next_scores = realloc(cache->next_scores, sizeof(float) * size);
+    if (next_scores == NULL)
+        return -1;
+    cache->next_scores = next_scores;
+    cache->capacity = size;
+    return 0;
+}
@@ -0,0 +1,421 @@
+#include <server.h>
+
+// Set by the signal handlers to stop the server
+static volatile sig_atomic_t shutdown_requested = 0;
+
+/**
+ * @brief Signal handler of SIGINT and SIGTERM.
+ * @param signal_number The signal.
+*/
+static void handle_shutdown(int signal_number){
+    (void)signal_number;
+    shutdown_requested = 1;
+}
+
+/**
+ * @brief Writes a whole buffer on a socket. The caller holds the lock of the connection.
+ * A client which is gone is not an error, its answers are dropped.
+ * @param connection The connection.
+ * @param line The bytes to write.
+ * @param size The number of bytes.
+*/
+static void send_line(Connection *connection, const char *line, size_t size){
+    while (size > 0 && !connection->closed){
+        ssize_t written = send(connection->fd, line, size, MSG_NOSIGNAL);
+        if (written < 0){
+            if (errno == EINTR)
+                continue;
+            connection->closed = 1;
+            return;
+        }
+        line += written;
+        size -= written;
+    }
+}
+
+/**
+ * @brief Writes an error answer.
+ * @param connection The connection.
+ * @param id The identifier of the request, or "-" when it is unknown.
+ * @param message The error message.
+*/
+static void send_error(Connection *connection, const char *id, const char *message){
+    char line[SERVER_LINE_MAX];
+    int size = snprintf(line, sizeof(line), "ERROR\t%s\t%s\n", id, message);
+    if (size >= (int)sizeof(line))
+        size = sizeof(line) - 1;
+    pthread_mutex_lock(&connection->lock);
+    send_line(connection, line, size);
+    pthread_mutex_unlock(&connection->lock);
+}
+
+/**
+ * @brief Drops a reference to a connection, and frees it with the last one.
+ * @param connection The connection.
+*/
+static void release_connection(Connection *connection){
+    pthread_mutex_lock(&connection->lock);
+    int references = --connection->references;
+    pthread_mutex_unlock(&connection->lock);
+    if (references > 0)
+        return;
+    close(connection->fd);
+    pthread_mutex_destroy(&connection->lock);
+    free(connection);
+}
+
+/**
+ * @brief Job callback answering a request, called by the worker thread which solved it.
+ * A job which could not run, see JobResult.failed, is answered by an error.
+ * @param job The finished job.
+ * @param result The result of the job.
+ * @param optional_datas The request.
+*/
+static void answer_request(const Job *job, JobResult result, void *optional_datas){
+    Request *request = optional_datas;
+    Connection *connection = request->connection;
+    char line[SERVER_LINE_MAX];
+    int size;
+    if (result.failed)
+        size = snprintf(line, sizeof(line), "ERROR\t%s\tcould not run the search", request->id);
+    else
+        size = snprintf(line, sizeof(line), "RESULT\t%s\t%d\t%d\t%d\t%zu\t%.6f", request->id, result.solved,\
+                        result.cancelled, result.generations, result.evaluations, result.wall_time);
+    // A request with diversity=1 also gets the entropy and the consensus distance of its last population
+    if (size < (int)sizeof(line) && !result.failed && job != NULL && job->config.diversity)
+        size += snprintf(line + size, sizeof(line) - size, "\t%.6f\t%.6f", result.entropy, result.consensus_distance);
+    if (size > (int)sizeof(line) - 2)
+        size = sizeof(line) - 2;
+    line[size++] = '\n';
+
+    pthread_mutex_lock(&connection->lock);
+    Request **link = &connection->requests;
+    while (*link != request)
+        link = &(*link)->next;
+    *link = request->next;
+    send_line(connection, line, size);
+    pthread_mutex_unlock(&connection->lock);
+
+    release_connection(connection);
+    free_stop_signal(request->stop);
+    free(request->id);
+    free(request);
+}
+
+/**
+ * @brief Parses a SOLVE request and submits its job.
+ * The fields are separated by tabulations : SOLVE, the identifier, the word and optional key=value
+ * parameters among population, generations, fixed, random, seed, fitness, selection, pairing, crossover and mutation.
+ * @param runner The job runner.
+ * @param defaults The parameters of the requests which do not override them.
+ * @param connection The connection of the client.
+ * @param fields The fields of the request line.
+ * @param field_count The number of fields.
+*/
+static void solve_request(JobRunner *runner, const JobConfig *defaults, Connection *connection, char **fields, int field_count){
+    if (field_count < 3){
+        send_error(connection, field_count > 1 ? fields[1] : "-", "usage: SOLVE<TAB>id<TAB>word[<TAB>key=value...]");
+        return;
+    }
+    const char *id = fields[1];
+    const char *word = fields[2];
+    if (strlen(word) == 0 || strlen(word) > JOB_MAX_WORD){
+        send_error(connection, id, "invalid word length");
+        return;
+    }
+    JobConfig config = *defaults;
+    for (int i = 3; i < field_count; i++){
+        char *value = strchr(fields[i], '=');
+        if (value == NULL){
+            send_error(connection, id, "parameters are key=value");
+            return;
+        }
+        *value++ = '\0';
+        const char *key = fields[i];
+        int valid = 1;
+        if (strcmp(key, "population") == 0){
+            config.population_size = strtoull(value, NULL, 10);
+            if (config.population_size < SERVER_MIN_POPULATION){
+                send_error(connection, id, "population too small");
+                return;
+            }
+            if (config.population_size > SERVER_MAX_POPULATION){
+                send_error(connection, id, "population too large");
+                return;
+            }
+        }
+        else if (strcmp(key, "generations") == 0)
+            valid = (config.max_generations = atoi(value)) > 0;
+        else if (strcmp(key, "fixed") == 0)
+            config.fixed_length = atoi(value) != 0;
+        else if (strcmp(key, "random") == 0)
+            config.random_operators = atoi(value) != 0;
+        else if (strcmp(key, "seed") == 0)
+            config.seed = strtoull(value, NULL, 10);
+        else if (strcmp(key, "diversity") == 0)
+            config.diversity = atoi(value) != 0;
+        else
+            valid = set_job_operator(&config, key, value) == 0;
+        if (!valid){
+            send_error(connection, id, "invalid parameter");
+            return;
+        }
+    }
+
+    Request *request = calloc(1, sizeof(Request));
+    if (request == NULL || (request->id = strdup(id)) == NULL || (request->stop = create_stop_signal(-1.0f)) == NULL){
+        if (request != NULL){
+            free(request->id);
+            free(request);
+        }
+        send_error(connection, id, "out of memory");
+        return;
+    }
+    request->connection = connection;
+    pthread_mutex_lock(&connection->lock);
+    for (Request *other = connection->requests; other != NULL; other = other->next)
+        if (strcmp(other->id, id) == 0){
+            pthread_mutex_unlock(&connection->lock);
+            free_stop_signal(request->stop);
+            free(request->id);
+            free(request);
+            send_error(connection, id, "request already in flight");
+            return;
+        }
+    request->next = connection->requests;
+    connection->requests = request;
+    connection->references++;
+    pthread_mutex_unlock(&connection->lock);
+
+    // The request is listed before the job is queued, so a CANCEL sent right after the SOLVE finds it
+    if (submit_job(runner, word, &config, request->stop, answer_request, request) != 0){
+        request_stop(request->stop);
+        JobResult result = {0};
+        result.cancelled = 1;
+        answer_request(NULL, result, request);
+    }
+}
+
+/**
+ * @brief Raises the stop signal of a request in flight. Its job answers with cancelled set.
+ * @param connection The connection of the client.
+ * @param id The identifier of the request.
+*/
+static void cancel_request(Connection *connection, const char *id){
+    int found = 0;
+    pthread_mutex_lock(&connection->lock);
+    for (Request *request = connection->requests; request != NULL; request = request->next)
+        if (strcmp(request->id, id) == 0){
+            request_stop(request->stop);
+            found = 1;
+        }
+    pthread_mutex_unlock(&connection->lock);
+    if (!found)
+        send_error(connection, id, "no such request");
+}
+
+/**
+ * @brief Parses and runs a request line.
+ * @param runner The job runner.
+ * @param defaults The default parameters of the jobs.
+ * @param connection The connection of the client.
+ * @param line The request line, without its end of line.
+*/
+static void handle_line(JobRunner *runner, const JobConfig *defaults, Connection *connection, char *line){
+    char *fields[16];
+    int field_count = 0;
+    char *save = NULL;
+    for (char *field = strtok_r(line, "\t", &save); field != NULL && field_count < 16; field = strtok_r(NULL, "\t", &save))
+        fields[field_count++] = field;
+    if (field_count == 0)
+        return;
+    if (strcmp(fields[0], "SOLVE") == 0)
+        solve_request(runner, defaults, connection, fields, field_count);
+    else if (strcmp(fields[0], "CANCEL") == 0 && field_count == 2)
+        cancel_request(connection, fields[1]);
+    else
+        send_error(connection, field_count > 1 ? fields[1] : "-", "unknown request");
+}
+
+/**
+ * @brief Reads the available bytes of a connection and runs its complete request lines.
+ * @param runner The job runner.
+ * @param defaults The default parameters of the jobs.
+ * @param connection The connection of the client.
+ * @return 0 while the client is connected, -1 once it is gone.
+*/
+static int read_connection(JobRunner *runner, const JobConfig *defaults, Connection *connection){
+    ssize_t received = recv(connection->fd, connection->buffer + connection->used, SERVER_LINE_MAX - connection->used, 0);
+    if (received < 0 && (errno == EINTR || errno == EAGAIN))
+        return 0;
+    if (received <= 0)
+        return -1;
+    connection->used += received;
+    size_t start = 0;
+    for (size_t i = connection->used - received; i < connection->used; i++){
+        if (connection->buffer[i] != '\n')
+            continue;
+        connection->buffer[i] = '\0';
+        if (i > start && connection->buffer[i - 1] == '\r')
+            connection->buffer[i - 1] = '\0';
+        if (!connection->skipping)
+            handle_line(runner, defaults, connection, connection->buffer + start);
+        connection->skipping = 0;
+        start = i + 1;
+    }
+    connection->used -= start;
+    memmove(connection->buffer, connection->buffer + start, connection->used);
+    if (connection->used == SERVER_LINE_MAX){
+        if (!connection->skipping)
+            send_error(connection, "-", "line too long");
+        connection->skipping = 1;
+        connection->used = 0;
+    }
+    return 0;
+}
+
+/**
+ * @brief Marks a connection as gone, cancels its requests and drops the reference of the server thread.
+ * @param connection The connection.
+*/
+static void close_connection(Connection *connection){
+    pthread_mutex_lock(&connection->lock);
+    connection->closed = 1;
+    for (Request *request = connection->requests; request != NULL; request = request->next)
+        request_stop(request->stop);
+    pthread_mutex_unlock(&connection->lock);
+    release_connection(connection);
+}
+
+/**
+ * @brief Creates the listening socket, replacing a stale socket file left at the same path.
+ * @param socket_path The path of the socket.
+ * @return The socket, or -1 on failure.
+*/
+static int listen_socket(const char *socket_path){
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(socket_path) >= sizeof(address.sun_path)){
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    strcpy(address.sun_path, socket_path);
+    struct stat status;
+    if (stat(socket_path, &status) == 0 && S_ISSOCK(status.st_mode))
+        unlink(socket_path);
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        return -1;
+    if (bind(fd, (struct sockaddr *)&address, sizeof(address)) != 0 || listen(fd, SOMAXCONN) != 0){
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * @brief Serves solve requests on a Unix domain socket until SIGINT or SIGTERM.
+ * The worker threads and their resources are created once and shared by all the clients. Each line of a client
+ * is a request, each answer a line, and a client can have several requests in flight, answered as they finish :
+ *  - "SOLVE<TAB>id<TAB>word[<TAB>key=value...]" answered by "RESULT<TAB>id<TAB>solved<TAB>cancelled<TAB>generations<TAB>evaluations<TAB>wall time"
+ *  - "CANCEL<TAB>id" stops the request, which answers with cancelled set
+ *  - errors, invalid requests or searches which could not be allocated, are answered by "ERROR<TAB>id<TAB>message"
+ * The requests of a client which disconnects are cancelled.
+ * @param socket_path The path of the socket.
+ * @param worker_count The number of worker threads.
+ * @param defaults The parameters of the requests which do not override them.
+ * @return 0 after a shutdown, -1 if the server could not start.
+*/
+int run_server(const char *socket_path, int worker_count, const JobConfig *defaults){
+    int listen_fd = listen_socket(socket_path);
+    if (listen_fd < 0)
+        return -1;
+    JobRunner *runner = create_job_runner(worker_count);
+    if (runner == NULL){
+        close(listen_fd);
+        unlink(socket_path);
+        return -1;
+    }
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = handle_shutdown;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    shutdown_requested = 0;
+
+    // The first entry of the poll set is the listening socket, the others the connections
+    size_t capacity = 16, count = 1;
+    struct pollfd *fds = malloc(capacity * sizeof(struct pollfd));
+    Connection **connections = malloc(capacity * sizeof(Connection *));
+    if (fds == NULL || connections == NULL){
+        free(fds);
+        free(connections);
+        free_job_runner(runner);
+        close(listen_fd);
+        unlink(socket_path);
+        return -1;
+    }
+    fds[0].fd = listen_fd;
+    fds[0].events = POLLIN;
+    while (!shutdown_requested){
+        if (poll(fds, count, SERVER_POLL_TIMEOUT) <= 0)
+            continue;
+        for (size_t i = count - 1; i > 0; i--){
+            if (fds[i].revents == 0)
+                continue;
+            if (read_connection(runner, defaults, connections[i]) != 0){
+                close_connection(connections[i]);
+                count--;
+                fds[i] = fds[count];
+                connections[i] = connections[count];
+            }
+        }
+        if (!(fds[0].revents & POLLIN))
+            continue;
+        int fd = accept4(listen_fd, NULL, NULL, SOCK_CLOEXEC);
+        if (fd < 0)
+            continue;
+        if (count == capacity){
+            struct pollfd *new_fds = realloc(fds, 2 * capacity * sizeof(struct pollfd));
+            if (new_fds != NULL)
+                fds = new_fds;
+            Connection **new_connections = realloc(connections, 2 * capacity * sizeof(Connection *));
+            if (new_connections != NULL)
+                connections = new_connections;
+            if (new_fds == NULL || new_connections == NULL){
+                close(fd);
+                continue;
+            }
+            capacity *= 2;
+        }
+        Connection *connection = calloc(1, sizeof(Connection));
+        if (connection == NULL){
+            close(fd);
+            continue;
+        }
+        connection->fd = fd;
+        connection->references = 1;
+        pthread_mutex_init(&connection->lock, NULL);
+        fds[count].fd = fd;
+        fds[count].events = POLLIN;
+        fds[count].revents = 0;
+        connections[count++] = connection;
+    }
+
+    // The requests in flight are cancelled and answered before the workers exit
+    for (size_t i = 1; i < count; i++){
+        pthread_mutex_lock(&connections[i]->lock);
+        for (Request *request = connections[i]->requests; request != NULL; request = request->next)
+            request_stop(request->stop);
+        pthread_mutex_unlock(&connections[i]->lock);
+    }
+    free_job_runner(runner);
+    for (size_t i = 1; i < count; i++)
+        close_connection(connections[i]);
+    free(fds);
+    free(connections);
+    close(listen_fd);
+    unlink(socket_path);
+    return 0;
+}
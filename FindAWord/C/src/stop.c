@@ -0,0 +1,68 @@
+#include <stop.h>
+
+/**
+ * @brief Creates a stop signal.
+ * @param threshold Score at or below which an individual wins, negative to stop on the word only.
+ * @return The stop signal, or NULL if the allocation failed.
+*/
+StopSignal *create_stop_signal(float threshold){
+    StopSignal *stop = malloc(sizeof(StopSignal));
+    if (stop == NULL)
+        return NULL;
+    atomic_init(&stop->stopped, 0);
+    atomic_init(&stop->claimed, 0);
+    stop->threshold = threshold;
+    stop->winner = NULL;
+    stop->winner_score = 0.0f;
+    return stop;
+}
+
+/**
+ * @brief Frees a stop signal and its winner.
+ * @param stop The stop signal, or NULL.
+*/
+void free_stop_signal(StopSignal *stop){
+    if (stop == NULL)
+        return;
+    free(stop->winner);
+    free(stop);
+}
+
+/**
+ * @brief Clears a stop signal to reuse it for another run. No population may be using it.
+ * @param stop The stop signal.
+*/
+void reset_stop_signal(StopSignal *stop){
+    free(stop->winner);
+    stop->winner = NULL;
+    stop->winner_score = 0.0f;
+    atomic_store(&stop->claimed, 0);
+    atomic_store(&stop->stopped, 0);
+}
+
+/**
+ * @brief Requests a stop without winner, for example to cancel a run from another thread.
+ * @param stop The stop signal.
+*/
+void request_stop(StopSignal *stop){
+    atomic_store_explicit(&stop->stopped, 1, memory_order_release);
+}
+
+/**
+ * @brief Claims the victory for a winning individual and requests the stop.
+ * Only the first claim succeeds. Its genome is copied before the stop is published, so a thread which
+ * sees the stop also sees the winner.
+ * @param stop The stop signal.
+ * @param genome The genome of the winner.
+ * @param score The score of the winner.
+ * @return 1 if the claim succeeded, 0 if another winner was claimed first.
+*/
+int claim_stop(StopSignal *stop, const char *genome, float score){
+    int expected = 0;
+    if (!atomic_compare_exchange_strong(&stop->claimed, &expected, 1))
+        return 0;
+    stop->winner = strdup(genome);
+    stop->winner_score = score;
+    request_stop(stop);
+    return 1;
+}
@@ -0,0 +1,193 @@
+#include <workspace.h>
+#include <columnar.h>
+
+// Workspace used by scratch_alloc and scratch_free on the current thread
+static __thread Workspace *current = NULL;
+
+// Number of allocations of the current thread which grew a workspace or went to malloc
+static __thread size_t allocation_count = 0;
+
+/**
+ * @brief Creates a workspace sized for the generations of a population.
+ * The region is reserved, not committed: pages are only used when blocks are written in them. It holds
+ * the buffers of two generations, the one being read and the one being built, rounded up to their size classes.
+ * With the environment variable GA_WORKSPACE_STRICT set to n, a generation which allocates once n
+ * generations have run aborts the program, see end_workspace_generation.
+ * @param population_size The number of individuals of the population.
+ * @param max_individual_size The maximum size of an individual.
+ * @return The workspace, or NULL on failure.
+*/
+Workspace *create_workspace(size_t population_size, int max_individual_size){
+    Workspace *workspace = calloc(1, sizeof(Workspace));
+    if (workspace == NULL)
+        return NULL;
+    size_t genome_bytes = (size_t) max_individual_size + 1 + WORKSPACE_HEADER;
+    size_t size = (WORKSPACE_INDIVIDUAL_BYTES + 8 * genome_bytes) * population_size + WORKSPACE_MIN_RESERVE;
+    size_t page = (size_t) sysconf(_SC_PAGESIZE);
+    size = (size + page - 1) & ~(page - 1);
+    void *base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (base == MAP_FAILED){
+        free(workspace);
+        return NULL;
+    }
+    workspace->base = base;
+    workspace->size = size;
+    // A mutation can lengthen a genome by one gene before it is checked
+    while (((size_t) WORKSPACE_MIN_BLOCK << workspace->min_class) - WORKSPACE_HEADER < (size_t) max_individual_size + 2)
+        workspace->min_class++;
+    const char *strict = getenv("GA_WORKSPACE_STRICT");
+    if (strict != NULL)
+        workspace->strict_after = strtoul(strict, NULL, 10);
+    return workspace;
+}
+
+/**
+ * @brief Frees a workspace. The blocks allocated in it must no longer be used.
+ * @param workspace The workspace, or NULL.
+*/
+void free_workspace(Workspace *workspace){
+    if (workspace == NULL)
+        return;
+    if (current == workspace)
+        current = NULL;
+    if (workspace->columns != NULL){
+        free_column_population(*workspace->columns);
+        free(workspace->columns);
+    }
+    munmap(workspace->base, workspace->size);
+    free(workspace);
+}
+
+/**
+ * @brief Sets the workspace used by scratch_alloc and scratch_free on the current thread.
+ * @param workspace The workspace, or NULL to allocate with malloc.
+ * @return The previous workspace of the thread.
+*/
+Workspace *set_workspace(Workspace *workspace){
+    Workspace *previous = current;
+    current = workspace;
+    return previous;
+}
+
+/**
+ * @brief Returns the workspace used by scratch_alloc and scratch_free on the current thread.
+ * @return The workspace, or NULL.
+*/
+Workspace *current_workspace(){
+    return current;
+}
+
+/**
+ * @brief Checks whether a pointer was allocated in a workspace.
+ * @param workspace The workspace.
+ * @param pointer The pointer.
+ * @return 1 if the pointer is in the region of the workspace, 0 otherwise.
+*/
+int in_workspace(const Workspace *workspace, const void *pointer){
+    const char *p = pointer;
+    return p >= workspace->base && p < workspace->base + workspace->size;
+}
+
+/**
+ * @brief Allocates size bytes in the workspace of the thread, or with malloc without workspace or when it is full.
+ * The block is taken from the free list of its size class, and carved from the region when the list is empty.
+ * A block of malloc has a header without workspace before the memory returned, as a block of a workspace.
+ * @param size The number of bytes.
+ * @return The allocated memory, aligned as malloc, or NULL if the allocation failed.
+*/
+void *scratch_alloc(size_t size){
+    Workspace *workspace = current;
+    if (workspace != NULL){
+        size_t size_class = workspace->min_class;
+        while (size_class < WORKSPACE_CLASSES && ((size_t) WORKSPACE_MIN_BLOCK << size_class) - WORKSPACE_HEADER < size)
+            size_class++;
+        if (size_class < WORKSPACE_CLASSES){
+            ScratchBlock *block = workspace->free_blocks[size_class];
+            if (block != NULL){
+                workspace->free_blocks[size_class] = block->next;
+                block->owner = workspace;
+                return (char *) block + WORKSPACE_HEADER;
+            }
+            size_t block_size = (size_t) WORKSPACE_MIN_BLOCK << size_class;
+            if (workspace->used + block_size <= workspace->size){
+                block = (ScratchBlock *) (workspace->base + workspace->used);
+                workspace->used += block_size;
+                block->size_class = size_class;
+                block->owner = workspace;
+                allocation_count++;
+                return (char *) block + WORKSPACE_HEADER;
+            }
+        }
+    }
+    allocation_count++;
+    if (size > SIZE_MAX - WORKSPACE_HEADER)
+        return NULL;
+    ScratchBlock *block = malloc(WORKSPACE_HEADER + size);
+    if (block == NULL)
+        return NULL;
+    block->size_class = WORKSPACE_CLASSES;
+    block->owner = NULL;
+    return (char *) block + WORKSPACE_HEADER;
+}
+
+/**
+ * @brief Allocates an array of count elements of size bytes set to zero, see scratch_alloc.
+ * @param count The number of elements.
+ * @param size The size of an element in bytes.
+ * @return The allocated memory, or NULL if the allocation failed.
+*/
+void *scratch_calloc(size_t count, size_t size){
+    if (size != 0 && count > SIZE_MAX / size)
+        return NULL;
+    void *pointer = scratch_alloc(count * size);
+    if (pointer != NULL)
+        memset(pointer, 0, count * size);
+    return pointer;
+}
+
+/**
+ * @brief Frees memory allocated by scratch_alloc, and only by it.
+ * A block of a workspace goes back to the free list of its class in the workspace named by its header,
+ * which must not be in use by another thread when it is not the workspace of the thread. A block of malloc
+ * is freed.
+ * @param pointer The memory, or NULL.
+*/
+void scratch_free(void *pointer){
+    if (pointer == NULL)
+        return;
+    ScratchBlock *block = (ScratchBlock *) ((char *) pointer - WORKSPACE_HEADER);
+    Workspace *workspace = block->owner;
+    if (workspace == NULL){
+        free(block);
+        return;
+    }
+    block->next = workspace->free_blocks[block->size_class];
+    workspace->free_blocks[block->size_class] = block;
+}
+
+/**
+ * @brief Returns the number of allocations of the current thread which grew a workspace or called malloc.
+ * The difference between two calls is the number of allocations made in between.
+ * @return The number of allocations since the start of the thread.
+*/
+size_t scratch_allocations(){
+    return allocation_count;
+}
+
+/**
+ * @brief Counts a generation run with a workspace, and checks that a steady-state generation did not allocate.
+ * In strict mode, once strict_after generations have run, the buffers of a generation are expected to be
+ * reused from the previous ones: an allocation is reported on the standard error and aborts the program.
+ * @param workspace The workspace of the population, or NULL.
+ * @param allocations The number of allocations of the generation.
+*/
+void end_workspace_generation(Workspace *workspace, size_t allocations){
+    if (workspace == NULL)
+        return;
+    workspace->generations++;
+    if (workspace->strict_after != 0 && workspace->generations > workspace->strict_after && allocations != 0){
+        fprintf(stderr, "workspace: generation %zu made %zu allocations after %zu steady-state generations\n",\
+                workspace->generations, allocations, workspace->strict_after);
+        abort();
+    }
+}
@@ -0,0 +1,72 @@
+#include <check.h>
+#include <sys/stat.h>
+#include <population.h>
+
+/**
+ * @brief Evolves a population whose genomes are in a genome arena and whose duplicates are dropped: the
+ * genomes of the duplicates are released in the arena, and their replacements allocated in it.
+*/
+static void check_dedup_drop(){
+    GenomeArena *arena = create_genome_arena(256 * 2, NULL);
+    CHECK(arena != NULL);
+    GenomeArena *previous_arena = set_genome_arena(arena);
+    Population p = create_population(256, 1, 1);
+    set_genome_arena(previous_arena);
+    p.arena = arena;
+    p.dedup = create_dedup_table(DEDUP_DROP);
+    Ranking ranking = create_ranking(p.size);
+    GenerationStats stats = {0};
+    for (int generation = 0; generation < 5; generation++){
+        p = make_generation(p, "a", modified_hamming_distance_fitness, NULL, tournament_selection, NULL,\
+                            random_pairing_parents, &ranking, uniform_crossover, NULL, random_mutate, NULL,\
+                            &ranking, &stats);
+        // 256 genomes of one gene among GENE_SYMBOLS have duplicates
+        CHECK(stats.duplicate_ratio > 0.0f);
+    }
+    free_ranking(ranking);
+    free_dedup_table(p.dedup);
+    free_population(p);
+    free_genome_arena(arena);
+}
+
+/**
+ * @brief Evolves a population whose genomes are in an arena mapped on a file until it finds its word.
+*/
+static void check_file(){
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/test_arena_%d.bin", (int) getpid());
+    const char *word = "Arena";
+    int length = strlen(word);
+    size_t space_size = 512 * (length + 1);
+    GenomeArena *arena = create_genome_arena(space_size, path);
+    CHECK(arena != NULL && arena->fd != -1);
+    if (arena == NULL)
+        return;
+    struct stat status;
+    CHECK(stat(path, &status) == 0 && (size_t) status.st_size == 2 * arena->space_size);
+    GenomeArena *previous_arena = set_genome_arena(arena);
+    Population p = create_population(512, length, length);
+    set_genome_arena(previous_arena);
+    p.arena = arena;
+    Ranking ranking = create_ranking(p.size);
+    GenerationStats stats = {0};
+    for (int generation = 0; generation < 2000 && !stats.exact_match; generation++){
+        p = make_generation(p, word, modified_hamming_distance_fitness, NULL, tournament_selection, NULL,\
+                            random_pairing_parents, &ranking, uniform_crossover, NULL, random_mutate, NULL,\
+                            &ranking, &stats);
+        for (size_t i = 0; i < p.size; i++)
+            CHECK(in_genome_arena(arena, p.individuals[i].genome));
+    }
+    CHECK(stats.exact_match && strcmp(p.individuals[stats.best_index].genome, word) == 0);
+    free_ranking(ranking);
+    free_population(p);
+    free_genome_arena(arena);
+    unlink(path);
+}
+
+int main(){
+    seed_random(42);
+    check_dedup_drop();
+    check_file();
+    CHECK_DONE("arena");
+}
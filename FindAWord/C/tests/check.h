@@ -0,0 +1,24 @@
+#ifndef CHECK_H
+#define CHECK_H
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Number of failed checks of the test program
+static int check_failures = 0;
+
+// Reports a failed condition with its location, and goes on with the next checks
+#define CHECK(condition) do {\
+    if (!(condition)){\
+        fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition);\
+        check_failures++;\
+    }\
+} while (0)
+
+// Ends a test program: its exit status is 1 when a check failed
+#define CHECK_DONE(name) do {\
+    fprintf(stderr, "%s: %s\n", name, check_failures == 0 ? "ok" : "FAILED");\
+    return check_failures == 0 ? 0 : 1;\
+} while (0)
+
+#endif
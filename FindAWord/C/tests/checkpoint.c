@@ -0,0 +1,158 @@
+#include <check.h>
+#include <checkpoint.h>
+
+// The resumed search starts from the checkpoint of generation CHECKPOINT_TEST_AT and runs to CHECKPOINT_TEST_END
+#define CHECKPOINT_TEST_AT 30
+#define CHECKPOINT_TEST_END 60
+#define CHECKPOINT_TEST_SIZE 256
+#define CHECKPOINT_TEST_MAX 20
+
+/**
+ * @brief Writes the path of a checkpoint of the test in /tmp.
+*/
+static void checkpoint_path(char *path, size_t size, const char *name){
+    snprintf(path, size, "/tmp/test_checkpoint_%s_%d.ckpt", name, (int) getpid());
+}
+
+/**
+ * @brief Checks that a restored population has the genomes, the sizes and the generation of the checkpointed
+ * one, and that the header gives back the random state, the word and the configuration.
+*/
+static void check_round_trip(){
+    char path[64];
+    checkpoint_path(path, sizeof(path), "round_trip");
+    Population p = create_population(100, 3, 12);
+    p.generation = 17;
+    JobConfig config = default_job_config();
+    config.seed = 1234;
+    config.max_generations = 500;
+    config.selection_function = tournament_selection;
+    config.mutation_function = swap_mutate;
+    uint64_t state = random_state;
+    CHECK(write_checkpoint(path, p, "Round trip", &config) == 0);
+
+    CheckpointHeader header;
+    Population restored = restore_checkpoint(path, 100 * 13, &header);
+    CHECK(restored.size == p.size && restored.generation == 17);
+    CHECK(restored.min_individual_size == 3 && restored.max_individual_size == 12);
+    CHECK(header.random_state == state && strcmp(header.word, "Round trip") == 0);
+    for (size_t i = 0; i < restored.size; i++){
+        CHECK(restored.individuals[i].size == p.individuals[i].size);
+        CHECK(strcmp(restored.individuals[i].genome, p.individuals[i].genome) == 0);
+        CHECK(in_genome_arena(restored.arena, restored.individuals[i].genome));
+    }
+    JobConfig resumed = default_job_config();
+    CHECK(checkpoint_job_config(&header, &resumed) == 0);
+    CHECK(resumed.seed == 1234 && resumed.max_generations == 500 && resumed.population_size == 100);
+    CHECK(resumed.selection_function == tournament_selection && resumed.mutation_function == swap_mutate);
+    free_population(restored);
+    free_genome_arena(restored.arena);
+    free_population(p);
+    unlink(path);
+}
+
+/**
+ * @brief Checks that a checkpoint whose lengths or terminators do not match its header is not restored.
+*/
+static void check_corrupted(){
+    char path[64];
+    checkpoint_path(path, sizeof(path), "corrupted");
+    Population p = create_population(10, 8, 8);
+    CheckpointHeader header;
+    CHECK(write_checkpoint(path, p, "Corrupted", NULL) == 0);
+    int fd = open(path, O_RDWR);
+    CHECK(fd != -1 && pread(fd, &header, sizeof(CheckpointHeader), 0) == sizeof(CheckpointHeader));
+
+    // A length above the maximum size, with the sum of the lengths kept
+    uint32_t lengths[2] = {9, 7};
+    CHECK(pwrite(fd, lengths, sizeof(lengths), header.lengths_offset) == sizeof(lengths));
+    CHECK(restore_checkpoint(path, 0, &header).size == 0);
+    lengths[0] = lengths[1] = 8;
+    CHECK(pwrite(fd, lengths, sizeof(lengths), header.lengths_offset) == sizeof(lengths));
+    Population restored = restore_checkpoint(path, 0, &header);
+    CHECK(restored.size == p.size);
+    free_population(restored);
+    free_genome_arena(restored.arena);
+
+    // A genome without its terminator
+    CHECK(pwrite(fd, "x", 1, header.genomes_offset + 8) == 1);
+    CHECK(restore_checkpoint(path, 0, &header).size == 0);
+    CHECK(pwrite(fd, "", 1, header.genomes_offset + 8) == 1);
+
+    // A minimum size above the maximum size
+    header.min_individual_size = 9;
+    CHECK(pwrite(fd, &header, sizeof(CheckpointHeader), 0) == sizeof(CheckpointHeader));
+    CHECK(restore_checkpoint(path, 0, &header).size == 0);
+    close(fd);
+    free_population(p);
+    unlink(path);
+}
+
+/**
+ * @brief Runs the generations of a search as the single word mode of main.c: the fitness function of each
+ * generation is drawn one generation ahead so the score cache scores the children with it, and a checkpoint
+ * records the one drawn for the next generation.
+ * @param p The population, with a score cache.
+ * @param word The target word.
+ * @param config The parameters of the search, whose fitness function is the one of the next generation.
+ * @param path The checkpoint written at generation CHECKPOINT_TEST_AT, or NULL.
+ * @return The population of generation CHECKPOINT_TEST_END.
+*/
+static Population evolve(Population p, const char *word, JobConfig *config, const char *path){
+    Ranking ranking = create_ranking(p.size);
+    GenerationStats stats = {0};
+    while (p.generation < CHECKPOINT_TEST_END){
+        FitnessFunction fitness = config->fitness_function;
+        config->fitness_function = fitness_functions[random_int() % FITNESS_FUNCTION_COUNT].function;
+        p.score_cache->next_fitness_function = config->fitness_function;
+        p = make_generation(p, word, fitness, NULL, tournament_selection, NULL, random_pairing_parents, &ranking,\
+                            uniform_crossover, NULL, random_mutate, NULL, &ranking, &stats);
+        if (path != NULL && p.generation == CHECKPOINT_TEST_AT)
+            CHECK(write_checkpoint(path, p, word, config) == 0);
+    }
+    free_ranking(ranking);
+    return p;
+}
+
+/**
+ * @brief Checks that a search resumed from a checkpoint ends with the population of the search which wrote it.
+*/
+static void check_resume(){
+    char path[64];
+    checkpoint_path(path, sizeof(path), "resume");
+    const char *word = "Resumed search";
+    JobConfig config = default_job_config();
+    config.random_operators = 1;
+    config.fitness_function = fitness_functions[random_int() % FITNESS_FUNCTION_COUNT].function;
+    Population p = create_population(CHECKPOINT_TEST_SIZE, 2, CHECKPOINT_TEST_MAX);
+    p.score_cache = create_score_cache();
+    p = evolve(p, word, &config, path);
+
+    CheckpointHeader header;
+    Population restored = restore_checkpoint(path, CHECKPOINT_TEST_SIZE * (CHECKPOINT_TEST_MAX + 1), &header);
+    CHECK(restored.size == CHECKPOINT_TEST_SIZE && restored.generation == CHECKPOINT_TEST_AT);
+    JobConfig resumed = default_job_config();
+    CHECK(checkpoint_job_config(&header, &resumed) == 0);
+    random_state = header.random_state;
+    restored.score_cache = create_score_cache();
+    restored = evolve(restored, word, &resumed, NULL);
+    CHECK(restored.generation == p.generation && resumed.fitness_function == config.fitness_function);
+    for (size_t i = 0; i < p.size; i++){
+        CHECK(restored.individuals[i].size == p.individuals[i].size);
+        CHECK(strcmp(restored.individuals[i].genome, p.individuals[i].genome) == 0);
+    }
+    free_population(restored);
+    free_score_cache(restored.score_cache);
+    free_genome_arena(restored.arena);
+    free_population(p);
+    free_score_cache(p.score_cache);
+    unlink(path);
+}
+
+int main(){
+    seed_random(42);
+    check_round_trip();
+    check_corrupted();
+    check_resume();
+    CHECK_DONE("checkpoint");
+}
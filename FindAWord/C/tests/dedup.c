@@ -0,0 +1,96 @@
+#include <check.h>
+#include <population.h>
+
+// Number of distinct genomes of the test populations, the other individuals are copies of them
+#define DEDUP_TEST_DISTINCT 100
+#define DEDUP_TEST_SIZE 300
+#define DEDUP_TEST_LENGTH 8
+
+/**
+ * @brief Modified Hamming distance which counts its calls.
+ * @param optional_datas The size_t counter of the calls.
+*/
+static float counting_fitness(const char *individual, const char *word, void *optional_datas){
+    (*(size_t *) optional_datas)++;
+    return modified_hamming_distance(individual, word, NULL);
+}
+
+/**
+ * @brief Creates a population whose individual i is a copy of the individual i % DEDUP_TEST_DISTINCT.
+ * @return The population.
+*/
+static Population duplicated_population(){
+    Population p = create_population(DEDUP_TEST_SIZE, DEDUP_TEST_LENGTH, DEDUP_TEST_LENGTH);
+    for (size_t i = DEDUP_TEST_DISTINCT; i < p.size; i++)
+        memcpy(p.individuals[i].genome, p.individuals[i % DEDUP_TEST_DISTINCT].genome, DEDUP_TEST_LENGTH + 1);
+    return p;
+}
+
+/**
+ * @brief Checks that in DEDUP_SHARE mode the duplicates point to their first copy and take its score
+ * without being evaluated.
+*/
+static void check_share(){
+    Population p = duplicated_population();
+    p.dedup = create_dedup_table(DEDUP_SHARE);
+    CHECK(dedup_individuals(p.dedup, p.individuals, p.size) == 0);
+    CHECK(p.dedup->duplicates == DEDUP_TEST_SIZE - DEDUP_TEST_DISTINCT);
+    for (size_t i = 0; i < p.size; i++)
+        CHECK(p.dedup->first[i] == (i < DEDUP_TEST_DISTINCT ? -1 : (int64_t) (i % DEDUP_TEST_DISTINCT)));
+
+    size_t calls = 0;
+    Ranking ranking = create_ranking(p.size);
+    GenerationStats stats = {0};
+    p = make_generation(p, "Duplicate", counting_fitness, &calls, tournament_selection, NULL, random_pairing_parents,\
+                        &ranking, uniform_crossover, NULL, random_mutate, NULL, &ranking, &stats);
+    CHECK(calls == DEDUP_TEST_DISTINCT && stats.evaluations == DEDUP_TEST_DISTINCT);
+    CHECK(stats.duplicate_ratio == (float) (DEDUP_TEST_SIZE - DEDUP_TEST_DISTINCT) / DEDUP_TEST_SIZE);
+    for (size_t i = DEDUP_TEST_DISTINCT; i < DEDUP_TEST_SIZE; i++)
+        CHECK(ranking.scores[i] == ranking.scores[i % DEDUP_TEST_DISTINCT]);
+    free_ranking(ranking);
+    free_dedup_table(p.dedup);
+    free_population(p);
+}
+
+/**
+ * @brief Checks that in DEDUP_DROP mode the duplicates are replaced by new individuals within the size
+ * bounds, the first copies are kept, and every individual is evaluated.
+*/
+static void check_drop(){
+    Population p = duplicated_population();
+    char *firsts[DEDUP_TEST_DISTINCT];
+    for (size_t i = 0; i < DEDUP_TEST_DISTINCT; i++)
+        firsts[i] = p.individuals[i].genome;
+    p.dedup = create_dedup_table(DEDUP_DROP);
+    CHECK(dedup_individuals(p.dedup, p.individuals, p.size) == 0);
+    CHECK(p.dedup->duplicates == DEDUP_TEST_SIZE - DEDUP_TEST_DISTINCT);
+    for (size_t i = 0; i < p.size; i++){
+        CHECK(p.dedup->first[i] == -1);
+        CHECK(p.individuals[i].size == DEDUP_TEST_LENGTH && strlen(p.individuals[i].genome) == DEDUP_TEST_LENGTH);
+    }
+    for (size_t i = 0; i < DEDUP_TEST_DISTINCT; i++)
+        CHECK(p.individuals[i].genome == firsts[i]);
+    // The refilled population has no duplicate left
+    CHECK(dedup_individuals(p.dedup, p.individuals, p.size) == 0 && p.dedup->duplicates == 0);
+
+    Population copies = duplicated_population();
+    copies.dedup = p.dedup;
+    size_t calls = 0;
+    Ranking ranking = create_ranking(copies.size);
+    GenerationStats stats = {0};
+    copies = make_generation(copies, "Duplicate", counting_fitness, &calls, tournament_selection, NULL, random_pairing_parents,\
+                             &ranking, uniform_crossover, NULL, random_mutate, NULL, &ranking, &stats);
+    CHECK(calls == DEDUP_TEST_SIZE && stats.evaluations == DEDUP_TEST_SIZE);
+    CHECK(stats.duplicate_ratio == (float) (DEDUP_TEST_SIZE - DEDUP_TEST_DISTINCT) / DEDUP_TEST_SIZE);
+    free_ranking(ranking);
+    free_dedup_table(p.dedup);
+    free_population(copies);
+    free_population(p);
+}
+
+int main(){
+    seed_random(42);
+    check_share();
+    check_drop();
+    CHECK_DONE("dedup");
+}
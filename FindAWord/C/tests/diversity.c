@@ -0,0 +1,115 @@
+#include <check.h>
+#include <math.h>
+#include <pipeline.h>
+
+/**
+ * @brief Recounts the genes of a population position by position and compares the entropy and the consensus
+ * distance with the ones of its diversity model.
+ * @param p The population, with its diversity model.
+ * @param max_size The maximum size of the individuals.
+*/
+static void check_recount(Population p, int max_size){
+    // The most frequent length, the shortest on a tie as the model
+    size_t lengths[max_size + 1];
+    memset(lengths, 0, sizeof(lengths));
+    for (size_t j = 0; j < p.size; j++)
+        lengths[p.individuals[j].size]++;
+    int length = 0;
+    for (int l = 1; l <= max_size; l++)
+        if (lengths[l] > lengths[length])
+            length = l;
+
+    char consensus[max_size + 1];
+    double entropy_sum = 0.0;
+    int positions = 0;
+    for (int i = 0; i < max_size; i++){
+        size_t counts[GENE_SYMBOLS] = {0};
+        size_t having = 0;
+        for (size_t j = 0; j < p.size; j++)
+            if (p.individuals[j].size > i){
+                counts[(unsigned char) p.individuals[j].genome[i] - MINCHAR]++;
+                having++;
+            }
+        if (having == 0)
+            continue;
+        double entropy = 0.0;
+        int best = 0;
+        for (int g = 0; g < GENE_SYMBOLS; g++){
+            if (counts[g] != 0)
+                entropy -= (double) counts[g] / having * log2((double) counts[g] / having);
+            if (counts[g] > counts[best])
+                best = g;
+        }
+        entropy_sum += entropy;
+        positions++;
+        if (i < length)
+            consensus[i] = (char) (best + MINCHAR);
+    }
+    consensus[length] = '\0';
+    double distance = 0.0;
+    for (size_t j = 0; j < p.size; j++)
+        distance += modified_hamming_distance(p.individuals[j].genome, consensus, NULL);
+
+    CHECK(p.diversity->size == p.size);
+    CHECK(fabs(diversity_entropy(p.diversity, NULL) - entropy_sum / positions) < 1e-4);
+    CHECK(fabs(diversity_consensus_distance(p.diversity) - distance / p.size) < 1e-3);
+    char model_consensus[max_size + 1];
+    CHECK(diversity_consensus(p.diversity, model_consensus) == length && strcmp(model_consensus, consensus) == 0);
+}
+
+/**
+ * @brief Checks the model kept by make_generation, with individuals of several lengths and mutations which
+ * change them.
+*/
+static void check_generation(){
+    const char *word = "Diversity of a population";
+    int max_size = 2 * strlen(word);
+    Population p = create_population(2000, 1, max_size);
+    p.diversity = create_diversity(max_size);
+    count_diversity(p.diversity, p.individuals, p.size);
+    check_recount(p, max_size);
+    Ranking ranking = create_ranking(p.size);
+    GenerationStats stats = {0};
+    MutationFunction mutations[] = {insertion_mutate, deletion_mutate, random_mutate};
+    for (int generation = 0; generation < 12; generation++){
+        p = make_generation(p, word, modified_hamming_distance_fitness, NULL, tournament_selection, NULL,\
+                            random_pairing_parents, &ranking, uniform_crossover, NULL,\
+                            mutations[generation % 3], NULL, &ranking, &stats);
+        check_recount(p, max_size);
+        CHECK(stats.entropy == diversity_entropy(p.diversity, NULL));
+    }
+    free_ranking(ranking);
+    free_diversity(p.diversity);
+    free_population(p);
+}
+
+/**
+ * @brief Checks the model merged from the threads of a pipeline.
+*/
+static void check_pipeline(){
+    const char *word = "Diversity of a pipeline";
+    int length = strlen(word);
+    Population p = create_population(3000, length, length);
+    p.diversity = create_diversity(length);
+    Pipeline *pipeline = create_pipeline(p, word, 3, 7, modified_hamming_distance_fitness, NULL, tournament_selection,\
+                                         random_pairing_parents, NULL, uniform_crossover, NULL, random_mutate, NULL);
+    CHECK(pipeline != NULL);
+    Population generation = pipeline_population(pipeline);
+    check_recount(generation, length);
+    GenerationStats stats = {0};
+    for (int i = 0; i < 8; i++){
+        generation = pipeline_generation(pipeline, &stats);
+        check_recount(generation, length);
+        CHECK(stats.consensus_distance == diversity_consensus_distance(p.diversity));
+    }
+    free_pipeline(pipeline);
+    free_diversity(p.diversity);
+    free_population(p);
+}
+
+int main(){
+    seed_random(42);
+    check_generation();
+    check_pipeline();
+    CHECK_DONE("diversity");
+}
@@ -0,0 +1,78 @@
+#include <check.h>
+#include <eda.h>
+
+/**
+ * @brief Searches a word from the same first population with make_generation or with eda_generation.
+ * @param word The target word.
+ * @param model The model of eda_generation, or NULL for make_generation with the operators of the batch mode.
+ * @param seed The seed of the random generator.
+ * @param evaluations The number of fitness function calls to the exact match.
+ * @return 1 if the word was found within 2000 generations.
+*/
+static int search(const char *word, EdaModel *model, uint64_t seed, size_t *evaluations){
+    int length = strlen(word);
+    seed_random(seed);
+    Population p = create_population(512, length, length);
+    Ranking ranking = create_ranking(p.size);
+    GenerationStats stats = {0};
+    *evaluations = 0;
+    for (int generation = 0; generation < 2000 && !stats.exact_match; generation++){
+        if (model != NULL)
+            p = eda_generation(p, word, model, modified_hamming_distance_fitness, NULL, &ranking, &stats);
+        else
+            p = make_generation(p, word, modified_hamming_distance_fitness, NULL, truncation_selection, NULL,\
+                                random_pairing_parents, &ranking, uniform_crossover, NULL, random_mutate, NULL,\
+                                &ranking, &stats);
+        *evaluations += stats.evaluations;
+    }
+    free_ranking(ranking);
+    free_population(p);
+    return stats.exact_match;
+}
+
+/**
+ * @brief Checks that UMDA and PBIL find a short word, UMDA in fewer evaluations than make_generation from the
+ * same seed.
+*/
+static void check_evaluations(){
+    const char *word = "Hello world";
+    int length = strlen(word);
+    for (uint64_t seed = 1; seed <= 5; seed++){
+        size_t generation_evaluations, umda_evaluations, pbil_evaluations;
+        CHECK(search(word, NULL, seed, &generation_evaluations));
+        EdaModel *umda = create_eda_model(EDA_UMDA, length, length, 0.3f, 0.2f);
+        CHECK(search(word, umda, seed, &umda_evaluations));
+        CHECK(umda_evaluations < generation_evaluations);
+        free_eda_model(umda);
+        EdaModel *pbil = create_eda_model(EDA_PBIL, length, length, 0.3f, 0.2f);
+        CHECK(search(word, pbil, seed, &pbil_evaluations));
+        free_eda_model(pbil);
+    }
+}
+
+/**
+ * @brief Checks that the genes sampled from a new model are uniform, and the lengths within the bounds of the model.
+*/
+static void check_sampling(){
+    EdaModel *model = create_eda_model(EDA_UMDA, 3, 12, 0.3f, 0.2f);
+    size_t counts[GENE_SYMBOLS] = {0};
+    size_t genes = 0;
+    for (int i = 0; i < 20000; i++){
+        Individual c = sample_individual(model);
+        CHECK(c.size >= 3 && c.size <= 12 && c.genome[c.size] == '\0');
+        for (int g = 0; g < c.size; g++)
+            counts[(unsigned char) c.genome[g] - MINCHAR]++;
+        genes += c.size;
+        free_individual(c);
+    }
+    for (int g = 0; g < GENE_SYMBOLS; g++)
+        CHECK(counts[g] > 0.8 * genes / GENE_SYMBOLS && counts[g] < 1.2 * genes / GENE_SYMBOLS);
+    free_eda_model(model);
+}
+
+int main(){
+    check_evaluations();
+    seed_random(42);
+    check_sampling();
+    CHECK_DONE("eda");
+}
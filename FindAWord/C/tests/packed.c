@@ -0,0 +1,89 @@
+#include <check.h>
+#include <packed.h>
+
+/**
+ * @brief Packs and unpacks genomes of every length up to PACKED_MAX_LENGTH, and a population of mixed lengths.
+*/
+static void check_round_trip(){
+    Gene genes[PACKED_MAX_LENGTH + 1];
+    uint64_t words[PACKED_MAX_LENGTH / PACKED_GENES_PER_WORD + 1];
+    for (int length = 0; length <= PACKED_MAX_LENGTH; length++){
+        Individual individual = create_individual(length, length);
+        // The extreme genes use every bit of a lane
+        if (length > 1){
+            individual.genome[0] = MINCHAR;
+            individual.genome[length - 1] = MAXCHAR;
+        }
+        pack_genes(individual.genome, length, words);
+        memset(genes, 0, sizeof(genes));
+        unpack_genes(words, length, genes);
+        CHECK(memcmp(genes, individual.genome, length) == 0);
+        free_individual(individual);
+    }
+
+    Population p = create_population(1000, 1, 60);
+    PackedPopulation packed = pack_population(p);
+    CHECK(packed.words != NULL && packed.size == p.size);
+    for (size_t i = 0; i < packed.size; i++){
+        Individual individual = unpack_individual(&packed, i);
+        CHECK(individual.size == p.individuals[i].size && strcmp(individual.genome, p.individuals[i].genome) == 0);
+        free_individual(individual);
+    }
+    free_packed_population(packed);
+    free_population(p);
+}
+
+/**
+ * @brief Compares packed_hamming_distance with the distance and the fitness of the unpacked genomes,
+ * for pairs of random lengths, then of equal lengths with a few different genes.
+*/
+static void check_distance(){
+    uint64_t a[PACKED_MAX_LENGTH / PACKED_GENES_PER_WORD + 1], b[PACKED_MAX_LENGTH / PACKED_GENES_PER_WORD + 1];
+    for (int i = 0; i < 20000; i++){
+        int length = random_int() % 60 + 1;
+        Individual first = create_individual(1, 60);
+        Individual second = i % 2 ? create_individual(length, length) : create_individual(first.size, first.size);
+        // Equal lengths with a few differences, so the distances are not all close to the length
+        if (i % 2 == 0){
+            memcpy(second.genome, first.genome, first.size);
+            for (int k = random_int() % 4; k > 0; k--)
+                second.genome[random_int() % second.size] = create_gene();
+        }
+        pack_genes(first.genome, first.size, a);
+        pack_genes(second.genome, second.size, b);
+        int distance = packed_hamming_distance(a, first.size, b, second.size);
+        CHECK(distance == modified_hamming_distance(first.genome, second.genome, NULL));
+        int longest = first.size > second.size ? first.size : second.size;
+        CHECK((float) distance / longest == modified_hamming_distance_fitness(first.genome, second.genome, NULL));
+        free_individual(first);
+        free_individual(second);
+    }
+}
+
+/**
+ * @brief Checks that packed_make_generation finds a short word.
+*/
+static void check_generation(){
+    const char *word = "Hello world";
+    int length = strlen(word);
+    PackedPopulation p = create_packed_population(4096, length, length);
+    PackedPopulation next = create_packed_population(4096, length, length);
+    GenerationStats stats = {0};
+    int generation = 0;
+    for (; generation < 1000 && !stats.exact_match; generation++)
+        packed_make_generation(&p, &next, word, 0.0f, &stats);
+    CHECK(stats.exact_match);
+    Individual best = unpack_individual(&p, 0);
+    CHECK(strcmp(best.genome, word) == 0);
+    free_individual(best);
+    free_packed_population(p);
+    free_packed_population(next);
+}
+
+int main(){
+    seed_random(42);
+    check_round_trip();
+    check_distance();
+    check_generation();
+    CHECK_DONE("packed");
+}
@@ -0,0 +1,133 @@
+#include <check.h>
+#include <pipeline.h>
+
+/**
+ * @brief Checks that a pipeline only runs tournament selection.
+*/
+static void check_selection(){
+    Population p = create_population(256, 5, 5);
+    CHECK(create_pipeline(p, "Hello", 2, 7, modified_hamming_distance_fitness, NULL, truncation_selection,\
+                          random_pairing_parents, NULL, uniform_crossover, NULL, random_mutate, NULL) == NULL);
+    Pipeline *pipeline = create_pipeline(p, "Hello", 2, 7, modified_hamming_distance_fitness, NULL, tournament_selection,\
+                                         random_pairing_parents, NULL, uniform_crossover, NULL, random_mutate, NULL);
+    CHECK(pipeline != NULL);
+    free_pipeline(pipeline);
+    free_population(p);
+}
+
+/**
+ * @brief Checks that a stop requested by the caller drops the generation being bred, and that a winner bred
+ * by the pipeline claims the stop signal.
+*/
+static void check_stop(){
+    const char *word = "Stop";
+    int length = strlen(word);
+    Population p = create_population(2000, length, length);
+    p.stop = create_stop_signal(-1.0f);
+    Pipeline *pipeline = create_pipeline(p, word, 3, 11, modified_hamming_distance_fitness, NULL, tournament_selection,\
+                                         random_pairing_parents, NULL, uniform_crossover, NULL, random_mutate, NULL);
+    CHECK(pipeline != NULL);
+    GenerationStats stats = {0};
+    Population generation = pipeline_generation(pipeline, &stats);
+    CHECK(!stats.stopped && generation.generation == 1);
+
+    request_stop(p.stop);
+    generation = pipeline_generation(pipeline, &stats);
+    CHECK(stats.stopped && stats.evaluations == 0 && stats.best_index == -1);
+    CHECK(generation.generation == 1 && pipeline_population(pipeline).individuals == generation.individuals);
+
+    reset_stop_signal(p.stop);
+    for (int i = 0; i < 1000 && (i == 0 || (!stats.stopped && !stats.exact_match)); i++)
+        generation = pipeline_generation(pipeline, &stats);
+    CHECK(stats.stopped && stats.exact_match && stats.best_index == -1);
+    CHECK(p.stop->winner != NULL && strcmp(p.stop->winner, word) == 0);
+    CHECK(stats.evaluations > 0 && stats.evaluations < p.size - pipeline->elite_size);
+    free_pipeline(pipeline);
+    free_stop_signal(p.stop);
+    free_population(p);
+}
+
+/**
+ * @brief Runs 20 generations of a pipeline from a population, with the random generator of the calling
+ * thread, which draws the pairs, seeded the same way for every pipeline.
+ * @param p The first generation.
+ * @param thread_count The number of threads.
+ * @param genomes The genomes of the last generation, written one after the other with their terminators.
+ * @param best_scores The best score of each generation.
+*/
+static void run_threads(Population p, int thread_count, Gene *genomes, float *best_scores){
+    seed_random(9);
+    Pipeline *pipeline = create_pipeline(p, "Threads", thread_count, 5, modified_hamming_distance_fitness, NULL, tournament_selection,\
+                                         random_pairing_parents, NULL, uniform_crossover, NULL, random_mutate, NULL);
+    CHECK(pipeline != NULL);
+    if (pipeline == NULL)
+        return;
+    GenerationStats stats = {0};
+    Population generation = pipeline_population(pipeline);
+    for (int i = 0; i < 20; i++){
+        generation = pipeline_generation(pipeline, &stats);
+        best_scores[i] = stats.best_score;
+    }
+    for (size_t i = 0; i < generation.size; i++){
+        memcpy(genomes, generation.individuals[i].genome, generation.individuals[i].size + 1);
+        genomes += generation.individuals[i].size + 1;
+    }
+    free_pipeline(pipeline);
+}
+
+/**
+ * @brief Checks that a search gives the same generations on one thread and on three threads.
+*/
+static void check_threads(){
+    Population p = create_population(1000, 2, 12);
+    Gene *genomes[2];
+    float best_scores[2][20];
+    for (int k = 0; k < 2; k++){
+        genomes[k] = calloc(p.size * 13, sizeof(Gene));
+        run_threads(p, k == 0 ? 1 : 3, genomes[k], best_scores[k]);
+    }
+    CHECK(memcmp(genomes[0], genomes[1], p.size * 13) == 0);
+    CHECK(memcmp(best_scores[0], best_scores[1], sizeof(best_scores[0])) == 0);
+    free(genomes[0]);
+    free(genomes[1]);
+    free_population(p);
+}
+
+/**
+ * @brief Mutation which makes the child two genes longer than its maximum size.
+*/
+static Individual growing_mutate(Individual c, void *optional_datas){
+    (void) optional_datas;
+    Gene *genome = allocate_genome(c.max_size + 3);
+    memset(genome, 'x', c.max_size + 2);
+    genome[c.max_size + 2] = '\0';
+    free_individual(c);
+    c.genome = genome;
+    c.size = c.max_size + 2;
+    return c;
+}
+
+/**
+ * @brief Checks that a child longer than the maximum size is truncated to it.
+*/
+static void check_truncated(){
+    Population p = create_population(256, 4, 6);
+    Pipeline *pipeline = create_pipeline(p, "Grow", 2, 3, modified_hamming_distance_fitness, NULL, tournament_selection,\
+                                         random_pairing_parents, NULL, uniform_crossover, NULL, growing_mutate, NULL);
+    CHECK(pipeline != NULL);
+    GenerationStats stats = {0};
+    Population generation = pipeline_generation(pipeline, &stats);
+    for (size_t i = pipeline->elite_size; i < pipeline->elite_size + pipeline->parents_size; i++)
+        CHECK(generation.individuals[i].size == 6 && strcmp(generation.individuals[i].genome, "xxxxxx") == 0);
+    free_pipeline(pipeline);
+    free_population(p);
+}
+
+int main(){
+    seed_random(42);
+    check_selection();
+    check_stop();
+    check_threads();
+    check_truncated();
+    CHECK_DONE("pipeline");
+}
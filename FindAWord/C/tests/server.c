@@ -0,0 +1,91 @@
+#include <check.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <server.h>
+
+// Address space of the server process, enough for small requests but not for a population of SERVER_MAX_POPULATION
+#define SERVER_TEST_ADDRESS_SPACE (256UL << 20)
+
+/**
+ * @brief Connects to the server, retrying while it starts.
+ * @param socket_path The path of the socket.
+ * @return The socket, or -1 if the server never listened.
+*/
+static int connect_server(const char *socket_path){
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, socket_path);
+    for (int attempt = 0; attempt < 200; attempt++){
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd >= 0 && connect(fd, (struct sockaddr *)&address, sizeof(address)) == 0)
+            return fd;
+        if (fd >= 0)
+            close(fd);
+        usleep(10000);
+    }
+    return -1;
+}
+
+/**
+ * @brief Sends a request line and reads its answer line.
+ * @param fd The socket.
+ * @param request The request, without its newline.
+ * @param answer The answer, without its newline.
+ * @param size The size of answer.
+*/
+static void ask(int fd, const char *request, char *answer, size_t size){
+    char line[SERVER_LINE_MAX];
+    int length = snprintf(line, sizeof(line), "%s\n", request);
+    CHECK(send(fd, line, length, MSG_NOSIGNAL) == length);
+    size_t used = 0;
+    while (used + 1 < size && recv(fd, answer + used, 1, 0) == 1 && answer[used] != '\n')
+        used++;
+    answer[used] = '\0';
+}
+
+/**
+ * @brief Checks the answers of a server to invalid operators, populations above SERVER_MAX_POPULATION,
+ * searches which can not be allocated, and a valid search.
+*/
+static void check_requests(){
+    char socket_path[64];
+    snprintf(socket_path, sizeof(socket_path), "/tmp/test_server_%d.sock", (int) getpid());
+    pid_t server = fork();
+    if (server == 0){
+        struct rlimit limit = {SERVER_TEST_ADDRESS_SPACE, SERVER_TEST_ADDRESS_SPACE};
+        setrlimit(RLIMIT_AS, &limit);
+        JobConfig config = default_job_config();
+        config.max_generations = 1000;
+        _exit(run_server(socket_path, 1, &config) == 0 ? 0 : 1);
+    }
+    int fd = connect_server(socket_path);
+    CHECK(fd >= 0);
+    if (fd >= 0){
+        char answer[SERVER_LINE_MAX];
+        ask(fd, "SOLVE\ta\tHello\tmutation=no_such_mutate", answer, sizeof(answer));
+        CHECK(strcmp(answer, "ERROR\ta\tinvalid parameter") == 0);
+        char request[128];
+        snprintf(request, sizeof(request), "SOLVE\tb\tHello\tpopulation=%d", SERVER_MAX_POPULATION + 1);
+        ask(fd, request, answer, sizeof(answer));
+        CHECK(strcmp(answer, "ERROR\tb\tpopulation too large") == 0);
+        snprintf(request, sizeof(request), "SOLVE\tb\tHello\tpopulation=%d", SERVER_MIN_POPULATION - 1);
+        ask(fd, request, answer, sizeof(answer));
+        CHECK(strcmp(answer, "ERROR\tb\tpopulation too small") == 0);
+        snprintf(request, sizeof(request), "SOLVE\tc\tHello\tpopulation=%d", SERVER_MAX_POPULATION);
+        ask(fd, request, answer, sizeof(answer));
+        CHECK(strcmp(answer, "ERROR\tc\tcould not run the search") == 0);
+        // The worker is still usable after a failed allocation
+        ask(fd, "SOLVE\td\tHello\tpopulation=256\tseed=3", answer, sizeof(answer));
+        CHECK(strncmp(answer, "RESULT\td\t1\t0\t", 13) == 0);
+        close(fd);
+    }
+    kill(server, SIGTERM);
+    int status;
+    CHECK(waitpid(server, &status, 0) == server && WIFEXITED(status) && WEXITSTATUS(status) == 0);
+}
+
+int main(){
+    check_requests();
+    CHECK_DONE("server");
+}
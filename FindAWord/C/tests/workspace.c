@@ -0,0 +1,54 @@
+#include <check.h>
+#include <workspace.h>
+
+/**
+ * @brief Frees blocks of a workspace while another workspace, or none, is the current one, and checks that
+ * they go back to their own workspace instead of free.
+*/
+static void check_owner(){
+    Workspace *first = create_workspace(64, 32);
+    Workspace *second = create_workspace(64, 32);
+    CHECK(first != NULL && second != NULL);
+
+    set_workspace(first);
+    void *block = scratch_alloc(100);
+    void *other = scratch_alloc(100);
+    CHECK(in_workspace(first, block) && in_workspace(first, other));
+    set_workspace(second);
+    scratch_free(block);
+    void *reused = scratch_alloc(100);
+    CHECK(in_workspace(second, reused));
+    set_workspace(NULL);
+    scratch_free(other);
+    scratch_free(reused);
+    // The blocks are on the free lists of their workspaces, and are allocated again from them
+    set_workspace(first);
+    void *again = scratch_alloc(100);
+    void *again_other = scratch_alloc(100);
+    CHECK((again == block && again_other == other) || (again == other && again_other == block));
+    scratch_free(again);
+    scratch_free(again_other);
+    set_workspace(second);
+    CHECK(scratch_alloc(100) == reused);
+    scratch_free(reused);
+
+    // A block of malloc is freed by free whatever the workspace of the thread
+    set_workspace(NULL);
+    void *heap = scratch_alloc(100);
+    CHECK(!in_workspace(first, heap) && !in_workspace(second, heap));
+    set_workspace(first);
+    scratch_free(heap);
+
+    set_workspace(NULL);
+    free_workspace(first);
+    void *after = scratch_alloc(100);
+    set_workspace(second);
+    scratch_free(after);
+    set_workspace(NULL);
+    free_workspace(second);
+}
+
+int main(){
+    check_owner();
+    CHECK_DONE("workspace");
+}
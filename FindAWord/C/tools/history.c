@@ -0,0 +1,128 @@
+#include <unistd.h>
+
+#include <history.h>
+
+// Most columns which can be printed
+#define MAX_COLUMNS HISTORY_COLUMN_COUNT
+
+/**
+ * @brief Parses a list of column names separated by commas.
+ * @param list The list.
+ * @param columns The columns, filled.
+ * @return The number of columns, or -1 if a name is not a column.
+*/
+static int parse_columns(const char *list, HistoryColumn columns[MAX_COLUMNS]){
+    int count = 0;
+    const char *name = list;
+    while (*name != '\0'){
+        size_t length = strcspn(name, ",");
+        int found = -1;
+        for (int c = 0; c < HISTORY_COLUMN_COUNT; c++)
+            if (strlen(history_columns[c].name) == length && strncmp(history_columns[c].name, name, length) == 0)
+                found = c;
+        if (found == -1 || count == MAX_COLUMNS)
+            return -1;
+        columns[count++] = found;
+        name += length;
+        if (*name == ',')
+            name++;
+    }
+    return count;
+}
+
+/**
+ * @brief Finds the last snapshot at or before a generation. The snapshots are in the order of their generations.
+ * @param reader The reader.
+ * @param generation The generation.
+ * @return The index of the snapshot, or -1 if there is none.
+*/
+static long find_snapshot(const HistoryReader *reader, int64_t generation){
+    size_t low = 0, high = reader->header->snapshot_count;
+    while (low < high){
+        size_t middle = low + (high - low) / 2;
+        if (reader->snapshots[middle].generation <= generation)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return (long) low - 1;
+}
+
+/**
+ * @brief Prints the records of a history file as tab separated values, or the genomes of one of its snapshots.
+*/
+int main(int argc, char **argv){
+    HistoryColumn columns[MAX_COLUMNS];
+    int column_count = HISTORY_COLUMN_COUNT;
+    for (int c = 0; c < HISTORY_COLUMN_COUNT; c++)
+        columns[c] = c;
+    size_t first = 0, count = SIZE_MAX;
+    int64_t snapshot_generation = -1;
+    int list_snapshots = 0, summary = 0;
+    int option;
+    while ((option = getopt(argc, argv, "c:f:n:g:li")) != -1){
+        int valid = 1;
+        switch (option){
+            case 'c': valid = (column_count = parse_columns(optarg, columns)) > 0; break;
+            case 'f': first = strtoull(optarg, NULL, 10); break;
+            case 'n': count = strtoull(optarg, NULL, 10); break;
+            case 'g': valid = (snapshot_generation = strtoll(optarg, NULL, 10)) >= 0; break;
+            case 'l': list_snapshots = 1; break;
+            case 'i': summary = 1; break;
+            default: valid = 0;
+        }
+        if (!valid){
+            fprintf(stderr, "Usage: %s [-c columns] [-f first record] [-n records] [-g snapshot generation] [-l] [-i] history\n", argv[0]);
+            return 1;
+        }
+    }
+    if (optind != argc - 1){
+        fprintf(stderr, "Usage: %s [-c columns] [-f first record] [-n records] [-g snapshot generation] [-l] [-i] history\n", argv[0]);
+        return 1;
+    }
+    HistoryReader *reader = open_history(argv[optind]);
+    if (reader == NULL){
+        fprintf(stderr, "%s: not a complete history file\n", argv[optind]);
+        return 1;
+    }
+    const HistoryHeader *header = reader->header;
+
+    if (summary){
+        printf("word\t%s\nrecords\t%llu\nsnapshots\t%llu\ndropped records\t%llu\ndropped snapshots\t%llu\n", header->word,\
+               (unsigned long long) header->record_count, (unsigned long long) header->snapshot_count,\
+               (unsigned long long) header->dropped_records, (unsigned long long) header->dropped_snapshots);
+    }
+    else if (list_snapshots){
+        printf("generation\tindividuals\tgenome_bytes\tstored_bytes\tcoding\n");
+        for (size_t s = 0; s < header->snapshot_count; s++)
+            printf("%lld\t%llu\t%llu\t%llu\t%s\n", (long long) reader->snapshots[s].generation,\
+                   (unsigned long long) reader->snapshots[s].size, (unsigned long long) reader->snapshots[s].genomes_size,\
+                   (unsigned long long) reader->snapshots[s].coded_size, reader->snapshots[s].delta_coded ? "delta" : "raw");
+    }
+    else if (snapshot_generation >= 0){
+        long s = find_snapshot(reader, snapshot_generation);
+        Gene *genomes = s >= 0 ? read_history_snapshot(reader, s) : NULL;
+        if (genomes == NULL){
+            fprintf(stderr, "%s: no snapshot at or before generation %lld\n", argv[optind], (long long) snapshot_generation);
+            close_history(reader);
+            return 1;
+        }
+        const Gene *genome = genomes;
+        for (uint64_t i = 0; i < reader->snapshots[s].size; i++){
+            puts(genome);
+            genome += strlen(genome) + 1;
+        }
+        free(genomes);
+    }
+    else {
+        for (int c = 0; c < column_count; c++)
+            printf("%s%c", history_columns[columns[c]].name, c + 1 < column_count ? '\t' : '\n');
+        size_t available = first < header->record_count ? header->record_count - first : 0;
+        size_t last = first + (count < available ? count : available);
+        for (size_t r = first; r < last; r++)
+            for (int c = 0; c < column_count; c++)
+                printf("%.9g%c", history_value(reader, columns[c], r), c + 1 < column_count ? '\t' : '\n');
+    }
+    close_history(reader);
+    return 0;
+}